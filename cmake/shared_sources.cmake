@@ -23,6 +23,7 @@ set(COMMON_SOURCES
     ${SOURCE_DIR}/qcommon/files.cpp
     ${SOURCE_DIR}/qcommon/ioapi.c
     ${SOURCE_DIR}/qcommon/huffman.cpp
+    ${SOURCE_DIR}/qcommon/jobs.cpp
     ${SOURCE_DIR}/qcommon/md4.c
     ${SOURCE_DIR}/qcommon/md5.c
     ${SOURCE_DIR}/qcommon/memory.c
@@ -51,6 +52,7 @@ set(SYSTEM_SOURCES
 
 set(SERVER_SOURCES
     ${SOURCE_DIR}/server/sv_client.c
+    ${SOURCE_DIR}/server/sv_clusterents.c
     ${SOURCE_DIR}/server/sv_ccmds.c
     ${SOURCE_DIR}/server/sv_game.c
     ${SOURCE_DIR}/server/sv_init.c
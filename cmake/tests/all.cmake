@@ -1,3 +1,7 @@
 enable_testing()
 
 include(tests/lz77)
+include(tests/entitygrid)
+include(tests/pathnodeheap)
+include(tests/clusterents)
+include(tests/msg)
@@ -0,0 +1,14 @@
+#
+# Unit tests
+#
+
+add_executable(test_clusterents
+    ${SOURCE_DIR}/server/tests/test_clusterents.cpp
+    ${SOURCE_DIR}/server/sv_clusterents.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_clusterents INTERFACE testing)
+add_test(NAME test_clusterents COMMAND test_clusterents)
+set_tests_properties(test_clusterents PROPERTIES TIMEOUT 15)
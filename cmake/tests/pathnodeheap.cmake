@@ -0,0 +1,11 @@
+#
+# Unit tests
+#
+
+add_executable(test_pathnodeheap
+    ${SOURCE_DIR}/fgame/tests/test_pathnodeheap.cpp
+)
+
+target_link_libraries(test_pathnodeheap INTERFACE testing)
+add_test(NAME test_pathnodeheap COMMAND test_pathnodeheap)
+set_tests_properties(test_pathnodeheap PROPERTIES TIMEOUT 15)
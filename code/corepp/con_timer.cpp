@@ -4,20 +4,243 @@
 #    include "../fgame/archive.h"
 #endif
 
+template<>
+int HashCode<Class *>(Class *const& key)
+{
+    return (int)((size_t)key >> 4);
+}
+
 con_timer::con_timer(void)
 {
-    m_inttime = 0;
-    m_bDirty  = false;
+    m_inttime  = 0;
+    m_order    = 0;
+    m_bDirty   = false;
+    m_bRebuild = false;
+}
+
+int con_timer::CompareOrder(const void *elem1, const void *elem2)
+{
+    const Element *e1 = *(const Element **)elem1;
+    const Element *e2 = *(const Element **)elem2;
+
+    if (e1->order < e2->order) {
+        return -1;
+    } else if (e1->order > e2->order) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+====================
+GetSortedElements
+
+Return the elements in insertion order
+====================
+*/
+void con_timer::GetSortedElements(Container<Element *>& elements)
+{
+    int i;
+
+    elements.Resize(m_Elements.NumObjects());
+    for (i = 1; i <= m_Elements.NumObjects(); i++) {
+        elements.AddObject(m_Elements.AddressOfObjectAt(i));
+    }
+
+    elements.Sort(con_timer::CompareOrder);
+}
+
+/*
+====================
+RenumberElements
+
+Compact the insertion order before it overflows
+====================
+*/
+void con_timer::RenumberElements(void)
+{
+    Container<Element *> elements;
+    int                  i;
+
+    GetSortedElements(elements);
+
+    for (i = 1; i <= elements.NumObjects(); i++) {
+        elements.ObjectAt(i)->order = i;
+    }
+
+    m_order = elements.NumObjects();
+}
+
+void con_timer::SetElementAt(int index, const Element& element)
+{
+    m_Elements.SetObjectAt(index, element);
+    m_Indices[element.obj] = index;
+}
+
+void con_timer::SiftUp(int index)
+{
+    Element element = m_Elements.ObjectAt(index);
+
+    while (index > 1) {
+        const Element& parent = m_Elements.ObjectAt(index / 2);
+
+        if (!IsBefore(element, parent)) {
+            break;
+        }
+
+        SetElementAt(index, parent);
+        index /= 2;
+    }
+
+    SetElementAt(index, element);
+}
+
+void con_timer::SiftDown(int index)
+{
+    Element element = m_Elements.ObjectAt(index);
+    int     num     = m_Elements.NumObjects();
+
+    for (;;) {
+        int child = index * 2;
+
+        if (child > num) {
+            break;
+        }
+
+        if (child < num && IsBefore(m_Elements.ObjectAt(child + 1), m_Elements.ObjectAt(child))) {
+            child++;
+        }
+
+        if (!IsBefore(m_Elements.ObjectAt(child), element)) {
+            break;
+        }
+
+        SetElementAt(index, m_Elements.ObjectAt(child));
+        index = child;
+    }
+
+    SetElementAt(index, element);
+}
+
+void con_timer::RemoveElementAt(int index)
+{
+    int num = m_Elements.NumObjects();
+
+    m_Indices.remove(m_Elements.ObjectAt(index).obj);
+
+    if (index != num) {
+        Element last = m_Elements.ObjectAt(num);
+
+        m_Elements.RemoveObjectAt(num);
+        SetElementAt(index, last);
+
+        if (index > 1 && IsBefore(last, m_Elements.ObjectAt(index / 2))) {
+            SiftUp(index);
+        } else {
+            SiftDown(index);
+        }
+    } else {
+        m_Elements.RemoveObjectAt(num);
+    }
+
+    if (!m_Elements.NumObjects()) {
+        // restart the insertion order
+        m_order = 0;
+    }
+}
+
+/*
+====================
+Rebuild
+
+Heapify the elements that were loaded in insertion order.
+This can only be done once the archived object pointers are resolved
+====================
+*/
+void con_timer::Rebuild(void)
+{
+    int i;
+    int num = m_Elements.NumObjects();
+
+    m_bRebuild = false;
+    m_Indices.clear();
+
+    for (i = 1; i <= num; i++) {
+        m_Elements.ObjectAt(i).order = i;
+        m_Indices[m_Elements.ObjectAt(i).obj] = i;
+    }
+    m_order = num;
+
+    for (i = num / 2; i > 0; i--) {
+        SiftDown(i);
+    }
+}
+
+/*
+====================
+ResolveElements
+
+Rebuild the heap if the loaded object pointers have been fixed up.
+Until then the elements must stay in place
+====================
+*/
+bool con_timer::ResolveElements(void)
+{
+    int i;
+
+    if (!m_bRebuild) {
+        return true;
+    }
+
+    for (i = 1; i <= m_Elements.NumObjects(); i++) {
+        if (!m_Elements.ObjectAt(i).obj) {
+            return false;
+        }
+    }
+
+    Rebuild();
+    return true;
 }
 
+/*
+====================
+AddElement
+
+An object is only queued once. Adding an object that is already queued
+moves it to the new time, after the elements added before.
+The original list kept a duplicate instead, but RemoveElement only ever
+removed one of them, leaving the other pointing to the deleted object.
+Script threads are the only user. They always leave the list before
+being queued again (ScriptThread::StartTiming) or are new threads
+(ScriptThread::DelayExecute), so none of them relied on duplicates
+====================
+*/
 void con_timer::AddElement(Class *e, int inttime)
 {
     Element element;
+    int    *index;
 
     element.obj     = e;
     element.inttime = inttime;
+    element.order   = 0;
 
-    m_Elements.AddObject(element);
+    if (!ResolveElements()) {
+        m_Elements.AddObject(element);
+    } else {
+        index = m_Indices.find(e);
+        if (index) {
+            // already queued, it's moved at the end of the list
+            RemoveElementAt(*index);
+        }
+
+        if (m_order == INT_MAX) {
+            RenumberElements();
+        }
+
+        element.order = ++m_order;
+        SiftUp(m_Elements.AddObject(element));
+    }
 
     if (inttime <= m_inttime) {
         SetDirty();
@@ -26,37 +249,37 @@ void con_timer::AddElement(Class *e, int inttime)
 
 void con_timer::RemoveElement(Class *e)
 {
-    for (int i = m_Elements.NumObjects(); i > 0; i--) {
-        Element *index = &m_Elements.ObjectAt(i);
+    int *index;
+    int  i;
 
-        if (index->obj == e) {
-            m_Elements.RemoveObjectAt(i);
-            return;
+    if (!ResolveElements()) {
+        for (i = m_Elements.NumObjects(); i > 0; i--) {
+            if (m_Elements.ObjectAt(i).obj == e) {
+                m_Elements.RemoveObjectAt(i);
+                return;
+            }
         }
+        return;
+    }
+
+    index = m_Indices.find(e);
+    if (index) {
+        RemoveElementAt(*index);
     }
 }
 
 Class *con_timer::GetNextElement(int& foundtime)
 {
-    int    best_inttime;
-    int    i;
-    int    foundIndex;
     Class *result;
 
-    foundIndex   = 0;
-    best_inttime = m_inttime;
-
-    for (i = m_Elements.NumObjects(); i > 0; i--) {
-        if (m_Elements.ObjectAt(i).inttime <= best_inttime) {
-            best_inttime = m_Elements.ObjectAt(i).inttime;
-            foundIndex   = i;
-        }
+    if (m_bRebuild) {
+        Rebuild();
     }
 
-    if (foundIndex) {
-        result = m_Elements.ObjectAt(foundIndex).obj;
-        m_Elements.RemoveObjectAt(foundIndex);
-        foundtime = best_inttime;
+    if (m_Elements.NumObjects() && m_Elements.ObjectAt(1).inttime <= m_inttime) {
+        result    = m_Elements.ObjectAt(1).obj;
+        foundtime = m_Elements.ObjectAt(1).inttime;
+        RemoveElementAt(1);
     } else {
         result   = NULL;
         m_bDirty = false;
@@ -78,6 +301,27 @@ void con_timer::Archive(Archiver& arc)
     arc.ArchiveBool(&m_bDirty);
     arc.ArchiveInteger(&m_inttime);
 
-    m_Elements.Archive(arc, con_timer::ArchiveElement);
+    if (arc.Loading()) {
+        m_Indices.clear();
+        m_Elements.Archive(arc, con_timer::ArchiveElement);
+        m_bRebuild = true;
+    } else {
+        Container<Element *> elements;
+        int                  i, num;
+
+        if (!ResolveElements()) {
+            m_Elements.Archive(arc, con_timer::ArchiveElement);
+            return;
+        }
+
+        // the elements are saved in insertion order
+        GetSortedElements(elements);
+
+        num = elements.NumObjects();
+        arc.ArchiveInteger(&num);
+        for (i = 1; i <= num; i++) {
+            ArchiveElement(arc, elements.ObjectAt(i));
+        }
+    }
 }
 #endif
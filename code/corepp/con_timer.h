@@ -1,5 +1,9 @@
 #include "../corepp/class.h"
 
+//
+// Min-heap of timed objects, ordered by time then by insertion order.
+// Each object can only be added once.
+//
 class con_timer : public Class
 {
 public:
@@ -8,16 +12,34 @@ public:
     public:
         Class *obj;
         int    inttime;
+        int    order;
     };
 
 private:
     Container<con_timer::Element> m_Elements;
+    con_map<Class *, int>         m_Indices;
     bool                          m_bDirty;
+    bool                          m_bRebuild;
     int                           m_inttime;
+    int                           m_order;
+
+private:
+    static bool IsBefore(const Element& e1, const Element& e2);
+    static int  CompareOrder(const void *elem1, const void *elem2);
+
+    void GetSortedElements(Container<Element *>& elements);
+    void RenumberElements(void);
+    void SetElementAt(int index, const Element& element);
+    void SiftUp(int index);
+    void SiftDown(int index);
+    void RemoveElementAt(int index);
+    void Rebuild(void);
+    bool ResolveElements(void);
 
 public:
     con_timer();
 
+    // Adds or moves the object, it's never queued twice
     void AddElement(Class *e, int inttime);
     void RemoveElement(Class *e);
 
@@ -48,3 +70,12 @@ inline void con_timer::SetTime(int inttime)
     m_inttime = inttime;
     m_bDirty  = true;
 }
+
+inline bool con_timer::IsBefore(const Element& e1, const Element& e2)
+{
+    if (e1.inttime != e2.inttime) {
+        return e1.inttime < e2.inttime;
+    }
+
+    return e1.order < e2.order;
+}
@@ -24,7 +24,6 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "../script/scriptvariable.h"
 #include "../script/scriptexception.h"
-#include "Linklist.h"
 
 #ifdef WITH_SCRIPT_ENGINE
 #    include "../fgame/archive.h"
@@ -70,7 +69,7 @@ con_map<const_str, unsigned int> Event::setterCommandList;
 
 #endif
 
-EventQueueNode Event::EventQueue;
+EventQueueHeap Event::EventQueue;
 
 int DisableListenerNotify = 0;
 
@@ -412,8 +411,210 @@ int HashCode<command_t>(const command_t& key)
     return hash;
 }
 
+/*
+=======================
+EventQueueHeap
+=======================
+*/
+EventQueueHeap::EventQueueHeap()
+{
+    m_highOrder = 0;
+    m_lowOrder  = 0;
+}
+
+void EventQueueHeap::SetNodeAt(int index, EventQueueNode *node)
+{
+    m_Nodes.SetObjectAt(index, node);
+    node->heapIndex = index;
+}
+
+void EventQueueHeap::SiftUp(int index)
+{
+    EventQueueNode *node = m_Nodes.ObjectAt(index);
+
+    while (index > 1) {
+        EventQueueNode *parent = m_Nodes.ObjectAt(index / 2);
+
+        if (!node->IsBefore(parent)) {
+            break;
+        }
+
+        SetNodeAt(index, parent);
+        index /= 2;
+    }
+
+    SetNodeAt(index, node);
+}
+
+void EventQueueHeap::SiftDown(int index)
+{
+    EventQueueNode *node = m_Nodes.ObjectAt(index);
+    int             num  = m_Nodes.NumObjects();
+
+    for (;;) {
+        EventQueueNode *child;
+        int             childIndex = index * 2;
+
+        if (childIndex > num) {
+            break;
+        }
+
+        child = m_Nodes.ObjectAt(childIndex);
+        if (childIndex < num && m_Nodes.ObjectAt(childIndex + 1)->IsBefore(child)) {
+            childIndex++;
+            child = m_Nodes.ObjectAt(childIndex);
+        }
+
+        if (!child->IsBefore(node)) {
+            break;
+        }
+
+        SetNodeAt(index, child);
+        index = childIndex;
+    }
+
+    SetNodeAt(index, node);
+}
+
+void EventQueueHeap::Update(EventQueueNode *node)
+{
+    int index = node->heapIndex;
+
+    if (index > 1 && node->IsBefore(m_Nodes.ObjectAt(index / 2))) {
+        SiftUp(index);
+    } else {
+        SiftDown(index);
+    }
+}
+
+/*
+=======================
+Insert
+
+Queue the node before the events pending at the same time
+=======================
+*/
+void EventQueueHeap::Insert(EventQueueNode *node)
+{
+    assert(!node->heapIndex);
+
+    node->order = ++m_highOrder;
+    node->heapIndex = m_Nodes.AddObject(node);
+    SiftUp(node->heapIndex);
+}
+
+/*
+=======================
+Append
+
+Queue the node after the events pending at the same time
+=======================
+*/
+void EventQueueHeap::Append(EventQueueNode *node)
+{
+    assert(!node->heapIndex);
+
+    node->order = --m_lowOrder;
+    node->heapIndex = m_Nodes.AddObject(node);
+    SiftUp(node->heapIndex);
+}
+
+void EventQueueHeap::Remove(EventQueueNode *node)
+{
+    EventQueueNode *last;
+    int             index = node->heapIndex;
+    int             num   = m_Nodes.NumObjects();
+
+    assert(index > 0 && index <= num && m_Nodes.ObjectAt(index) == node);
+
+    last = m_Nodes.ObjectAt(num);
+    m_Nodes.RemoveObjectAt(num);
+    node->heapIndex = 0;
+
+    if (last != node) {
+        SetNodeAt(index, last);
+        Update(last);
+    }
+}
+
+/*
+=======================
+Reschedule
+
+Move the node to a new time, after the events pending at that time
+=======================
+*/
+void EventQueueHeap::Reschedule(EventQueueNode *node, int inttime)
+{
+    assert(node->heapIndex);
+
+    node->inttime = inttime;
+    node->order   = --m_lowOrder;
+    Update(node);
+}
+
+void EventQueueHeap::Reset(void)
+{
+    m_Nodes.ClearObjectList();
+    m_highOrder = 0;
+    m_lowOrder  = 0;
+}
+
+static void L_LinkEventNode(Listener *listener, EventQueueNode *node)
+{
+    node->listenerPrev = NULL;
+    node->listenerNext = listener->m_EventQueueList;
+    if (listener->m_EventQueueList) {
+        listener->m_EventQueueList->listenerPrev = node;
+    }
+    listener->m_EventQueueList = node;
+}
+
+static void L_UnlinkEventNode(Listener *listener, EventQueueNode *node)
+{
+    if (node->listenerPrev) {
+        node->listenerPrev->listenerNext = node->listenerNext;
+    } else if (listener && listener->m_EventQueueList == node) {
+        listener->m_EventQueueList = node->listenerNext;
+    }
+
+    if (node->listenerNext) {
+        node->listenerNext->listenerPrev = node->listenerPrev;
+    }
+
+    node->listenerPrev = NULL;
+    node->listenerNext = NULL;
+}
+
+/*
+=======================
+L_RemoveEventNode
+
+Remove the node from the pending queue and from its listener
+=======================
+*/
+static void L_RemoveEventNode(Listener *listener, EventQueueNode *node)
+{
+    Event::EventQueue.Remove(node);
+    L_UnlinkEventNode(listener, node);
+}
+
 #if defined(ARCHIVE_SUPPORTED)
 
+static int L_CompareEventNodes(const void *elem1, const void *elem2)
+{
+    const EventQueueNode *node1 = *(EventQueueNode **)elem1;
+    const EventQueueNode *node2 = *(EventQueueNode **)elem2;
+
+    if (node1->IsBefore(node2)) {
+        return -1;
+    } else if (node2->IsBefore(node1)) {
+        return 1;
+    }
+
+    return 0;
+}
+
 void ArchiveListenerPtr(Archiver& arc, SafePtr<Listener> *obj)
 {
     arc.ArchiveSafePointer(obj);
@@ -449,7 +650,8 @@ void Event::Archive(Archiver& arc)
     arc.ArchiveUnsignedShort(&dataSize);
 
     if (arc.Loading()) {
-        data = new ScriptVariable[dataSize + 1];
+        maxDataSize = dataSize + 1;
+        data        = AllocData(maxDataSize);
     }
 
     for (int i = dataSize; i > 0; i--) {
@@ -459,13 +661,26 @@ void Event::Archive(Archiver& arc)
 
 void L_ArchiveEvents(Archiver& arc)
 {
-    EventQueueNode *event;
-    int             num;
+    Container<EventQueueNode *> sorted;
+    EventQueueNode             *event;
+    int                         num;
+    int                         i;
+
+    //
+    // The events are written in the order they will be processed
+    //
+    sorted.Resize(Event::EventQueue.NumNodes());
+    for (i = 1; i <= Event::EventQueue.NumNodes(); i++) {
+        sorted.AddObject(Event::EventQueue.NodeAt(i));
+    }
+    sorted.Sort(L_CompareEventNodes);
 
     num = 0;
-    for (event = Event::EventQueue.next; event != &Event::EventQueue; event = event->next) {
+    for (i = 1; i <= sorted.NumObjects(); i++) {
         Listener *obj;
 
+        event = sorted.ObjectAt(i);
+
         assert(event);
 
         obj = event->GetSourceObject();
@@ -482,9 +697,11 @@ void L_ArchiveEvents(Archiver& arc)
     }
 
     arc.ArchiveInteger(&num);
-    for (event = Event::EventQueue.next; event != &Event::EventQueue; event = event->next) {
+    for (i = 1; i <= sorted.NumObjects(); i++) {
         Listener *obj;
 
+        event = sorted.ObjectAt(i);
+
         assert(event);
 
         obj = event->GetSourceObject();
@@ -523,25 +740,54 @@ void L_UnarchiveEvents(Archiver& arc)
         arc.ArchiveInteger(&node->flags);
         arc.ArchiveSafePointer(&node->m_sourceobject);
 
-        LL_Add(&Event::EventQueue, node, next, prev);
+        Event::EventQueue.Append(node);
+    }
+}
+
+/*
+=======================
+L_LinkUnarchivedEvents
+
+The source objects of the unarchived events are only known
+once the archive pointers have been fixed up
+=======================
+*/
+void L_LinkUnarchivedEvents(void)
+{
+    EventQueueNode *node;
+    Listener       *obj;
+    int             i;
+
+    for (i = 1; i <= Event::EventQueue.NumNodes(); i++) {
+        node = Event::EventQueue.NodeAt(i);
+        obj  = node->GetSourceObject();
+
+        if (obj && !node->listenerPrev && obj->m_EventQueueList != node) {
+            L_LinkEventNode(obj, node);
+        }
     }
 }
 #endif
 
 void L_ClearEventList()
 {
-    EventQueueNode *node = Event::EventQueue.next, *tmp;
+    EventQueueNode *node;
+    Listener       *obj;
+    int             i;
 
-    while (node != &Event::EventQueue) {
-        tmp = node->next;
+    for (i = 1; i <= Event::EventQueue.NumNodes(); i++) {
+        node = Event::EventQueue.NodeAt(i);
+        obj  = node->GetSourceObject();
+
+        if (obj) {
+            obj->m_EventQueueList = NULL;
+        }
 
         delete node->event;
         delete node;
-
-        node = tmp;
     }
 
-    LL_Reset(&Event::EventQueue, next, prev);
+    Event::EventQueue.Reset();
 
     Event_allocator.FreeAll();
 
@@ -567,8 +813,6 @@ void L_InitEvents(void)
     Event::LoadEvents();
     ClassDef::BuildEventResponses();
 
-    LL_Reset(&Event::EventQueue, next, prev);
-
     L_ClearEventList();
     Listener::EventSystemStarted = true;
 }
@@ -580,10 +824,10 @@ void L_ProcessPendingEvents()
     Listener::ProcessingEvents = true;
 
     int t = EVENT_msec;
-    while (!LL_Empty(&Event::EventQueue, next, prev)) {
+    while (!Event::EventQueue.IsEmpty()) {
         Listener *obj;
 
-        node = Event::EventQueue.next;
+        node = Event::EventQueue.Peek();
 
         assert(node);
 
@@ -596,7 +840,7 @@ void L_ProcessPendingEvents()
         }
 
         // the event is removed from its list
-        LL_Remove(node, next, prev);
+        L_RemoveEventNode(obj, node);
         //gi.DPrintf2("Event: %s\n", node->event->getName().c_str());
 
         // ProcessEvent will dispose of this event when it is done
@@ -1607,6 +1851,149 @@ CLASS_DECLARATION(Class, Event, NULL) {
     {NULL, NULL}
 };
 
+eventAllocStats_t Event::allocStats;
+
+/**
+ * Free lists of the argument arrays, by number of values.
+ * Script commands and posted events reuse them instead of allocating every time.
+ */
+class EventDataPool
+{
+public:
+    EventDataPool();
+    ~EventDataPool();
+
+    void *Pop(int count);
+    void  Push(void *data, int count);
+
+private:
+    struct freeData_t {
+        freeData_t *next;
+    };
+
+    freeData_t *freeList[EVENT_POOLED_ARGS];
+};
+
+EventDataPool::EventDataPool()
+{
+    memset(freeList, 0, sizeof(freeList));
+}
+
+EventDataPool::~EventDataPool()
+{
+    freeData_t *entry;
+    int         i;
+
+    for (i = 0; i < EVENT_POOLED_ARGS; i++) {
+        while (freeList[i]) {
+            entry       = freeList[i];
+            freeList[i] = entry->next;
+
+            ::operator delete(entry);
+        }
+    }
+}
+
+void *EventDataPool::Pop(int count)
+{
+    freeData_t *entry = freeList[count - 1];
+
+    if (entry) {
+        freeList[count - 1] = entry->next;
+    }
+
+    return entry;
+}
+
+void EventDataPool::Push(void *data, int count)
+{
+    freeData_t *entry = (freeData_t *)data;
+
+    entry->next         = freeList[count - 1];
+    freeList[count - 1] = entry;
+}
+
+// One pool per thread, so it doesn't need to be locked
+static thread_local EventDataPool eventDataPool;
+
+/*
+=======================
+AllocData
+
+Returns an array of count values, from the pool if possible
+=======================
+*/
+ScriptVariable *Event::AllocData(int count)
+{
+    ScriptVariable *data;
+    void           *memory;
+    int             i;
+
+    if (count > EVENT_POOLED_ARGS) {
+        allocStats.large++;
+        return new ScriptVariable[count];
+    }
+
+    memory = eventDataPool.Pop(count);
+    if (memory) {
+        allocStats.pooled++;
+    } else {
+        allocStats.allocated++;
+        memory = ::operator new(sizeof(ScriptVariable) * count);
+    }
+
+    data = (ScriptVariable *)memory;
+    for (i = 0; i < count; i++) {
+        new (&data[i]) ScriptVariable();
+    }
+
+    return data;
+}
+
+/*
+=======================
+FreeData
+
+Frees an array from AllocData, count must be the same
+=======================
+*/
+void Event::FreeData(ScriptVariable *data, int count)
+{
+    int i;
+
+    if (count > EVENT_POOLED_ARGS) {
+        delete[] data;
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+        data[i].~ScriptVariable();
+    }
+
+    eventDataPool.Push(data, count);
+}
+
+/*
+=======================
+PrintAllocStats
+=======================
+*/
+void Event::PrintAllocStats(void)
+{
+    EVENT_Printf(
+        "%zu events allocated in %zu blocks (%zu bytes)\n",
+        Event_allocator.Count(),
+        Event_allocator.BlockCount(),
+        Event_allocator.BlockMemory()
+    );
+    EVENT_Printf(
+        "argument arrays: %u from the pool, %u allocated, %u too large for the pool\n",
+        allocStats.pooled,
+        allocStats.allocated,
+        allocStats.large
+    );
+}
+
 #ifndef _DEBUG_MEM
 
 /*
@@ -1848,9 +2235,10 @@ void Event::PendingEvents(const char *mask)
         l = strlen(mask);
     }
 
-    num   = 0;
-    event = EventQueue.next;
-    while (event != &EventQueue) {
+    num = 0;
+    for (int i = 1; i <= EventQueue.NumNodes(); i++) {
+        event = EventQueue.NodeAt(i);
+
         assert(event);
         assert(event->m_sourceobject);
 
@@ -1858,8 +2246,6 @@ void Event::PendingEvents(const char *mask)
             num++;
             //Event::PrintEvent( event );
         }
-
-        event = event->next;
     }
     EVENT_Printf("%d pending events as of %.2f\n", num, EVENT_time);
 }
@@ -2238,13 +2624,14 @@ Event::Event(const Event& ev)
     maxDataSize = ev.maxDataSize;
 
     if (dataSize) {
-        data = new ScriptVariable[maxDataSize];
+        data = AllocData(maxDataSize);
 
         for (int i = 0; i < dataSize; i++) {
             data[i] = ev.data[i];
         }
     } else {
-        data = NULL;
+        data        = NULL;
+        maxDataSize = 0;
     }
 
 #ifdef _DEBUG
@@ -2260,13 +2647,13 @@ Event::Event(const Event& ev, int numArgs)
     maxDataSize = ev.maxDataSize;
 
     if (dataSize) {
-        data = new ScriptVariable[maxDataSize];
+        data = AllocData(maxDataSize);
 
         for (int i = 0; i < dataSize; i++) {
             data[i] = ev.data[i];
         }
     } else {
-        data        = new ScriptVariable[numArgs];
+        data        = numArgs ? AllocData(numArgs) : NULL;
         dataSize    = 0;
         maxDataSize = numArgs;
     }
@@ -2329,7 +2716,7 @@ Event::Event(int index, int numArgs)
 {
     fromScript  = false;
     eventnum    = index;
-    data        = new ScriptVariable[numArgs];
+    data        = numArgs ? AllocData(numArgs) : NULL;
     dataSize    = 0;
     maxDataSize = numArgs;
 
@@ -2380,7 +2767,7 @@ Event::Event(const char *command, int numArgs)
     maxDataSize = numArgs;
 
     if (numArgs) {
-        data     = new ScriptVariable[numArgs];
+        data     = AllocData(numArgs);
         dataSize = 0;
     } else {
         dataSize = 0;
@@ -2411,13 +2798,15 @@ Event& Event::operator=(const Event& ev)
     maxDataSize = ev.maxDataSize;
 
     if (dataSize) {
-        data = new ScriptVariable[dataSize];
+        // allocate the whole capacity, values may be added after the copy
+        data = AllocData(maxDataSize);
 
         for (int i = 0; i < dataSize; i++) {
             data[i] = ev.data[i];
         }
     } else {
-        data = NULL;
+        data        = NULL;
+        maxDataSize = 0;
     }
 
 #ifdef _DEBUG
@@ -2631,7 +3020,7 @@ Clear
 void Event::Clear(void)
 {
     if (data) {
-        delete[] data;
+        FreeData(data, maxDataSize);
 
         data        = NULL;
         dataSize    = 0;
@@ -2798,7 +3187,7 @@ ScriptVariable& Event::GetValue(void)
         // to the first index of the array
         // so there is no reallocation
         if (!data) {
-            data        = new ScriptVariable[1];
+            data        = AllocData(1);
             dataSize    = 1;
             maxDataSize = 1;
         }
@@ -2808,16 +3197,17 @@ ScriptVariable& Event::GetValue(void)
     if (dataSize == maxDataSize) {
         tmp = data;
 
-        maxDataSize += 3;
-        data = new ScriptVariable[maxDataSize];
+        data = AllocData(maxDataSize + 3);
 
         if (tmp != NULL) {
             for (i = 0; i < dataSize; i++) {
                 data[i] = std::move(tmp[i]);
             }
 
-            delete[] tmp;
+            FreeData(tmp, maxDataSize);
         }
+
+        maxDataSize += 3;
     }
 
     dataSize++;
@@ -3016,6 +3406,8 @@ Listener::Listener()
     vars = NULL;
 
 #endif
+
+    m_EventQueueList = NULL;
 }
 
 /*
@@ -3126,13 +3518,13 @@ void Listener::CancelEventsOfType(Event *ev)
     EventQueueNode *next;
     int             eventnum;
 
-    node = Event::EventQueue.next;
+    node = m_EventQueueList;
 
     eventnum = ev->eventnum;
-    while (node != &Event::EventQueue) {
-        next = node->next;
-        if ((node->GetSourceObject() == this) && (node->event->eventnum == eventnum)) {
-            LL_Remove(node, next, prev);
+    while (node) {
+        next = node->listenerNext;
+        if (node->event->eventnum == eventnum) {
+            L_RemoveEventNode(this, node);
             delete node->event;
             delete node;
         }
@@ -3160,12 +3552,12 @@ void Listener::CancelFlaggedEvents(int flags)
     EventQueueNode *node;
     EventQueueNode *next;
 
-    node = Event::EventQueue.next;
+    node = m_EventQueueList;
 
-    while (node != &Event::EventQueue) {
-        next = node->next;
-        if ((node->GetSourceObject() == this) && (node->flags & flags)) {
-            LL_Remove(node, next, prev);
+    while (node) {
+        next = node->listenerNext;
+        if (node->flags & flags) {
+            L_RemoveEventNode(this, node);
             // Added in OPM
             //  Original doesn't delete the posted Event
             //  which would cause a memory leak
@@ -3187,15 +3579,13 @@ void Listener::CancelPendingEvents(void)
     EventQueueNode *node;
     EventQueueNode *next;
 
-    node = Event::EventQueue.next;
+    node = m_EventQueueList;
 
-    while (node != &Event::EventQueue) {
-        next = node->next;
-        if (node->GetSourceObject() == this) {
-            LL_Remove(node, next, prev);
-            delete node->event;
-            delete node;
-        }
+    while (node) {
+        next = node->listenerNext;
+        L_RemoveEventNode(this, node);
+        delete node->event;
+        delete node;
         node = next;
     }
 }
@@ -3210,16 +3600,12 @@ qboolean Listener::EventPending(Event& ev)
     EventQueueNode *event;
     int             eventnum;
 
-    event = Event::EventQueue.next;
-
     eventnum = ev.eventnum;
 
-    while (event != &Event::EventQueue) {
-        if ((event->GetSourceObject() == this) && (event->event->eventnum == ev.eventnum)) {
+    for (event = m_EventQueueList; event; event = event->listenerNext) {
+        if (event->event->eventnum == eventnum) {
             return true;
         }
-
-        event = event->next;
     }
 
     return false;
@@ -3233,7 +3619,6 @@ PostEventInternal
 EventQueueNode *Listener::PostEventInternal(Event *ev, float delay, int flags)
 {
     EventQueueNode *node;
-    EventQueueNode *i;
     int             inttime;
 
 #if defined(GAME_DLL)
@@ -3257,13 +3642,8 @@ EventQueueNode *Listener::PostEventInternal(Event *ev, float delay, int flags)
 
     node = new EventQueueNode;
 
-    i       = Event::EventQueue.next;
     inttime = EVENT_msec + (delay * 1000.0f + 0.5f);
 
-    while (i != &Event::EventQueue && inttime > i->inttime) {
-        i = i->next;
-    }
-
     node->inttime = inttime;
     node->event   = ev;
     node->flags   = flags;
@@ -3273,7 +3653,8 @@ EventQueueNode *Listener::PostEventInternal(Event *ev, float delay, int flags)
     node->name = ev->name;
 #endif
 
-    LL_Add(i, node, next, prev);
+    Event::EventQueue.Insert(node);
+    L_LinkEventNode(this, node);
 
     return node;
 }
@@ -3308,27 +3689,23 @@ PostponeAllEvents
 qboolean Listener::PostponeAllEvents(float time)
 {
     EventQueueNode *event;
-    EventQueueNode *node;
-
-    event = Event::EventQueue.next;
-    while (event != &Event::EventQueue) {
-        if (event->GetSourceObject() == this) {
-            event->inttime += time * 1000.0f + 0.5f;
-
-            node = event->next;
-            while ((node != &Event::EventQueue) && (event->inttime >= node->inttime)) {
-                node = node->next;
-            }
-
-            LL_Remove(event, next, prev);
-            LL_Add(node, event, next, prev);
+    EventQueueNode *first;
 
-            return true;
+    // only the first pending event is postponed
+    first = NULL;
+    for (event = m_EventQueueList; event; event = event->listenerNext) {
+        if (!first || event->IsBefore(first)) {
+            first = event;
         }
-        event = event->next;
     }
 
-    return false;
+    if (!first) {
+        return false;
+    }
+
+    Event::EventQueue.Reschedule(first, first->inttime + (int)(time * 1000.0f + 0.5f));
+
+    return true;
 }
 
 /*
@@ -3339,30 +3716,25 @@ PostponeEvent
 qboolean Listener::PostponeEvent(Event& ev, float time)
 {
     EventQueueNode *event;
-    EventQueueNode *node;
+    EventQueueNode *first;
     int             eventnum;
 
     eventnum = ev.eventnum;
 
-    event = Event::EventQueue.next;
-    while (event != &Event::EventQueue) {
-        if ((event->GetSourceObject() == this) && (event->event->eventnum == eventnum)) {
-            event->inttime += time * 1000.0f + 0.5f;
-
-            node = event->next;
-            while ((node != &Event::EventQueue) && (event->inttime >= node->inttime)) {
-                node = node->next;
-            }
-
-            LL_Remove(event, next, prev);
-            LL_Add(node, event, next, prev);
-
-            return true;
+    first = NULL;
+    for (event = m_EventQueueList; event; event = event->listenerNext) {
+        if (event->event->eventnum == eventnum && (!first || event->IsBefore(first))) {
+            first = event;
         }
-        event = event->next;
     }
 
-    return false;
+    if (!first) {
+        return false;
+    }
+
+    Event::EventQueue.Reschedule(first, first->inttime + (int)(time * 1000.0f + 0.5f));
+
+    return true;
 }
 
 /*
@@ -3541,36 +3913,32 @@ qboolean Listener::ProcessPendingEvents(void)
 
     Listener::ProcessingEvents = true;
 
-    event = Event::EventQueue.next;
-    while (event != &Event::EventQueue) {
-        Listener *obj;
-
-        assert(event);
+    for (;;) {
+        EventQueueNode *node;
 
-        obj = event->GetSourceObject();
+        // find the first pending event of this listener
+        event = NULL;
+        for (node = m_EventQueueList; node; node = node->listenerNext) {
+            if (!event || node->IsBefore(event)) {
+                event = node;
+            }
+        }
 
-        if (event->inttime > t) {
+        if (!event || event->inttime > t) {
             break;
         }
 
-        if (obj != this) {
-            // traverse normally
-            event = event->next;
-        } else {
-            // the event is removed from its list and temporarily added to the active list
-            LL_Remove(event, next, prev);
-
-            // ProcessEvent will dispose of this event when it is done
-            obj->ProcessEvent(event->event);
+        // the event is removed from its list
+        L_RemoveEventNode(this, event);
 
-            // free up the node
-            delete event;
+        // ProcessEvent will dispose of this event when it is done
+        ProcessEvent(event->event);
 
-            // start over, since can't guarantee that we didn't process any previous or following events
-            event = Event::EventQueue.next;
+        // free up the node
+        delete event;
 
-            processedEvents = true;
-        }
+        // start over, since can't guarantee that we didn't process any previous or following events
+        processedEvents = true;
     }
 
     Listener::ProcessingEvents = false;
@@ -40,6 +40,7 @@ class ScriptVM;
 class SimpleEntity;
 class Archiver;
 class EventQueueNode;
+class EventQueueHeap;
 
 // entity subclass
 #define ECF_ENTITY        (1 << 0)
@@ -298,6 +299,21 @@ public:
     friend bool operator==(const command_t& cmd1, const command_t& cmd2);
 };
 
+// Argument arrays up to this size are recycled
+#define EVENT_POOLED_ARGS 8
+
+/**
+ * Counters of the argument arrays of the events.
+ */
+struct eventAllocStats_t {
+    // Arrays taken from the pool
+    unsigned int pooled;
+    // Arrays allocated because the pool was empty, they go to the pool once freed
+    unsigned int allocated;
+    // Arrays too large for the pool
+    unsigned int large;
+};
+
 class Event : public Class
 {
 public:
@@ -315,6 +331,12 @@ public:
 private:
     static DataNode *DataNodeList;
 
+    static ScriptVariable *AllocData(int count);
+    static void            FreeData(ScriptVariable *data, int count);
+
+public:
+    static eventAllocStats_t allocStats;
+
 public:
     CLASS_PROTOTYPE(Event);
 
@@ -328,13 +350,14 @@ public:
 
     static void LoadEvents(void);
 
-    static EventQueueNode EventQueue;
+    static EventQueueHeap EventQueue;
 
     static int NumEventCommands();
 
     static void ListCommands(const char *mask = NULL);
     static void ListDocumentation(const char *mask, qboolean print_to_file = qfalse);
     static void PendingEvents(const char *mask = NULL);
+    static void PrintAllocStats(void);
 
     static int GetEvent(str name, uchar type = EV_NORMAL);
     static int GetEventWithFlags(str name, int flags, uchar type = EV_NORMAL);
@@ -472,8 +495,14 @@ public:
     int               flags;
     SafePtr<Listener> m_sourceobject;
 
-    EventQueueNode *prev;
-    EventQueueNode *next;
+    // position in the pending event heap (0 when not queued)
+    int     heapIndex;
+    // tie-break between events posted for the same time
+    int64_t order;
+
+    // intrusive list of the events posted by the same listener
+    EventQueueNode *listenerPrev;
+    EventQueueNode *listenerNext;
 
 #ifdef _DEBUG
     const char *name;
@@ -481,8 +510,10 @@ public:
 
     EventQueueNode()
     {
-        prev = this;
-        next = this;
+        heapIndex    = 0;
+        order        = 0;
+        listenerPrev = NULL;
+        listenerNext = NULL;
 
 #ifdef _DEBUG
         name = NULL;
@@ -492,8 +523,76 @@ public:
     Listener *GetSourceObject(void) { return m_sourceobject; }
 
     void SetSourceObject(Listener *obj) { m_sourceobject = obj; }
+
+    bool IsBefore(const EventQueueNode *other) const;
+};
+
+//
+// Binary min-heap of pending events, ordered by time.
+// Events posted for the same time are processed
+// in the reverse order they were posted, like the original sorted list
+//
+class EventQueueHeap
+{
+private:
+    Container<EventQueueNode *> m_Nodes;
+    int64_t                     m_highOrder;
+    int64_t                     m_lowOrder;
+
+private:
+    void SetNodeAt(int index, EventQueueNode *node);
+    void SiftUp(int index);
+    void SiftDown(int index);
+    void Update(EventQueueNode *node);
+
+public:
+    EventQueueHeap();
+
+    void Insert(EventQueueNode *node);
+    void Append(EventQueueNode *node);
+    void Remove(EventQueueNode *node);
+    void Reschedule(EventQueueNode *node, int inttime);
+    void Reset(void);
+
+    EventQueueNode *Peek(void) const;
+    EventQueueNode *NodeAt(int index) const;
+    int             NumNodes(void) const;
+    bool            IsEmpty(void) const;
 };
 
+inline bool EventQueueNode::IsBefore(const EventQueueNode *other) const
+{
+    if (inttime != other->inttime) {
+        return inttime < other->inttime;
+    }
+
+    return order > other->order;
+}
+
+inline EventQueueNode *EventQueueHeap::Peek(void) const
+{
+    if (!m_Nodes.NumObjects()) {
+        return NULL;
+    }
+
+    return m_Nodes.ObjectAt(1);
+}
+
+inline EventQueueNode *EventQueueHeap::NodeAt(int index) const
+{
+    return m_Nodes.ObjectAt(index);
+}
+
+inline int EventQueueHeap::NumNodes(void) const
+{
+    return m_Nodes.NumObjects();
+}
+
+inline bool EventQueueHeap::IsEmpty(void) const
+{
+    return !m_Nodes.NumObjects();
+}
+
 template<class Type1, class Type2>
 class con_map;
 
@@ -515,6 +614,9 @@ public:
     static bool EventSystemStarted;
     static bool ProcessingEvents;
 
+    // head of the pending events posted for this listener
+    EventQueueNode *m_EventQueueList;
+
 private:
 #ifdef WITH_SCRIPT_ENGINE
     void ExecuteScriptInternal(Event *ev, ScriptVariable& scriptVariable);
@@ -737,3 +839,4 @@ void L_ProcessPendingEvents();
 void L_ShutdownEvents(void);
 void L_ArchiveEvents(Archiver& arc);
 void L_UnarchiveEvents(Archiver& arc);
+void L_LinkUnarchivedEvents(void);
@@ -240,19 +240,55 @@ int cLZ77::Compress(unsigned char *in, size_t in_len, unsigned char *out, size_t
     return 0;
 }
 
-static unsigned int decode_length(unsigned int base, unsigned char *& ip)
+static unsigned int decode_length(unsigned int base, unsigned char *& ip, const unsigned char *ip_end)
 {
     unsigned int len = base;
-    while (!*ip) {
+    while (ip < ip_end && !*ip) {
         len += 255;
         ++ip;
     }
+
+    if (ip == ip_end) {
+        // lengths are never 0
+        return 0;
+    }
+
     return len + *ip++;
 }
 
 int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size_t *out_len)
+{
+    return Decompress(in, in_len, out, (size_t)-1, out_len);
+}
+
+// Stop before reading past the input, writing past the output
+// or copying from before the start of the output
+#define LZ77_CHECK_IN(n) \
+    if ((size_t)(ip_end - ip) < (size_t)(n)) { \
+        *out_len = op - out; \
+        return -1; \
+    }
+#define LZ77_CHECK_OUT(n) \
+    if (out_max - (size_t)(op - out) < (size_t)(n)) { \
+        *out_len = op - out; \
+        return -3; \
+    }
+#define LZ77_SET_MATCH(dist) \
+    if ((size_t)(op - out) < (size_t)(dist)) { \
+        *out_len = op - out; \
+        return -4; \
+    } \
+    m_pos = op - (dist);
+#define LZ77_CHECK_LENGTH(len) \
+    if (!(len)) { \
+        *out_len = op - out; \
+        return -1; \
+    }
+
+int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size_t out_max, size_t *out_len)
 {
     unsigned int   t;
+    unsigned int   b;
     unsigned short s;
 
     ip_end   = &in[in_len];
@@ -260,19 +296,15 @@ int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size
     op       = out;
     *out_len = 0;
 
+    LZ77_CHECK_IN(1);
     if (*ip > 17u) {
         t = *ip++ - 17;
-        if (t <= 3) {
-            copy_bytes(op, ip, t);
-            op += t;
-            ip += t;
-            t = *ip++;
-        } else {
-            copy_bytes(op, ip, t);
-            op += t;
-            ip += t;
-            t = *ip++;
-        }
+        LZ77_CHECK_IN(t + 1);
+        LZ77_CHECK_OUT(t);
+        copy_bytes(op, ip, t);
+        op += t;
+        ip += t;
+        t = *ip++;
     } else {
         t = *ip++;
     }
@@ -280,9 +312,14 @@ int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size
     for (;;) {
         if (t <= 15) {
             if (t == 0) {
-                t = decode_length(15, ip);
+                t = decode_length(15, ip, ip_end);
+                LZ77_CHECK_LENGTH(t);
             }
 
+            // literal run of t + 3 bytes
+            LZ77_CHECK_IN(t + 3 + 1);
+            LZ77_CHECK_OUT(t + 3);
+
             memcpy(op, ip, 4);
             op += 4;
             ip += 4;
@@ -308,7 +345,10 @@ int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size
 
             t = *ip++;
             if (t <= 15) {
-                m_pos = op - 2049 - (t >> 2) - 4 * *ip++;
+                LZ77_CHECK_IN(1);
+                b = *ip++;
+                LZ77_SET_MATCH(2049 + (t >> 2) + 4 * b);
+                LZ77_CHECK_OUT(3);
                 *op++ = *m_pos++;
                 *op++ = *m_pos++;
                 *op++ = *m_pos++;
@@ -318,8 +358,11 @@ int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size
 
         while (true) {
             if (t > 63) {
-                m_pos = op - 1 - ((t >> 2) & 7) - 8 * *ip++;
-                t     = (t >> 5) - 1;
+                LZ77_CHECK_IN(1);
+                b = *ip++;
+                LZ77_SET_MATCH(1 + ((t >> 2) & 7) + 8 * b);
+                t = (t >> 5) - 1;
+                LZ77_CHECK_OUT(t + 2);
                 *op++ = *m_pos++;
                 *op++ = *m_pos++;
                 copy_bytes(op, m_pos, t);
@@ -330,38 +373,46 @@ int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size
             if (t > 31) {
                 t &= 31;
                 if (t == 0) {
-                    t = decode_length(31, ip);
+                    t = decode_length(31, ip, ip_end);
+                    LZ77_CHECK_LENGTH(t);
                 }
 
-                m_pos = op - 1;
+                LZ77_CHECK_IN(2);
                 CopyLittleShort(&s, ip);
                 ip += 2;
-                m_pos -= (s >> 2);
+                LZ77_SET_MATCH(1 + (s >> 2));
             } else {
                 if (t <= 15) {
-                    m_pos = op - 1 - (t >> 2) - 4 * *ip++;
+                    LZ77_CHECK_IN(1);
+                    b = *ip++;
+                    LZ77_SET_MATCH(1 + (t >> 2) + 4 * b);
+                    LZ77_CHECK_OUT(2);
                     *op++ = *m_pos++;
                     *op++ = *m_pos++;
                     break;
                 }
 
-                m_pos = op - 2048 * (t & 8);
+                b = 2048 * (t & 8);
                 t &= 7u;
                 if (t == 0) {
-                    t = decode_length(7, ip);
+                    t = decode_length(7, ip, ip_end);
+                    LZ77_CHECK_LENGTH(t);
                 }
 
+                LZ77_CHECK_IN(2);
                 CopyLittleShort(&s, ip);
                 ip += 2;
-                m_pos -= (s >> 2);
 
-                if (m_pos == op) {
+                if (b + (s >> 2) == 0) {
+                    // end of stream
                     *out_len = op - out;
                     return 0;
                 }
-                m_pos -= 0x4000;
+                LZ77_SET_MATCH(b + (s >> 2) + 0x4000);
             }
 
+            // match of t + 2 bytes
+            LZ77_CHECK_OUT(t + 2);
             if (t <= 5 || static_cast<size_t>(op - m_pos) <= 3) {
                 *op++ = *m_pos++;
                 *op++ = *m_pos++;
@@ -386,24 +437,25 @@ int cLZ77::Decompress(unsigned char *in, size_t in_len, unsigned char *out, size
 
         t = *(ip - 2) & 3;
         if (t == 0) {
+            LZ77_CHECK_IN(1);
             t = *ip++;
             continue;
         }
 
+        LZ77_CHECK_IN(t + 1);
+        LZ77_CHECK_OUT(t);
         copy_bytes(op, ip, t);
         op += t;
         ip += t;
         t = *ip++;
     }
-
-    *out_len = op - out;
-    if (ip == ip_end) {
-        return 0;
-    }
-
-    return (ip < ip_end) ? -1 : -2;
 }
 
+#undef LZ77_CHECK_IN
+#undef LZ77_CHECK_OUT
+#undef LZ77_SET_MATCH
+#undef LZ77_CHECK_LENGTH
+
 static unsigned char in[0x40000];
 static unsigned char out[0x41013];
 
@@ -65,6 +65,19 @@ public:
      */
     int Decompress(unsigned char *in, size_t in_len, unsigned char *out, size_t *out_len);
 
+    /**
+     * @brief Uncompress a block of data using an LZ77 decoder, without writing more than out_max bytes.
+     * 
+     * @param in Input (compressed) buffer.
+     * @param in_len Number of input bytes.
+     * @param out Output (uncompressed) buffer.
+     * @param out_max Size of the output buffer.
+     * @param out_len Output length.
+     * @return 0 on success. -1 if not enough data was read, -3 if the output buffer is too small,
+     * -4 if the data refers to bytes before the start of the output.
+     */
+    int Decompress(unsigned char *in, size_t in_len, unsigned char *out, size_t out_max, size_t *out_len);
+
 private:
     unsigned int CompressData(unsigned char *in, size_t in_len, unsigned char *out, size_t *out_len);
 };
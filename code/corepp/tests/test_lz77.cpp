@@ -64,6 +64,48 @@ bool test_decompression()
     return true;
 }
 
+bool test_bounded_decompression()
+{
+    static unsigned char bounded[0x40000 + 16];
+    size_t               new_len;
+    size_t               i;
+    cLZ77                lz77;
+
+    // too small, nothing must be written past the end
+    memset(bounded, 0xCC, sizeof(bounded));
+    if (lz77.Decompress(out, out_len, bounded, 0x1000, &new_len) != -3) {
+        std::cerr << "Decompressing into a small buffer didn't fail" << std::endl;
+        return false;
+    }
+
+    for (i = 0x1000; i < sizeof(bounded); i++) {
+        if (bounded[i] != 0xCC) {
+            std::cerr << "Decompression wrote past the end of the buffer" << std::endl;
+            return false;
+        }
+    }
+
+    if (lz77.Decompress(out, out_len, bounded, 0x40000, &new_len) || new_len != 0x40000) {
+        std::cerr << "Bounded decompression failed" << std::endl;
+        return false;
+    }
+
+    // truncated or corrupt data must fail without going out of bounds
+    for (i = 1; i < out_len; i++) {
+        lz77.Decompress(out, i, bounded, 0x40000, &new_len);
+    }
+
+    for (i = 0; i < 256; i++) {
+        unsigned char corrupt[64];
+
+        memset(corrupt, (int)i, sizeof(corrupt));
+        lz77.Decompress(corrupt, sizeof(corrupt), bounded, 0x40000, &new_len);
+    }
+
+    std::cout << "Checked bounded decompression" << std::endl;
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     if (!test_compression()) {
@@ -76,5 +118,10 @@ int main(int argc, char *argv[])
         return 2;
     }
 
+    if (!test_bounded_decompression()) {
+        std::cerr << "Bounded Decompression Failed!" << std::endl;
+        return 3;
+    }
+
     return 0;
 }
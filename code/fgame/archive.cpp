@@ -294,7 +294,9 @@ Archiver::Archiver()
     fileerror   = false;
     harderror   = true;
     Reset();
-    silent = false;
+    silent        = false;
+    checksumpos   = 0;
+    checksumstart = 0;
 
     assert((sizeof(typenames) / sizeof(typenames[0])) == ARC_NUMTYPES);
 }
@@ -354,6 +356,15 @@ void Archiver::Close(void)
         archivefile.Seek(numclassespos);
         numobjects = classpointerList.NumObjects();
         ArchiveInteger(&numobjects);
+        if (checksumpos) {
+            unsigned checksum;
+
+            // Added in OPM
+            //  write out the checksum of what was archived after it
+            checksum = archivefile.Checksum(checksumstart);
+            archivefile.Seek(checksumpos);
+            ArchiveUnsigned(&checksum);
+        }
         // compress the file
         archivefile.Seek(pos);
         archivefile.Compress();
@@ -409,6 +420,8 @@ qboolean Archiver::Read(const char *name, qboolean harderror)
     this->fileerror   = false;
     this->archivemode = ARCHIVE_READ;
     this->filename    = name;
+    checksumpos       = 0;
+    checksumstart     = 0;
 
     if (!archivefile.OpenRead(filename.c_str())) {
         if (harderror) {
@@ -462,6 +475,8 @@ qboolean Archiver::Create(const char *name, qboolean harderror)
     this->fileerror   = false;
     this->archivemode = ARCHIVE_WRITE;
     this->filename    = name;
+    checksumpos       = 0;
+    checksumstart     = 0;
 
     if (!archivefile.OpenWrite(filename.c_str())) {
         FileError("Couldn't open file.");
@@ -1062,6 +1077,40 @@ qboolean Archiver::NoErrors(void)
     return fileerror ? qfalse : qtrue;
 }
 
+/*
+============
+Archiver::ArchiveChecksum
+
+Added in OPM
+Checksum of everything archived after this call.
+It's written when a saved archive is closed, and checked right away
+when loading so the rest of the file can be trusted before it's read
+============
+*/
+qboolean Archiver::ArchiveChecksum(void)
+{
+    unsigned checksum = 0;
+
+    if (archivemode == ARCHIVE_WRITE) {
+        checksumpos = archivefile.Tell();
+        ArchiveUnsigned(&checksum);
+        checksumstart = archivefile.Tell();
+        return NoErrors();
+    }
+
+    ArchiveUnsigned(&checksum);
+    if (fileerror) {
+        return qfalse;
+    }
+
+    if (archivefile.Checksum(archivefile.Tell()) != checksum) {
+        FileError("Checksum mismatch.");
+        return qfalse;
+    }
+
+    return qtrue;
+}
+
 size_t Archiver::Counter() const
 {
     return m_iNumBytesIO;
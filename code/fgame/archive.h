@@ -80,6 +80,7 @@ public:
     qboolean    OpenWrite(const char *name);
     qboolean    Read(void *dest, size_t size);
     qboolean    Write(const void *source, size_t size);
+    unsigned    Checksum(size_t start); // Added in OPM
 };
 
 class Archiver
@@ -97,6 +98,9 @@ protected:
     qboolean    harderror;
     size_t      m_iNumBytesIO;
     qboolean    silent;
+    // Added in OPM
+    size_t      checksumpos;
+    size_t      checksumstart;
 
     void       CheckRead(void);
     void       CheckType(int type);
@@ -125,6 +129,7 @@ public:
     qboolean Loading(void);
     qboolean Saving(void);
     qboolean NoErrors(void);
+    qboolean ArchiveChecksum(void); // Added in OPM
 
     void ArchiveVector(Vector *vec);
     void ArchiveQuat(Quat *quat);
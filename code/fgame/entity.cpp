@@ -2075,6 +2075,8 @@ void Entity::SetSize(void)
 
     edict->r.radius = size.length() * 0.5;
     edict->radius2  = edict->r.radius * edict->r.radius;
+
+    G_LinkEntityGrid(edict);
 }
 
 void Entity::ProcessInitCommands(void)
@@ -2265,6 +2267,8 @@ void Entity::link(void)
     centroid = (absmin + absmax) * 0.5;
     centroid.copyTo(edict->r.centroid);
 
+    G_LinkEntityGrid(edict);
+
     // If this has a parent, then set the areanum the same
     // as the parent's
     if (edict->s.parent != ENTITYNUM_NONE) {
@@ -0,0 +1,264 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// entitygrid.cpp: Uniform grid of entity centroids used for radius queries
+
+#include "entitygrid.h"
+
+#include <cmath>
+
+static constexpr int ENTITYGRID_BIG_BUCKET = ENTITYGRID_NUM_BUCKETS;
+
+EntityGridQuery::EntityGridQuery()
+{
+    Clear();
+}
+
+void EntityGridQuery::Clear()
+{
+    memset(bits, 0, sizeof(bits));
+    numEntities = 0;
+}
+
+void EntityGridQuery::Add(int entnum)
+{
+    unsigned int mask = 1u << (entnum & 31);
+
+    if (!(bits[entnum >> 5] & mask)) {
+        bits[entnum >> 5] |= mask;
+        numEntities++;
+    }
+}
+
+int EntityGridQuery::NextEntityNum(int entnum) const
+{
+    unsigned int word;
+    int          i;
+
+    entnum++;
+    if (entnum >= MAX_GENTITIES) {
+        return -1;
+    }
+
+    i    = entnum >> 5;
+    word = bits[i] & (~0u << (entnum & 31));
+
+    for (;;) {
+        if (word) {
+            int bit = 0;
+
+            while (!(word & 1)) {
+                word >>= 1;
+                bit++;
+            }
+
+            return (i << 5) + bit;
+        }
+
+        i++;
+        if (i >= MAX_GENTITIES / 32) {
+            return -1;
+        }
+
+        word = bits[i];
+    }
+}
+
+EntityGrid::EntityGrid()
+{
+    revision = 0;
+    Clear();
+}
+
+void EntityGrid::Clear()
+{
+    int i;
+
+    for (i = 0; i < MAX_GENTITIES; i++) {
+        bucket[i] = -1;
+        next[i]   = -1;
+        prev[i]   = -1;
+    }
+
+    for (i = 0; i < ENTITYGRID_NUM_BUCKETS + 1; i++) {
+        buckets[i] = -1;
+    }
+
+    revision++;
+}
+
+int EntityGrid::CellCoord(float value)
+{
+    return (int)floorf(value / ENTITYGRID_CELL_SIZE);
+}
+
+int EntityGrid::BucketForCell(int x, int y)
+{
+    unsigned int hash;
+
+    hash = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u;
+    return hash & (ENTITYGRID_NUM_BUCKETS - 1);
+}
+
+bool EntityGrid::MatchRadius(const vec3_t org, float radius2, const vec3_t centroid, float entRadius2)
+{
+    vec3_t delta;
+
+    VectorSubtract(org, centroid, delta);
+
+    // subtract the object's own radius from the distance
+    return DotProduct(delta, delta) - entRadius2 <= radius2;
+}
+
+void EntityGrid::AddToBucket(int entnum, int b)
+{
+    bucket[entnum] = b;
+    prev[entnum]   = -1;
+    next[entnum]   = buckets[b];
+
+    if (buckets[b] != -1) {
+        prev[buckets[b]] = entnum;
+    }
+
+    buckets[b] = entnum;
+}
+
+void EntityGrid::RemoveFromBucket(int entnum)
+{
+    if (prev[entnum] != -1) {
+        next[prev[entnum]] = next[entnum];
+    } else {
+        buckets[bucket[entnum]] = next[entnum];
+    }
+
+    if (next[entnum] != -1) {
+        prev[next[entnum]] = prev[entnum];
+    }
+
+    bucket[entnum] = -1;
+    next[entnum]   = -1;
+    prev[entnum]   = -1;
+}
+
+void EntityGrid::Link(int entnum, const vec3_t centroid, float radius2)
+{
+    int b;
+    int x, y;
+
+    assert(entnum >= 0 && entnum < MAX_GENTITIES);
+
+    if (radius2 > Square(ENTITYGRID_MAX_CELL_RADIUS)) {
+        x = y = 0;
+        b = ENTITYGRID_BIG_BUCKET;
+    } else {
+        x = CellCoord(centroid[0]);
+        y = CellCoord(centroid[1]);
+        b = BucketForCell(x, y);
+    }
+
+    VectorCopy(centroid, centroids[entnum]);
+    radiuses2[entnum] = radius2;
+    revision++;
+
+    if (bucket[entnum] == b && cellX[entnum] == x && cellY[entnum] == y) {
+        // still in the same cell
+        return;
+    }
+
+    if (bucket[entnum] != -1) {
+        RemoveFromBucket(entnum);
+    }
+
+    cellX[entnum] = x;
+    cellY[entnum] = y;
+    AddToBucket(entnum, b);
+}
+
+void EntityGrid::Unlink(int entnum)
+{
+    assert(entnum >= 0 && entnum < MAX_GENTITIES);
+
+    if (bucket[entnum] == -1) {
+        return;
+    }
+
+    RemoveFromBucket(entnum);
+    revision++;
+}
+
+void EntityGrid::QueryList(int first, const vec3_t org, float radius2, EntityGridQuery& query) const
+{
+    int entnum;
+
+    for (entnum = first; entnum != -1; entnum = next[entnum]) {
+        if (MatchRadius(org, radius2, centroids[entnum], radiuses2[entnum])) {
+            query.Add(entnum);
+        }
+    }
+}
+
+void EntityGrid::QueryRadius(const vec3_t org, float radius, EntityGridQuery& query) const
+{
+    float searchRadius;
+    float radius2;
+    int   minX, minY, maxX, maxY;
+    int   x, y;
+    int   entnum;
+
+    query.Clear();
+
+    radius2 = Square(radius);
+
+    // big entities are always tested
+    QueryList(buckets[ENTITYGRID_BIG_BUCKET], org, radius2, query);
+
+    // entities in cells can match from farther than the radius
+    searchRadius = sqrtf(radius2 + Square(ENTITYGRID_MAX_CELL_RADIUS));
+
+    minX = CellCoord(org[0] - searchRadius);
+    minY = CellCoord(org[1] - searchRadius);
+    maxX = CellCoord(org[0] + searchRadius);
+    maxY = CellCoord(org[1] + searchRadius);
+
+    if ((maxX - minX + 1) * (maxY - minY + 1) >= ENTITYGRID_NUM_BUCKETS) {
+        // visiting each bucket once is faster
+        for (x = 0; x < ENTITYGRID_NUM_BUCKETS; x++) {
+            QueryList(buckets[x], org, radius2, query);
+        }
+        return;
+    }
+
+    for (y = minY; y <= maxY; y++) {
+        for (x = minX; x <= maxX; x++) {
+            for (entnum = buckets[BucketForCell(x, y)]; entnum != -1; entnum = next[entnum]) {
+                // multiple cells can share the same bucket
+                if (cellX[entnum] != x || cellY[entnum] != y) {
+                    continue;
+                }
+
+                if (MatchRadius(org, radius2, centroids[entnum], radiuses2[entnum])) {
+                    query.Add(entnum);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// entitygrid.h: Uniform grid of entity centroids used for radius queries
+
+#pragma once
+
+#include "../qcommon/q_shared.h"
+
+// Size of a grid cell on the X and Y axis.
+// The grid is two-dimensional as maps are mostly flat
+static constexpr int ENTITYGRID_CELL_SIZE = 512;
+// Number of hash buckets the cells are spread into
+static constexpr int ENTITYGRID_NUM_BUCKETS = 1024;
+// Entities bigger than this radius are not put in a cell,
+// they are tested against every query
+static constexpr float ENTITYGRID_MAX_CELL_RADIUS = 512;
+
+/**
+ * @brief Result of an entity grid query,
+ * iterated in entity number order.
+ */
+class EntityGridQuery
+{
+    friend class EntityGrid;
+
+public:
+    EntityGridQuery();
+
+    void Clear();
+    void Add(int entnum);
+    int  NumEntities() const;
+
+    /**
+     * @brief Return the first entity number after the specified one.
+     * 
+     * @param entnum The previous entity number, -1 to start.
+     * @return int The next entity number or -1 if there is none.
+     */
+    int NextEntityNum(int entnum) const;
+
+private:
+    unsigned int bits[MAX_GENTITIES / 32];
+    int          numEntities;
+};
+
+/**
+ * @brief Uniform grid of entity centroids.
+ * Each entity is stored in the cell its centroid is in,
+ * with the squared radius used by findradius.
+ */
+class EntityGrid
+{
+public:
+    EntityGrid();
+
+    void Clear();
+    void Link(int entnum, const vec3_t centroid, float radius2);
+    void Unlink(int entnum);
+    bool IsLinked(int entnum) const;
+
+    /**
+     * @brief Find entities that are within the radius.
+     * An entity matches if the squared distance to its centroid,
+     * minus its squared radius, is within the squared radius.
+     */
+    void QueryRadius(const vec3_t org, float radius, EntityGridQuery& query) const;
+
+    /**
+     * @brief Incremented each time the grid changes.
+     */
+    unsigned int GetRevision() const;
+
+private:
+    static int  CellCoord(float value);
+    static int  BucketForCell(int x, int y);
+    static bool MatchRadius(const vec3_t org, float radius2, const vec3_t centroid, float entRadius2);
+
+    void AddToBucket(int entnum, int bucket);
+    void RemoveFromBucket(int entnum);
+    void QueryList(int first, const vec3_t org, float radius2, EntityGridQuery& query) const;
+
+private:
+    // bucket number for each entity, or -1 if not linked
+    short bucket[MAX_GENTITIES];
+    // cell coordinates, as multiple cells may share the same bucket
+    int    cellX[MAX_GENTITIES];
+    int    cellY[MAX_GENTITIES];
+    short  next[MAX_GENTITIES];
+    short  prev[MAX_GENTITIES];
+    vec3_t centroids[MAX_GENTITIES];
+    float  radiuses2[MAX_GENTITIES];
+
+    // first entity of each bucket, the last one is for big entities
+    short        buckets[ENTITYGRID_NUM_BUCKETS + 1];
+    unsigned int revision;
+};
+
+inline unsigned int EntityGrid::GetRevision() const
+{
+    return revision;
+}
+
+inline bool EntityGrid::IsLinked(int entnum) const
+{
+    return bucket[entnum] != -1;
+}
+
+inline int EntityGridQuery::NumEntities() const
+{
+    return numEntities;
+}
+
+extern EntityGrid entityGrid;
@@ -317,6 +317,8 @@ void G_BotShift(int clientNum)
     newEnt->entity->entnum       = newEnt->s.number;
     newEnt->client->ps.clientNum = newEnt->s.number;
 
+    G_LinkEntityGrid(newEnt);
+
     G_ChangeParent(ent->s.number, newEnt->s.number);
 
     //
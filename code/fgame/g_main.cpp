@@ -46,7 +46,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #    include <intrin.h>
 #endif
 
-#define SAVEGAME_VERSION   80
+// Changed in OPM
+//  81: script opcodes have inline cache operands, changing saved code positions
+//  82: whether scripts were optimized is saved with the script state
+//  83: optimized scripts fuse local variable comparisons, changing saved code positions
+#define SAVEGAME_VERSION   83
 #define PERSISTANT_VERSION 2
 
 static char G_ErrorMessage[4096];
@@ -1573,6 +1577,9 @@ qboolean G_ArchiveLevel(
 
         if (arc.Loading()) {
             arc.Close();
+            // the event source objects are now valid
+            L_LinkUnarchivedEvents();
+            G_RebuildEntityGrid();
             LoadingSavegame = false;
             gi.Printf(HUD_MESSAGE_YELLOW "%s\n", gi.LV_ConvertString("Game Loaded"));
         } else {
@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "debuglines.h"
 #include "smokesprite.h"
 #include "../corepp/tiki.h"
+#include "entitygrid.h"
 
 const char *means_of_death_strings[MOD_TOTAL_NUMBER] = {
     "none",
@@ -1014,6 +1015,55 @@ qboolean IsNumeric(const char *str)
     return true;
 }
 
+/*
+=================
+G_GetMapChecksum
+
+Return the checksum of the BSP file, computed by the server
+when loading the map
+=================
+*/
+int G_GetMapChecksum(void)
+{
+    return gi.Cvar_Get("sv_mapChecksum", "", 0)->integer;
+}
+
+EntityGrid entityGrid;
+
+/*
+=================
+G_LinkEntityGrid
+
+Update the entity position in the grid used by findradius
+=================
+*/
+void G_LinkEntityGrid(gentity_t *ent)
+{
+    if (!ent->inuse || !ent->entity) {
+        return;
+    }
+
+    entityGrid.Link(ent->s.number, ent->entity->centroid, ent->radius2);
+}
+
+/*
+=================
+G_RebuildEntityGrid
+
+Relink all active entities, after loading a savegame
+=================
+*/
+void G_RebuildEntityGrid(void)
+{
+    gentity_t *edict;
+
+    entityGrid.Clear();
+
+    for (edict = active_edicts.next; edict != &active_edicts; edict = edict->next) {
+        G_LinkEntityGrid(edict);
+    }
+}
+
 /*
 =================
 findradius
@@ -1025,43 +1075,33 @@ findradius (org, radius)
 */
 Entity *findradius(Entity *startent, Vector org, float rad)
 {
-    Vector     eorg;
-    gentity_t *from;
-    float      r2, distance;
+    // the result of the last query is kept
+    // so each iteration doesn't search again
+    static EntityGridQuery query;
+    static Vector          queryOrg;
+    static float           queryRadius;
+    static unsigned int    queryRevision;
+    static bool            queryValid = false;
+    gentity_t             *from;
+    int                    entnum;
 
-    if (!startent) {
-        from = active_edicts.next;
-    } else {
-        from = startent->edict->next;
+    if (!queryValid || queryRevision != entityGrid.GetRevision() || queryOrg != org || queryRadius != rad) {
+        entityGrid.QueryRadius(org, rad, query);
+        queryOrg      = org;
+        queryRadius   = rad;
+        queryRevision = entityGrid.GetRevision();
+        queryValid    = true;
     }
 
-    assert(from);
-    if (!from) {
-        return NULL;
-    }
-
-    assert((from == &active_edicts) || (from->inuse));
+    entnum = startent ? startent->entnum : -1;
 
-    // square the radius so that we don't have to do a square root
-    r2 = rad * rad;
+    for (entnum = query.NextEntityNum(entnum); entnum != -1; entnum = query.NextEntityNum(entnum)) {
+        from = &g_entities[entnum];
 
-    for (; from != &active_edicts; from = from->next) {
         assert(from->inuse);
         assert(from->entity);
-
-        eorg = org - from->entity->centroid;
-
-        // dot product returns length squared
-        distance = eorg * eorg;
-
-        if (distance <= r2) {
+        if (from->inuse && from->entity) {
             return from->entity;
-        } else {
-            // subtract the object's own radius from this distance
-            distance -= from->radius2;
-            if (distance <= r2) {
-                return from->entity;
-            }
         }
     }
 
@@ -131,6 +131,9 @@ float    G_GetAngle(Vector movedir);
 qboolean KillBox(Entity *ent);
 qboolean IsNumeric(const char *str);
 
+int     G_GetMapChecksum(void);
+void    G_LinkEntityGrid(gentity_t *ent);
+void    G_RebuildEntityGrid(void);
 Entity *findradius(Entity *startent, Vector org, float rad);
 Entity *findclientsinradius(Entity *startent, Vector org, float rad);
 
@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "lodthing.h"
 #include "player.h"
 #include <scriptcompiler.h>
+#include <scriptprofiler.h>
 #include "playerbot.h"
 #include "consoleevent.h"
 #include "g_bot.h"
@@ -70,6 +71,8 @@ consolecmd_t G_ConsoleCmds[] = {
     // Added in OPM
     //====
     {"compilescript",   G_CompileScript,      qfalse},
+    {"scriptprofile",   G_ScriptProfileCmd,   qfalse},
+    {"eventstats",      G_EventStatsCmd,      qfalse},
     {"addbot",          G_AddBotCommand,      qfalse},
     {"addbotnamed",     G_AddBotNamedCommand, qfalse},
     {"removebot",       G_RemoveBotCommand,   qfalse},
@@ -629,6 +632,44 @@ qboolean G_CompileScript(gentity_t *ent)
     return qtrue;
 }
 
+qboolean G_ScriptProfileCmd(gentity_t *ent)
+{
+    const char *cmd;
+
+    cmd = gi.Argc() > 1 ? gi.Argv(1) : "report";
+
+    if (!Q_stricmp(cmd, "report")) {
+        ScriptProfile.PrintReport(gi.Argc() > 2 ? atoi(gi.Argv(2)) : 20);
+    } else if (!Q_stricmp(cmd, "clear")) {
+        ScriptProfile.Clear();
+    } else if (!Q_stricmp(cmd, "collapsed")) {
+        const char *filename = gi.Argc() > 2 ? gi.Argv(2) : "scriptprofile.txt";
+
+        if (!ScriptProfile.WriteCollapsedStacks(filename)) {
+            gi.Printf("No script profile to write\n");
+            return qfalse;
+        }
+
+        gi.Printf("Wrote %s\n", filename);
+    } else {
+        gi.Printf("Usage: scriptprofile [report [lines] | clear | collapsed [filename]]\n");
+        return qfalse;
+    }
+
+    return qtrue;
+}
+
+qboolean G_EventStatsCmd(gentity_t *ent)
+{
+    if (gi.Argc() > 1 && !Q_stricmp(gi.Argv(1), "reset")) {
+        memset(&Event::allocStats, 0, sizeof(Event::allocStats));
+        return qtrue;
+    }
+
+    Event::PrintAllocStats();
+    return qtrue;
+}
+
 qboolean G_AddBotCommand(gentity_t *ent)
 {
     unsigned int numbots;
@@ -56,6 +56,8 @@ qboolean G_GameVarsCmd(gentity_t* ent);
 qboolean G_ScriptCmd(gentity_t* ent);
 qboolean G_ReloadMap(gentity_t* ent);
 qboolean G_CompileScript(gentity_t *ent);
+qboolean G_ScriptProfileCmd(gentity_t *ent);
+qboolean G_EventStatsCmd(gentity_t *ent);
 qboolean G_AddBotCommand(gentity_t *ent);
 qboolean G_AddBotNamedCommand(gentity_t *ent);
 qboolean G_RemoveBotCommand(gentity_t *ent);
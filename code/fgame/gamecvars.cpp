@@ -131,6 +131,9 @@ cvar_t *g_scriptcheck;
 cvar_t *g_nodecheck;
 cvar_t *g_scriptdebug;
 cvar_t *g_scripttrace;
+cvar_t *g_scriptoptimize;
+cvar_t *g_scriptcache;
+cvar_t *g_scriptprofile;
 
 cvar_t *g_ai;
 cvar_t *g_vehicle;
@@ -313,6 +316,8 @@ cvar_t *g_teambalance;
 
 // Whether or not to use Legacy Navigation
 cvar_t *g_navigation_legacy;
+cvar_t *g_navigation_updatetime;
+cvar_t *g_navigation_pathiterations;
 
 void CVAR_Init(void)
 {
@@ -441,16 +446,19 @@ void CVAR_Init(void)
     g_playermodel = gi.Cvar_Get("g_playermodel", "american_army", CVAR_SAVEGAME);
     g_statefile   = gi.Cvar_Get("g_statefile", "global/mike", 0);
 
-    g_showautoaim  = gi.Cvar_Get("g_showautoaim", "0", 0);
-    g_debugtargets = gi.Cvar_Get("g_debugtargets", "0", 0);
-    g_debugdamage  = gi.Cvar_Get("g_debugdamage", "0", 0);
-    g_logstats     = gi.Cvar_Get("g_logstats", "0", 0);
-    g_showtokens   = gi.Cvar_Get("g_showtokens", "0", 0);
-    g_showopcodes  = gi.Cvar_Get("g_showopcodes", "0", 0);
-    g_scriptcheck  = gi.Cvar_Get("g_scriptcheck", "0", 0);
-    g_nodecheck    = gi.Cvar_Get("g_nodecheck", "0", 0);
-    g_scriptdebug  = gi.Cvar_Get("g_scriptdebug", "0", 0);
-    g_scripttrace  = gi.Cvar_Get("g_scripttrace", "0", 0);
+    g_showautoaim    = gi.Cvar_Get("g_showautoaim", "0", 0);
+    g_debugtargets   = gi.Cvar_Get("g_debugtargets", "0", 0);
+    g_debugdamage    = gi.Cvar_Get("g_debugdamage", "0", 0);
+    g_logstats       = gi.Cvar_Get("g_logstats", "0", 0);
+    g_showtokens     = gi.Cvar_Get("g_showtokens", "0", 0);
+    g_showopcodes    = gi.Cvar_Get("g_showopcodes", "0", 0);
+    g_scriptcheck    = gi.Cvar_Get("g_scriptcheck", "0", 0);
+    g_nodecheck      = gi.Cvar_Get("g_nodecheck", "0", 0);
+    g_scriptdebug    = gi.Cvar_Get("g_scriptdebug", "0", 0);
+    g_scripttrace    = gi.Cvar_Get("g_scripttrace", "0", 0);
+    g_scriptoptimize = gi.Cvar_Get("g_scriptoptimize", "1", CVAR_LATCH);
+    g_scriptcache    = gi.Cvar_Get("g_scriptcache", "1", 0);
+    g_scriptprofile  = gi.Cvar_Get("g_scriptprofile", "0", 0);
 
     g_ai      = gi.Cvar_Get("g_ai", "1", 0);
     g_vehicle = gi.Cvar_Get("g_vehicle", "1", 0);
@@ -712,7 +720,9 @@ void CVAR_Init(void)
 
     g_teambalance = gi.Cvar_Get("g_teambalance", "0", 0);
 
-    g_navigation_legacy = gi.Cvar_Get("g_navigation_legacy", "0", CVAR_LATCH);
+    g_navigation_legacy         = gi.Cvar_Get("g_navigation_legacy", "0", CVAR_LATCH);
+    g_navigation_updatetime     = gi.Cvar_Get("g_navigation_updatetime", "2", 0);
+    g_navigation_pathiterations = gi.Cvar_Get("g_navigation_pathiterations", "1024", 0);
 
     cl_running = gi.Cvar_Get("cl_running", "", 0);
 }
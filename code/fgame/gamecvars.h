@@ -136,6 +136,9 @@ extern cvar_t *g_scriptcheck;
 extern cvar_t *g_nodecheck;
 extern cvar_t *g_scriptdebug;
 extern cvar_t *g_scripttrace;
+extern cvar_t *g_scriptoptimize;
+extern cvar_t *g_scriptcache;
+extern cvar_t *g_scriptprofile;
 
 extern cvar_t *g_ai;
 extern cvar_t *g_vehicle;
@@ -340,6 +343,8 @@ extern cvar_t *g_textmsg_minDelay;
 extern cvar_t *g_teambalance;
 
 extern cvar_t *g_navigation_legacy;
+extern cvar_t *g_navigation_updatetime;
+extern cvar_t *g_navigation_pathiterations;
 
 void CVAR_Init(void);
 
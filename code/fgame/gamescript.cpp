@@ -299,14 +299,10 @@ const_str StateScript::NearestLabel(unsigned char *pos)
     for (entry = en.NextElement(); entry; entry = en.NextElement()) {
         const script_label_t& l = entry->value;
 
-        if ((l.codepos - m_Parent->m_ProgBuffer) >= bestOfs) {
+        // The labels aren't sorted, find the closest one before the position
+        if ((l.codepos - m_Parent->m_ProgBuffer) >= bestOfs && (l.codepos - m_Parent->m_ProgBuffer) <= offset) {
             bestOfs = l.codepos - m_Parent->m_ProgBuffer;
-
-            if (bestOfs > offset) {
-                break;
-            }
-
-            label = l.key;
+            label   = l.key;
         }
     }
 
@@ -320,6 +316,9 @@ GameScript::GameScript()
 
     m_ProgBuffer   = NULL;
     m_ProgLength   = 0;
+
+    m_InlineCaches    = NULL;
+    m_NumInlineCaches = 0;
     m_bPrecompiled = false;
 
     requiredStackSize = 0;
@@ -334,6 +333,9 @@ GameScript::GameScript(const char *filename)
 
     m_ProgBuffer   = NULL;
     m_ProgLength   = 0;
+
+    m_InlineCaches    = NULL;
+    m_NumInlineCaches = 0;
     m_ProgToSource = NULL;
     m_bPrecompiled = false;
 
@@ -361,9 +363,11 @@ static Container<pfixup_t *> archivedPointerFixup;
 
 void ArchiveOpcode(Archiver& arc, unsigned char *code)
 {
-    unsigned int index;
+    unsigned int  index;
+    unsigned char opcode;
 
     arc.ArchiveByte(code);
+    opcode = *code;
 
     switch (*code) {
     case OP_STORE_NIL:
@@ -374,6 +378,7 @@ void ArchiveOpcode(Archiver& arc, unsigned char *code)
     case OP_EXEC_CMD_COUNT1:
     case OP_EXEC_CMD_METHOD_COUNT1:
     case OP_EXEC_METHOD_COUNT1:
+    case OP_EXEC_CMD_SELF_METHOD_COUNT1:
         arc.ArchiveByte(code + 1);
         goto __exec;
 
@@ -412,6 +417,11 @@ void ArchiveOpcode(Archiver& arc, unsigned char *code)
             *reinterpret_cast<unsigned int *>(code + 2) = index;
             archivedPointerFixup.AddObject(p);
         }
+
+        if ((opcode >= OP_EXEC_CMD_METHOD0 && opcode <= OP_EXEC_METHOD_COUNT1)
+            || opcode == OP_EXEC_CMD_SELF_METHOD_COUNT1) {
+            arc.ArchiveRaw(code + 2 + sizeof(op_ev_t), sizeof(op_cacheIndex_t));
+        }
         break;
 
     case OP_LOAD_FIELD_VAR:
@@ -439,6 +449,7 @@ void ArchiveOpcode(Archiver& arc, unsigned char *code)
     case OP_STORE_PARM_VAR:
     case OP_STORE_SELF_VAR:
     case OP_STORE_STRING:
+    case OP_LOCAL_COMPARE_JUMP_FALSE4:
         if (!arc.Loading()) {
             index = archivedStrings.AddUniqueObject(*reinterpret_cast<const_str *>(code + 1));
         }
@@ -454,6 +465,13 @@ void ArchiveOpcode(Archiver& arc, unsigned char *code)
             *reinterpret_cast<unsigned int *>(code + 1) = index;
             archivedPointerFixup.AddObject(p);
         }
+
+        if (opcode == OP_LOCAL_COMPARE_JUMP_FALSE4) {
+            // the comparison opcode and the jump offset follow the field
+            arc.ArchiveRaw(code + 1 + sizeof(op_name_t), OpcodeLength(opcode) - 1 - sizeof(op_name_t));
+        } else if (opcode != OP_STORE_STRING) {
+            arc.ArchiveRaw(code + 1 + sizeof(op_name_t), sizeof(op_cacheIndex_t));
+        }
         break;
 
     default:
@@ -709,6 +727,13 @@ void GameScript::Close(void)
         m_ProgBuffer = NULL;
     }
 
+    if (m_InlineCaches) {
+        delete[] m_InlineCaches;
+        m_InlineCaches = NULL;
+    }
+
+    m_NumInlineCaches = 0;
+
     if (m_SourceBuffer) {
         gi.Free(m_SourceBuffer);
         m_SourceBuffer = NULL;
@@ -735,6 +760,11 @@ void GameScript::Load(const void *sourceBuffer, size_t sourceLength)
 
     memcpy(m_SourceBuffer, sourceBuffer, sourceLength);
 
+    if (CanUseCache() && LoadCache()) {
+        successCompile = true;
+        return;
+    }
+
     Compiler.Reset();
 
     m_PreprocessedBuffer = Compiler.Preprocess(m_SourceBuffer);
@@ -761,7 +791,16 @@ void GameScript::Load(const void *sourceBuffer, size_t sourceLength)
 
     requiredStackSize = Compiler.m_iInternalMaxVarStackOffset + 9 * Compiler.m_iMaxExternalVarStackOffset + 1;
 
+    m_NumInlineCaches = Compiler.m_iNumInlineCaches;
+    if (m_NumInlineCaches) {
+        m_InlineCaches = new ScriptInlineCache[m_NumInlineCaches];
+    }
+
     successCompile = true;
+
+    if (CanUseCache()) {
+        SaveCache();
+    }
 }
 
 bool GameScript::GetCodePos(unsigned char *codePos, str& filename, int& pos)
@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "../corepp/class.h"
 #include "../corepp/script.h"
+#include "../script/scriptinlinecache.h"
 #include "archive.h"
 
 class Listener;
@@ -127,6 +128,10 @@ public:
     unsigned char *m_ProgBuffer;
     size_t         m_ProgLength;
 
+    // inline caches of the field and method sites
+    ScriptInlineCache *m_InlineCaches;
+    int                m_NumInlineCaches;
+
     // compile variables
     bool successCompile;
     bool m_bPrecompiled;
@@ -159,6 +164,12 @@ public:
     StateScript *GetCatchStateScript(unsigned char *in, unsigned char *& out);
 
     bool ScriptCheck(void);
+
+private:
+    // Compiled program cache, see gamescript_cache.cpp
+    bool CanUseCache(void) const;
+    bool LoadCache(void);
+    void SaveCache(void);
 };
 
 class ScriptThreadLabel
@@ -0,0 +1,907 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+/**
+ * @file gamescript_cache.cpp
+ * @brief Save and load compiled script programs.
+ *
+ * Parsing and compiling every script takes a good part of the map loading time,
+ * so compiled programs are written to a cache file and reused as long as
+ * the script source and the compiler are the same.
+ * Strings, events and switch blocks are stored in the program as indexes
+ * in the tables of the cache file, and are resolved again when loading.
+ */
+
+#include "glb_local.h"
+#include "gamescript.h"
+#include "scriptcompiler.h"
+#include "scriptmaster.h"
+
+static constexpr int SCRIPTCACHE_IDENT   = (('C' << 24) + ('R' << 16) + ('C' << 8) + 'S');
+static constexpr int SCRIPTCACHE_VERSION = 1;
+
+struct scriptCacheHeader_t {
+    int          ident;
+    int          version;
+    // The cache is rebuilt when the opcodes or the events change
+    int          numOpcodes;
+    int          numEventCommands;
+    int          optimize;
+    unsigned int sourceLength;
+    uint64_t     sourceHash;
+    unsigned int progLength;
+    unsigned int requiredStackSize;
+    int          numInlineCaches;
+    int          numSwitchStateScripts;
+    int          numCatchBlocks;
+    int          numLabels;
+    int          numSourceInfos;
+    int          numStrings;
+    int          numEvents;
+    // checksum of everything after the header
+    uint64_t     dataChecksum;
+};
+
+/**
+ * @brief State script, the main one comes first,
+ * followed by the switch blocks and the catch blocks.
+ */
+struct scriptCacheStateScript_t {
+    int          numLabels;
+    // Catch blocks only
+    unsigned int tryStartCodePos;
+    unsigned int tryEndCodePos;
+};
+
+struct scriptCacheLabel_t {
+    // Indexes in the string table
+    unsigned int key;
+    unsigned int name;
+    unsigned int codePos;
+    int          isPrivate;
+};
+
+struct scriptCacheSourceInfo_t {
+    unsigned int codePos;
+    unsigned int sourcePos;
+    int          column;
+    int          line;
+};
+
+enum scriptCacheOperand_e {
+    SCRIPTCACHE_OPERAND_NONE,
+    SCRIPTCACHE_OPERAND_STRING,
+    SCRIPTCACHE_OPERAND_EVENT,
+    SCRIPTCACHE_OPERAND_STATESCRIPT
+};
+
+/**
+ * @brief Strings and events referenced by the program, in the order they are written.
+ * Index 0 is reserved for STRING_NULL and for invalid events.
+ */
+struct scriptCacheTables_t {
+    Container<const_str>                strings;
+    con_set<const_str, unsigned int>    stringIndexes;
+    Container<unsigned int>             events;
+    Container<byte>                     eventTypes;
+    con_set<unsigned int, unsigned int> eventIndexes;
+
+    unsigned int AddString(const_str s);
+    unsigned int AddEvent(unsigned int eventnum);
+};
+
+/*
+============
+scriptCacheTables_t::AddString
+============
+*/
+unsigned int scriptCacheTables_t::AddString(const_str s)
+{
+    unsigned int *index;
+    unsigned int  newIndex;
+
+    if (s == STRING_NULL) {
+        return 0;
+    }
+
+    index = stringIndexes.findKeyValue(s);
+    if (index) {
+        return *index;
+    }
+
+    newIndex                    = strings.AddObject(s);
+    stringIndexes.addKeyValue(s) = newIndex;
+
+    return newIndex;
+}
+
+/*
+============
+scriptCacheTables_t::AddEvent
+
+Returns 0 if the event couldn't be found again from its name
+============
+*/
+unsigned int scriptCacheTables_t::AddEvent(unsigned int eventnum)
+{
+    unsigned int *index;
+    unsigned int  newIndex;
+    const char   *name;
+    byte          type;
+
+    index = eventIndexes.findKeyValue(eventnum);
+    if (index) {
+        return *index;
+    }
+
+    name = Event::GetEventName(eventnum);
+
+    if (Event::FindNormalEventNum(name) == eventnum) {
+        type = EV_NORMAL;
+    } else if (Event::FindReturnEventNum(name) == eventnum) {
+        type = EV_RETURN;
+    } else {
+        return 0;
+    }
+
+    newIndex = events.AddObject(eventnum);
+    eventTypes.AddObject(type);
+    eventIndexes.addKeyValue(eventnum) = newIndex;
+
+    return newIndex;
+}
+
+/*
+============
+ScriptCache_Hash
+
+FNV-1a hash of the data
+============
+*/
+static uint64_t ScriptCache_Hash(const void *data, size_t length)
+{
+    const byte *p    = (const byte *)data;
+    uint64_t    hash = 14695981039346656037ull;
+    size_t      i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+/*
+============
+ScriptCache_GetFileName
+============
+*/
+static str ScriptCache_GetFileName(const str& scriptName)
+{
+    str filename = "cache/" + scriptName;
+
+    filename.StripExtension();
+    filename += ".scc";
+
+    return filename;
+}
+
+/*
+============
+ScriptCache_GetOperand
+
+Returns the operand of the opcode that must be relocated
+============
+*/
+static scriptCacheOperand_e ScriptCache_GetOperand(unsigned char opcode, size_t& offset)
+{
+    switch (opcode) {
+    case OP_EXEC_CMD0:
+    case OP_EXEC_CMD1:
+    case OP_EXEC_CMD2:
+    case OP_EXEC_CMD3:
+    case OP_EXEC_CMD4:
+    case OP_EXEC_CMD5:
+    case OP_EXEC_CMD_METHOD0:
+    case OP_EXEC_CMD_METHOD1:
+    case OP_EXEC_CMD_METHOD2:
+    case OP_EXEC_CMD_METHOD3:
+    case OP_EXEC_CMD_METHOD4:
+    case OP_EXEC_CMD_METHOD5:
+    case OP_EXEC_METHOD0:
+    case OP_EXEC_METHOD1:
+    case OP_EXEC_METHOD2:
+    case OP_EXEC_METHOD3:
+    case OP_EXEC_METHOD4:
+    case OP_EXEC_METHOD5:
+        offset = 1;
+        return SCRIPTCACHE_OPERAND_EVENT;
+
+    case OP_EXEC_CMD_COUNT1:
+    case OP_EXEC_CMD_METHOD_COUNT1:
+    case OP_EXEC_METHOD_COUNT1:
+    case OP_EXEC_CMD_SELF_METHOD_COUNT1:
+        // The parameter count comes first
+        offset = 1 + sizeof(op_parmNum_t);
+        return SCRIPTCACHE_OPERAND_EVENT;
+
+    case OP_LOAD_FIELD_VAR:
+    case OP_LOAD_GAME_VAR:
+    case OP_LOAD_GROUP_VAR:
+    case OP_LOAD_LEVEL_VAR:
+    case OP_LOAD_LOCAL_VAR:
+    case OP_LOAD_OWNER_VAR:
+    case OP_LOAD_PARM_VAR:
+    case OP_LOAD_SELF_VAR:
+    case OP_LOAD_STORE_GAME_VAR:
+    case OP_LOAD_STORE_GROUP_VAR:
+    case OP_LOAD_STORE_LEVEL_VAR:
+    case OP_LOAD_STORE_LOCAL_VAR:
+    case OP_LOAD_STORE_OWNER_VAR:
+    case OP_LOAD_STORE_PARM_VAR:
+    case OP_LOAD_STORE_SELF_VAR:
+    case OP_STORE_FIELD:
+    case OP_STORE_FIELD_REF:
+    case OP_STORE_GAME_VAR:
+    case OP_STORE_GROUP_VAR:
+    case OP_STORE_LEVEL_VAR:
+    case OP_STORE_LOCAL_VAR:
+    case OP_STORE_OWNER_VAR:
+    case OP_STORE_PARM_VAR:
+    case OP_STORE_SELF_VAR:
+    case OP_STORE_STRING:
+    case OP_LOCAL_COMPARE_JUMP_FALSE4:
+        offset = 1;
+        return SCRIPTCACHE_OPERAND_STRING;
+
+    case OP_SWITCH:
+        offset = 1;
+        return SCRIPTCACHE_OPERAND_STATESCRIPT;
+
+    default:
+        offset = 0;
+        return SCRIPTCACHE_OPERAND_NONE;
+    }
+}
+
+/*
+============
+ScriptCache_WalkProgram
+
+Calls func for each operand that must be relocated.
+Returns false if the program can't be walked or if func fails
+============
+*/
+template<typename Func>
+static bool ScriptCache_WalkProgram(unsigned char *prog, size_t length, Func func)
+{
+    unsigned char       *pos;
+    unsigned char       *end = prog + length;
+    scriptCacheOperand_e type;
+    size_t               offset;
+    int                  opcodeLength;
+
+    // OP_DONE has no length in the opcode table, leave it out
+    if (end > prog && end[-1] == OP_DONE) {
+        end--;
+    }
+
+    for (pos = prog; pos < end; pos += opcodeLength) {
+        if (*pos >= OP_MAX) {
+            return false;
+        }
+
+        opcodeLength = OpcodeLength(*pos);
+        if (opcodeLength <= 0 || opcodeLength > end - pos) {
+            return false;
+        }
+
+        type = ScriptCache_GetOperand(*pos, offset);
+        if (type != SCRIPTCACHE_OPERAND_NONE && !func(type, pos + offset)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+============
+GameScript::CanUseCache
+============
+*/
+bool GameScript::CanUseCache(void) const
+{
+    if (!g_scriptcache->integer) {
+        return false;
+    }
+
+    // Scripts created from a string have no file to be cached with
+    if (m_Filename == STRING_NULL) {
+        return false;
+    }
+
+    // Tokens and opcodes are only printed while compiling
+    if (g_showtokens->integer || g_showopcodes->integer) {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+============
+GameScript::LoadCache
+
+Loads the compiled program from the cache, the source must be loaded.
+Returns false and leaves the script untouched if the cache can't be used
+============
+*/
+bool GameScript::LoadCache(void)
+{
+    scriptCacheHeader_t      header;
+    scriptCacheStateScript_t cacheStateScript;
+    scriptCacheLabel_t       cacheLabel;
+    scriptCacheSourceInfo_t  cacheSourceInfo;
+    Container<const_str>     strings;
+    Container<unsigned int>  events;
+    Container<StateScript *> switchStateScripts;
+    str                      filename;
+    byte                    *buffer;
+    const byte              *p;
+    const byte              *end;
+    const byte              *stateScriptData;
+    const byte              *labelData;
+    const byte              *sourceInfoData;
+    const byte              *progData;
+    unsigned char           *prog;
+    size_t                   fixedLength;
+    long                     length;
+    int                      numStateScripts;
+    int                      numLabels;
+    int                      i, j;
+    bool                     valid;
+
+    filename = ScriptCache_GetFileName(Filename());
+
+    length = gi.FS_ReadFile(filename.c_str(), (void **)&buffer, qtrue);
+    if (length <= 0 || !buffer) {
+        return false;
+    }
+
+    if ((size_t)length < sizeof(header)) {
+        gi.DPrintf("Script cache '%s' is truncated, recompiling.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    memcpy(&header, buffer, sizeof(header));
+
+    if (header.ident != SCRIPTCACHE_IDENT || header.version != SCRIPTCACHE_VERSION || header.numOpcodes != OP_MAX) {
+        gi.DPrintf("Script cache '%s' has an unsupported version, recompiling.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    if (header.numEventCommands != Event::NumEventCommands() || header.optimize != g_scriptoptimize->integer
+        || header.sourceLength != m_SourceLength
+        || header.sourceHash != ScriptCache_Hash(m_SourceBuffer, m_SourceLength)) {
+        gi.DPrintf("Script cache '%s' is out of date, recompiling.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    p   = buffer + sizeof(header);
+    end = buffer + length;
+
+    if (ScriptCache_Hash(p, end - p) != header.dataChecksum) {
+        gi.DPrintf("Script cache '%s' is corrupted, recompiling.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    //
+    // Fixed size sections
+    //
+
+    if (header.numSwitchStateScripts < 0 || header.numSwitchStateScripts > length || header.numCatchBlocks < 0
+        || header.numCatchBlocks > length || header.numLabels < 0 || header.numLabels > length
+        || header.numSourceInfos < 0 || header.numSourceInfos > length || header.numStrings < 0
+        || header.numStrings > length || header.numEvents < 0 || header.numEvents > length
+        || header.numInlineCaches < 0 || !header.progLength || header.progLength > (unsigned int)length) {
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    numStateScripts = 1 + header.numSwitchStateScripts + header.numCatchBlocks;
+    fixedLength     = sizeof(scriptCacheStateScript_t) * numStateScripts
+                + sizeof(scriptCacheLabel_t) * header.numLabels
+                + sizeof(scriptCacheSourceInfo_t) * header.numSourceInfos + header.progLength;
+
+    if ((size_t)(end - p) < fixedLength) {
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    stateScriptData = p;
+    labelData       = stateScriptData + sizeof(scriptCacheStateScript_t) * numStateScripts;
+    sourceInfoData  = labelData + sizeof(scriptCacheLabel_t) * header.numLabels;
+    progData        = sourceInfoData + sizeof(scriptCacheSourceInfo_t) * header.numSourceInfos;
+    p               = progData + header.progLength;
+
+    //
+    // String table
+    //
+
+    valid = true;
+    strings.Resize(header.numStrings);
+
+    for (i = 0; i < header.numStrings && valid; i++) {
+        const byte *terminator = (const byte *)memchr(p, 0, end - p);
+
+        if (!terminator) {
+            valid = false;
+            break;
+        }
+
+        strings.AddObject(Director.AddString((const char *)p));
+        p = terminator + 1;
+    }
+
+    //
+    // Event table, the events are searched by name in case they were renumbered
+    //
+
+    events.Resize(header.numEvents);
+
+    for (i = 0; i < header.numEvents && valid; i++) {
+        const byte  *terminator;
+        byte         type;
+        unsigned int eventnum;
+
+        if (end - p < 2) {
+            valid = false;
+            break;
+        }
+
+        type       = *p++;
+        terminator = (const byte *)memchr(p, 0, end - p);
+
+        if (!terminator) {
+            valid = false;
+            break;
+        }
+
+        if (type == EV_NORMAL) {
+            eventnum = Event::FindNormalEventNum((const char *)p);
+        } else if (type == EV_RETURN) {
+            eventnum = Event::FindReturnEventNum((const char *)p);
+        } else {
+            eventnum = 0;
+        }
+
+        if (!eventnum) {
+            valid = false;
+            break;
+        }
+
+        events.AddObject(eventnum);
+        p = terminator + 1;
+    }
+
+    if (p != end) {
+        valid = false;
+    }
+
+    //
+    // Check the labels and the source positions before creating anything
+    //
+
+    numLabels = 0;
+
+    for (i = 0; i < numStateScripts && valid; i++) {
+        memcpy(&cacheStateScript, stateScriptData + sizeof(cacheStateScript) * i, sizeof(cacheStateScript));
+
+        if (cacheStateScript.numLabels < 0 || cacheStateScript.numLabels > header.numLabels - numLabels
+            || cacheStateScript.tryStartCodePos > header.progLength
+            || cacheStateScript.tryEndCodePos > header.progLength) {
+            valid = false;
+            break;
+        }
+
+        numLabels += cacheStateScript.numLabels;
+    }
+
+    if (numLabels != header.numLabels) {
+        valid = false;
+    }
+
+    for (i = 0; i < header.numLabels && valid; i++) {
+        memcpy(&cacheLabel, labelData + sizeof(cacheLabel) * i, sizeof(cacheLabel));
+
+        if (cacheLabel.key > (unsigned int)header.numStrings || cacheLabel.name > (unsigned int)header.numStrings
+            || cacheLabel.codePos > header.progLength) {
+            valid = false;
+        }
+    }
+
+    for (i = 0; i < header.numSourceInfos && valid; i++) {
+        memcpy(&cacheSourceInfo, sourceInfoData + sizeof(cacheSourceInfo) * i, sizeof(cacheSourceInfo));
+
+        if (cacheSourceInfo.codePos >= header.progLength) {
+            valid = false;
+        }
+    }
+
+    if (!valid) {
+        gi.DPrintf("Couldn't load script cache '%s', recompiling.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    //
+    // Relocate the program
+    //
+
+    for (i = 0; i < header.numSwitchStateScripts; i++) {
+        switchStateScripts.AddObject(new StateScript);
+    }
+
+    prog = (unsigned char *)gi.Malloc(header.progLength);
+    memcpy(prog, progData, header.progLength);
+
+    valid = ScriptCache_WalkProgram(prog, header.progLength, [&](scriptCacheOperand_e type, unsigned char *operand) {
+        unsigned int index;
+        uintptr_t    stateScriptIndex;
+        StateScript *stateScript;
+
+        switch (type) {
+        case SCRIPTCACHE_OPERAND_STRING:
+            memcpy(&index, operand, sizeof(index));
+            if (index > (unsigned int)strings.NumObjects()) {
+                return false;
+            }
+
+            index = index ? strings.ObjectAt(index) : STRING_NULL;
+            memcpy(operand, &index, sizeof(index));
+            return true;
+
+        case SCRIPTCACHE_OPERAND_EVENT:
+            memcpy(&index, operand, sizeof(index));
+            if (!index || index > (unsigned int)events.NumObjects()) {
+                return false;
+            }
+
+            index = events.ObjectAt(index);
+            memcpy(operand, &index, sizeof(index));
+            return true;
+
+        case SCRIPTCACHE_OPERAND_STATESCRIPT:
+            memcpy(&stateScriptIndex, operand, sizeof(stateScriptIndex));
+            if (!stateScriptIndex || stateScriptIndex > (uintptr_t)switchStateScripts.NumObjects()) {
+                return false;
+            }
+
+            stateScript = switchStateScripts.ObjectAt(stateScriptIndex);
+            memcpy(operand, &stateScript, sizeof(stateScript));
+            return true;
+
+        default:
+            return false;
+        }
+    });
+
+    if (!valid) {
+        gi.DPrintf("Couldn't load script cache '%s', recompiling.\n", filename.c_str());
+
+        for (i = switchStateScripts.NumObjects(); i > 0; i--) {
+            delete switchStateScripts.ObjectAt(i);
+        }
+
+        gi.Free(prog);
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    //
+    // Everything is valid, fill the script
+    //
+
+    m_ProgBuffer = prog;
+    m_ProgLength = header.progLength;
+
+    for (i = 1; i <= switchStateScripts.NumObjects(); i++) {
+        m_StateScripts.AddObject(switchStateScripts.ObjectAt(i));
+    }
+
+    numLabels = 0;
+
+    for (i = 0; i < numStateScripts; i++) {
+        StateScript *stateScript;
+
+        memcpy(&cacheStateScript, stateScriptData + sizeof(cacheStateScript) * i, sizeof(cacheStateScript));
+
+        if (i == 0) {
+            stateScript = &m_State;
+        } else if (i <= header.numSwitchStateScripts) {
+            stateScript = switchStateScripts.ObjectAt(i);
+        } else {
+            stateScript = CreateCatchStateScript(
+                m_ProgBuffer + cacheStateScript.tryStartCodePos, m_ProgBuffer + cacheStateScript.tryEndCodePos
+            );
+        }
+
+        for (j = 0; j < cacheStateScript.numLabels; j++) {
+            memcpy(&cacheLabel, labelData + sizeof(cacheLabel) * numLabels, sizeof(cacheLabel));
+            numLabels++;
+
+            script_label_t& label = stateScript->label_list.addKeyValue(
+                cacheLabel.key ? strings.ObjectAt(cacheLabel.key) : STRING_NULL
+            );
+
+            label.codepos   = m_ProgBuffer + cacheLabel.codePos;
+            label.key       = cacheLabel.name ? strings.ObjectAt(cacheLabel.name) : STRING_NULL;
+            label.isprivate = cacheLabel.isPrivate != 0;
+        }
+    }
+
+    m_ProgToSource = new con_set<const uchar *, sourceinfo_t>;
+
+    for (i = 0; i < header.numSourceInfos; i++) {
+        memcpy(&cacheSourceInfo, sourceInfoData + sizeof(cacheSourceInfo) * i, sizeof(cacheSourceInfo));
+
+        sourceinfo_t& info = m_ProgToSource->addKeyValue(m_ProgBuffer + cacheSourceInfo.codePos);
+
+        info.sourcePos = cacheSourceInfo.sourcePos;
+        info.column    = cacheSourceInfo.column;
+        info.line      = cacheSourceInfo.line;
+    }
+
+    requiredStackSize = header.requiredStackSize;
+
+    m_NumInlineCaches = header.numInlineCaches;
+    if (m_NumInlineCaches) {
+        m_InlineCaches = new ScriptInlineCache[m_NumInlineCaches];
+    }
+
+    gi.FS_FreeFile(buffer);
+
+    return true;
+}
+
+/*
+============
+GameScript::SaveCache
+
+Writes the compiled program to the cache
+============
+*/
+void GameScript::SaveCache(void)
+{
+    scriptCacheHeader_t                 header;
+    scriptCacheTables_t                 tables;
+    Container<scriptCacheStateScript_t> stateScripts;
+    Container<scriptCacheLabel_t>       labels;
+    Container<scriptCacheSourceInfo_t>  sourceInfos;
+    str                                 filename;
+    unsigned char                      *prog;
+    byte                               *buffer;
+    byte                               *p;
+    size_t                              length;
+    size_t                              stringLength;
+    int                                 i;
+    bool                                valid;
+
+    if (!m_ProgBuffer || !m_ProgLength) {
+        return;
+    }
+
+    //
+    // Replace the operands by their index in the tables
+    //
+
+    prog = (unsigned char *)gi.Malloc(m_ProgLength);
+    memcpy(prog, m_ProgBuffer, m_ProgLength);
+
+    valid = ScriptCache_WalkProgram(prog, m_ProgLength, [&](scriptCacheOperand_e type, unsigned char *operand) {
+        unsigned int index;
+        uintptr_t    stateScriptIndex;
+        StateScript *stateScript;
+
+        switch (type) {
+        case SCRIPTCACHE_OPERAND_STRING:
+            memcpy(&index, operand, sizeof(index));
+            index = tables.AddString(index);
+            memcpy(operand, &index, sizeof(index));
+            return true;
+
+        case SCRIPTCACHE_OPERAND_EVENT:
+            memcpy(&index, operand, sizeof(index));
+            index = tables.AddEvent(index);
+            memcpy(operand, &index, sizeof(index));
+            return index != 0;
+
+        case SCRIPTCACHE_OPERAND_STATESCRIPT:
+            memcpy(&stateScript, operand, sizeof(stateScript));
+            stateScriptIndex = m_StateScripts.IndexOfObject(stateScript);
+            memcpy(operand, &stateScriptIndex, sizeof(stateScriptIndex));
+            return stateScriptIndex != 0;
+
+        default:
+            return false;
+        }
+    });
+
+    //
+    // Labels of the main state script, then the switch and catch blocks
+    //
+
+    auto addStateScript = [&](StateScript& stateScript, scriptCacheStateScript_t& cacheStateScript) {
+        con_set_enum<const_str, script_label_t>         en = stateScript.label_list;
+        con_set_enum<const_str, script_label_t>::Entry *entry;
+        scriptCacheLabel_t                              cacheLabel;
+
+        for (entry = en.NextElement(); entry; entry = en.NextElement()) {
+            if (entry->value.codepos < m_ProgBuffer || entry->value.codepos > m_ProgBuffer + m_ProgLength) {
+                valid = false;
+                continue;
+            }
+
+            cacheLabel.key       = tables.AddString(entry->GetKey());
+            cacheLabel.name      = tables.AddString(entry->value.key);
+            cacheLabel.codePos   = entry->value.codepos - m_ProgBuffer;
+            cacheLabel.isPrivate = entry->value.isprivate;
+
+            labels.AddObject(cacheLabel);
+            cacheStateScript.numLabels++;
+        }
+
+        stateScripts.AddObject(cacheStateScript);
+    };
+
+    if (valid) {
+        scriptCacheStateScript_t cacheStateScript;
+
+        memset(&cacheStateScript, 0, sizeof(cacheStateScript));
+        addStateScript(m_State, cacheStateScript);
+
+        for (i = 1; i <= m_StateScripts.NumObjects(); i++) {
+            memset(&cacheStateScript, 0, sizeof(cacheStateScript));
+            addStateScript(*m_StateScripts.ObjectAt(i), cacheStateScript);
+        }
+
+        for (i = 1; i <= m_CatchBlocks.NumObjects(); i++) {
+            CatchBlock *catchBlock = m_CatchBlocks.ObjectAt(i);
+
+            memset(&cacheStateScript, 0, sizeof(cacheStateScript));
+            cacheStateScript.tryStartCodePos = catchBlock->m_TryStartCodePos - m_ProgBuffer;
+            cacheStateScript.tryEndCodePos   = catchBlock->m_TryEndCodePos - m_ProgBuffer;
+            addStateScript(catchBlock->m_StateScript, cacheStateScript);
+        }
+    }
+
+    if (!valid) {
+        gi.DPrintf("Script '%s' can't be cached\n", Filename().c_str());
+        gi.Free(prog);
+        return;
+    }
+
+    if (m_ProgToSource) {
+        con_set_enum<const uchar *, sourceinfo_t>         en = *m_ProgToSource;
+        con_set_enum<const uchar *, sourceinfo_t>::Entry *entry;
+        scriptCacheSourceInfo_t                           cacheSourceInfo;
+
+        for (entry = en.NextElement(); entry; entry = en.NextElement()) {
+            // Opcodes removed by the optimizer may still have an entry
+            if (entry->GetKey() < m_ProgBuffer || entry->GetKey() >= m_ProgBuffer + m_ProgLength) {
+                continue;
+            }
+
+            cacheSourceInfo.codePos   = entry->GetKey() - m_ProgBuffer;
+            cacheSourceInfo.sourcePos = entry->value.sourcePos;
+            cacheSourceInfo.column    = entry->value.column;
+            cacheSourceInfo.line      = entry->value.line;
+
+            sourceInfos.AddObject(cacheSourceInfo);
+        }
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.ident                 = SCRIPTCACHE_IDENT;
+    header.version               = SCRIPTCACHE_VERSION;
+    header.numOpcodes            = OP_MAX;
+    header.numEventCommands      = Event::NumEventCommands();
+    header.optimize              = g_scriptoptimize->integer;
+    header.sourceLength          = m_SourceLength;
+    header.sourceHash            = ScriptCache_Hash(m_SourceBuffer, m_SourceLength);
+    header.progLength            = m_ProgLength;
+    header.requiredStackSize     = requiredStackSize;
+    header.numInlineCaches       = m_NumInlineCaches;
+    header.numSwitchStateScripts = m_StateScripts.NumObjects();
+    header.numCatchBlocks        = m_CatchBlocks.NumObjects();
+    header.numLabels             = labels.NumObjects();
+    header.numSourceInfos        = sourceInfos.NumObjects();
+    header.numStrings            = tables.strings.NumObjects();
+    header.numEvents             = tables.events.NumObjects();
+
+    length = sizeof(header) + sizeof(scriptCacheStateScript_t) * stateScripts.NumObjects()
+           + sizeof(scriptCacheLabel_t) * labels.NumObjects()
+           + sizeof(scriptCacheSourceInfo_t) * sourceInfos.NumObjects() + m_ProgLength;
+
+    for (i = 1; i <= tables.strings.NumObjects(); i++) {
+        length += Director.GetString(tables.strings.ObjectAt(i)).length() + 1;
+    }
+
+    for (i = 1; i <= tables.events.NumObjects(); i++) {
+        length += 1 + strlen(Event::GetEventName(tables.events.ObjectAt(i))) + 1;
+    }
+
+    buffer = (byte *)gi.Malloc(length);
+    p      = buffer + sizeof(header);
+
+    for (i = 1; i <= stateScripts.NumObjects(); i++) {
+        memcpy(p, &stateScripts.ObjectAt(i), sizeof(scriptCacheStateScript_t));
+        p += sizeof(scriptCacheStateScript_t);
+    }
+
+    for (i = 1; i <= labels.NumObjects(); i++) {
+        memcpy(p, &labels.ObjectAt(i), sizeof(scriptCacheLabel_t));
+        p += sizeof(scriptCacheLabel_t);
+    }
+
+    for (i = 1; i <= sourceInfos.NumObjects(); i++) {
+        memcpy(p, &sourceInfos.ObjectAt(i), sizeof(scriptCacheSourceInfo_t));
+        p += sizeof(scriptCacheSourceInfo_t);
+    }
+
+    memcpy(p, prog, m_ProgLength);
+    p += m_ProgLength;
+
+    for (i = 1; i <= tables.strings.NumObjects(); i++) {
+        const str& s = Director.GetString(tables.strings.ObjectAt(i));
+
+        stringLength = s.length() + 1;
+        memcpy(p, s.c_str(), stringLength);
+        p += stringLength;
+    }
+
+    for (i = 1; i <= tables.events.NumObjects(); i++) {
+        const char *name = Event::GetEventName(tables.events.ObjectAt(i));
+
+        *p++         = tables.eventTypes.ObjectAt(i);
+        stringLength = strlen(name) + 1;
+        memcpy(p, name, stringLength);
+        p += stringLength;
+    }
+
+    assert(p == buffer + length);
+
+    header.dataChecksum = ScriptCache_Hash(buffer + sizeof(header), length - sizeof(header));
+    memcpy(buffer, &header, sizeof(header));
+
+    filename = ScriptCache_GetFileName(Filename());
+    gi.FS_WriteFile(filename.c_str(), buffer, length);
+
+    gi.Free(buffer);
+    gi.Free(prog);
+}
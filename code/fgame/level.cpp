@@ -41,6 +41,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "scriptthread.h"
 #include "scriptvariable.h"
 #include "scriptexception.h"
+#include "entitygrid.h"
 
 #include <cfloat>
 
@@ -1032,6 +1033,8 @@ void Level::ResetEdicts(void)
 
     memset(g_entities, 0, game.maxentities * sizeof(g_entities[0]));
 
+    entityGrid.Clear();
+
     // Add all the edicts to the free list
     LL_Reset(&free_edicts, next, prev);
     LL_Reset(&active_edicts, next, prev);
@@ -1809,6 +1812,8 @@ gentity_t *Level::AllocEdict(Entity *entity)
 
     edict->entity = entity;
 
+    G_LinkEntityGrid(edict);
+
     return edict;
 }
 
@@ -1825,6 +1830,8 @@ void Level::FreeEdict(gentity_t *ed)
 
     LL_Remove(ed, next, prev);
 
+    entityGrid.Unlink(ed - g_entities);
+
     client = ed->client;
 
     memset(ed, 0, sizeof(*ed));
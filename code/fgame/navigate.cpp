@@ -33,7 +33,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "scriptexception.h"
 #include "gamecmds.h"
 
-#define PATHFILE_VERSION 103
+#define PATHFILE_VERSION 105
 
 int     path_checkthisframe;
 cvar_t *ai_showroutes;
@@ -64,7 +64,7 @@ static qboolean pathnodescalculated  = false;
 int             ai_maxnode;
 
 MapCell   PathSearch::PathMap[PATHMAP_GRIDSIZE][PATHMAP_GRIDSIZE];
-PathNode *PathSearch::open;
+PathSearch::OpenSet PathSearch::open;
 int       PathSearch::findFrame;
 qboolean  PathSearch::m_bNodesloaded;
 qboolean  PathSearch::m_NodeCheckFailed;
@@ -315,8 +315,6 @@ int PathSearch::FindPath(
     int        g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev;
-    PathNode  *next;
     int        f;
     vec2_t     delta;
     PathNode  *to;
@@ -351,7 +349,7 @@ int PathSearch::FindPath(
     }
 
     findFrame++;
-    open = NULL;
+    open.Clear();
 
     VectorSub2D(Node->origin, start, path_startdir);
     Node->g = VectorNormalize2D(path_startdir);
@@ -362,21 +360,12 @@ int PathSearch::FindPath(
     Node->Parent    = NULL;
     Node->m_Depth   = 3;
     Node->findCount = findFrame;
-    Node->inopen    = true;
-    Node->PrevNode  = NULL;
-    Node->NextNode  = NULL;
     Node->m_PathPos = start;
 
-    open = Node;
+    open.Push(Node);
 
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
-
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (!open.IsEmpty()) {
+        Node = open.Pop();
 
         if (Node == to) {
             path_start = start;
@@ -409,19 +398,7 @@ int PathSearch::FindPath(
                 }
 
                 if (NewNode->inopen) {
-                    NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    open.Remove(NewNode);
                 }
             }
 
@@ -445,38 +422,8 @@ int PathSearch::FindPath(
                 NewNode->f         = (float)f;
                 NewNode->m_PathPos = pathway->pos2;
                 NewNode->findCount = findFrame;
-                NewNode->inopen    = true;
-
-                if (!open) {
-                    NewNode->NextNode = NULL;
-                    NewNode->PrevNode = NULL;
-                    open              = NewNode;
-                    continue;
-                }
-
-                if (open->f >= f) {
-                    NewNode->NextNode = open;
-                    NewNode->PrevNode = NULL;
 
-                    open->PrevNode = NewNode;
-                    open           = NewNode;
-                    continue;
-                }
-
-                prev = open;
-                for (next = open->NextNode; next; next = next->NextNode) {
-                    if (next->f >= f) {
-                        break;
-                    }
-                    prev = next;
-                }
-
-                NewNode->NextNode = next;
-                if (next) {
-                    next->PrevNode = NewNode;
-                }
-                prev->NextNode    = NewNode;
-                NewNode->PrevNode = prev;
+                open.Push(NewNode);
             }
         }
     }
@@ -500,8 +447,6 @@ int PathSearch::FindPathNear(
     int        g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev;
-    PathNode  *next;
     int        f;
     vec2_t     dir;
     vec2_t     delta;
@@ -530,32 +475,23 @@ int PathSearch::FindPathNear(
     }
 
     findFrame++;
-    open = NULL;
+    open.Clear();
 
     VectorSub2D(Node->origin, start, path_startdir);
     VectorSub2D(end, start, delta);
     VectorCopy2D(delta, dir);
 
-    Node->inopen    = true;
     Node->g         = VectorNormalize2D(path_startdir);
     Node->h         = VectorNormalize2D(dir);
     Node->Parent    = NULL;
     Node->m_Depth   = 3;
     Node->findCount = findFrame;
-    Node->PrevNode  = NULL;
-    Node->NextNode  = NULL;
     Node->m_PathPos = start;
 
-    open = Node;
+    open.Push(Node);
 
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
-
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (!open.IsEmpty()) {
+        Node = open.Pop();
 
         VectorSub2D(end, Node->m_PathPos, delta);
 
@@ -581,19 +517,7 @@ int PathSearch::FindPathNear(
                 }
 
                 if (NewNode->inopen) {
-                    NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    open.Remove(NewNode);
                 }
             }
 
@@ -617,38 +541,8 @@ int PathSearch::FindPathNear(
                 NewNode->f         = (float)f;
                 NewNode->m_PathPos = pathway->pos2;
                 NewNode->findCount = findFrame;
-                NewNode->inopen    = true;
-
-                if (!open) {
-                    NewNode->NextNode = NULL;
-                    NewNode->PrevNode = NULL;
-                    open              = NewNode;
-                    continue;
-                }
-
-                if (open->f >= f) {
-                    NewNode->NextNode = open;
-                    NewNode->PrevNode = NULL;
 
-                    open->PrevNode = NewNode;
-                    open           = NewNode;
-                    continue;
-                }
-
-                prev = open;
-                for (next = open->NextNode; next; next = next->NextNode) {
-                    if (next->f >= f) {
-                        break;
-                    }
-                    prev = next;
-                }
-
-                NewNode->NextNode = next;
-                if (next) {
-                    next->PrevNode = NewNode;
-                }
-                prev->NextNode    = NewNode;
-                NewNode->PrevNode = prev;
+                open.Push(NewNode);
             }
         }
     }
@@ -672,8 +566,6 @@ int PathSearch::FindPathAway(
     int        g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev;
-    PathNode  *next;
     int        f;
     float      fBias;
     vec2_t     delta;
@@ -699,34 +591,25 @@ int PathSearch::FindPathAway(
     }
 
     findFrame++;
-    open = NULL;
+    open.Clear();
 
     VectorSub2D(Node->origin, start, path_startdir);
     VectorSub2D(start, avoid, delta);
 
     fBias = VectorLength2D(vPreferredDir);
 
-    Node->inopen = true;
     Node->g      = VectorNormalize2D(path_startdir);
     Node->h      = fMinSafeDist - VectorNormalize2D(delta);
     Node->h += fBias - DotProduct2D(vPreferredDir, delta);
     Node->Parent    = NULL;
     Node->m_Depth   = 2;
     Node->findCount = findFrame;
-    Node->PrevNode  = NULL;
-    Node->NextNode  = NULL;
     Node->m_PathPos = start;
 
-    open = Node;
+    open.Push(Node);
 
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
-
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (!open.IsEmpty()) {
+        Node = open.Pop();
 
         VectorSub2D(Node->m_PathPos, avoid, delta);
 
@@ -760,19 +643,7 @@ int PathSearch::FindPathAway(
                 }
 
                 if (NewNode->inopen) {
-                    NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    open.Remove(NewNode);
                 }
             }
 
@@ -790,38 +661,8 @@ int PathSearch::FindPathAway(
                 NewNode->f         = (float)f;
                 NewNode->m_PathPos = pathway->pos2;
                 NewNode->findCount = findFrame;
-                NewNode->inopen    = true;
-
-                if (!open) {
-                    NewNode->NextNode = NULL;
-                    NewNode->PrevNode = NULL;
-                    open              = NewNode;
-                    continue;
-                }
 
-                if (open->f >= f) {
-                    NewNode->NextNode = open;
-                    NewNode->PrevNode = NULL;
-
-                    open->PrevNode = NewNode;
-                    open           = NewNode;
-                    continue;
-                }
-
-                prev = open;
-                for (next = open->NextNode; next; next = next->NextNode) {
-                    if (next->f >= f) {
-                        break;
-                    }
-                    prev = next;
-                }
-
-                NewNode->NextNode = next;
-                if (next) {
-                    next->PrevNode = NewNode;
-                }
-                prev->NextNode    = NewNode;
-                NewNode->PrevNode = prev;
+                open.Push(NewNode);
             }
         }
     }
@@ -837,7 +678,6 @@ PathNode *PathSearch::FindCornerNodeForWall(
     int        i, g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev, *next;
     int        f;
     vec2_t     delta;
     vec2_t     dir;
@@ -876,31 +716,22 @@ PathNode *PathSearch::FindCornerNodeForWall(
     }
 
     findFrame++;
-    open = NULL;
+    open.Clear();
 
     VectorSub2D(Node->origin, start, path_startdir);
     Node->g = VectorNormalize2D(path_startdir);
 
     VectorSub2D(end, start, path_totaldir);
     Node->h         = VectorNormalize2D(path_totaldir);
-    Node->inopen    = true;
     Node->Parent    = NULL;
     Node->m_Depth   = 3;
     Node->findCount = findFrame;
-    Node->PrevNode  = 0;
-    Node->NextNode  = 0;
     Node->m_PathPos = start;
 
-    open = Node;
+    open.Push(Node);
 
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
-
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (!open.IsEmpty()) {
+        Node = open.Pop();
 
         if (Node->Parent && DotProduct(Node->m_PathPos, plane) - plane[3] < 0) {
             VectorSub2D(Node->m_PathPos, start, delta);
@@ -927,19 +758,7 @@ PathNode *PathSearch::FindCornerNodeForWall(
                 }
 
                 if (NewNode->inopen) {
-                    NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    open.Remove(NewNode);
                 }
             }
 
@@ -960,38 +779,8 @@ PathNode *PathSearch::FindCornerNodeForWall(
             NewNode->f         = (float)f;
             NewNode->m_PathPos = pathway->pos2;
             NewNode->findCount = findFrame;
-            NewNode->inopen    = true;
 
-            if (!open) {
-                NewNode->NextNode = NULL;
-                NewNode->PrevNode = NULL;
-                open              = NewNode;
-                continue;
-            }
-
-            if (open->f >= f) {
-                NewNode->NextNode = open;
-                NewNode->PrevNode = NULL;
-
-                open->PrevNode = NewNode;
-                open           = NewNode;
-                continue;
-            }
-
-            prev = open;
-            for (next = open->NextNode; next; next = next->NextNode) {
-                if (next->f >= f) {
-                    break;
-                }
-                prev = next;
-            }
-
-            NewNode->NextNode = next;
-            if (next) {
-                next->PrevNode = NewNode;
-            }
-            prev->NextNode    = NewNode;
-            NewNode->PrevNode = prev;
+            open.Push(NewNode);
         }
     }
 
@@ -1313,6 +1102,9 @@ PathNode::PathNode()
 {
     entflags |= ECF_PATHNODE;
     findCount      = 0;
+    inopen         = false;
+    heapIndex      = -1;
+    heapOrder      = 0;
     pLastClaimer   = NULL;
     numChildren    = 0;
     iAvailableTime = -1;
@@ -1810,7 +1602,7 @@ CLASS_DECLARATION(Class, PathSearch, NULL) {
 PathSearch::PathSearch()
 {
     memset(pathnodes, 0, sizeof(pathnodes));
-    open      = 0;
+    open.Clear();
     findFrame = 0;
 }
 
@@ -2234,6 +2026,13 @@ qboolean PathSearch::ArchiveSaveNodes(void)
     maptime = gi.MapTime();
     arc.ArchiveString(&maptime);
 
+    tempInt = G_GetMapChecksum();
+    arc.ArchiveInteger(&tempInt);
+
+    // Added in OPM
+    //  checksum of the node data, so a damaged file is never loaded
+    arc.ArchiveChecksum();
+
     arc.ArchiveInteger(&m_NodeCheckFailed);
     ArchiveStaticSave(arc);
     arc.Close();
@@ -2249,6 +2048,7 @@ void PathSearch::ArchiveLoadNodes(void)
     if (arc.Read(level.m_pathfile, false)) {
         int file_version;
         str maptime;
+        int checksum;
 
         // get file values
         arc.ArchiveInteger(&file_version);
@@ -2259,7 +2059,19 @@ void PathSearch::ArchiveLoadNodes(void)
         }
 
         arc.ArchiveString(&maptime);
-        if (gi.MapTime() == maptime && gi.FS_FileNewer(level.m_mapfile.c_str(), level.m_pathfile.c_str()) <= 0) {
+        arc.ArchiveInteger(&checksum);
+
+        // The BSP checksum identifies the map and its path nodes,
+        // so the file date doesn't matter anymore
+        if (gi.MapTime() == maptime && checksum == G_GetMapChecksum()) {
+            // Added in OPM
+            //  the node counts are used to allocate memory, make sure
+            //  the data is intact before reading any of it
+            if (!arc.ArchiveChecksum()) {
+                gi.Printf("Path file is damaged, rebuilding.\n");
+                return;
+            }
+
             arc.ArchiveInteger(&m_NodeCheckFailed);
 
             if (!g_nodecheck->integer || !m_NodeCheckFailed) {
@@ -2996,12 +2808,10 @@ void PathNode::CheckPathToDefault(PathNode *node, pathway_t *pathway)
         return;
     }
 
+    // CreatePaths has already dropped both nodes to the floor
     start = origin;
     end   = node->origin;
 
-    droptofloor(start, this);
-    droptofloor(end, node);
-
     if (CheckMove(start, end, &pathway->fallheight, 15.5f)) {
         pathway->dist = dist;
         VectorCopy2D(delta, pathway->dir);
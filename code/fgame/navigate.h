@@ -35,6 +35,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "doors.h"
 #include "sentient.h"
 #include "../qcommon/qfiles.h"
+#include "pathnodeheap.h"
 
 extern Event EV_AI_SavePaths;
 extern Event EV_AI_SaveNodes;
@@ -161,8 +162,8 @@ public:
     float           g;
     class PathNode *Parent;
     bool            inopen;
-    PathNode       *PrevNode;
-    PathNode       *NextNode;
+    int             heapIndex;
+    int             heapOrder;
     short int       pathway;
     const vec_t    *m_PathPos;
     float           dist;
@@ -244,12 +245,14 @@ class PathSearch : public Listener
     friend class PathNode;
 
 private:
-    static MapCell   PathMap[PATHMAP_GRIDSIZE][PATHMAP_GRIDSIZE];
-    static PathNode *open;
-    static int       findFrame;
-    static qboolean  m_bNodesloaded;
-    static qboolean  m_NodeCheckFailed;
-    static int       m_LoadIndex;
+    typedef PathNodeHeap<PathNode, MAX_PATHNODES> OpenSet;
+
+    static MapCell  PathMap[PATHMAP_GRIDSIZE][PATHMAP_GRIDSIZE];
+    static OpenSet  open;
+    static int      findFrame;
+    static qboolean m_bNodesloaded;
+    static qboolean m_NodeCheckFailed;
+    static int      m_LoadIndex;
 
 public:
     static PathNode   *pathnodes[MAX_PATHNODES];
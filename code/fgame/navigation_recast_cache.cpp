@@ -0,0 +1,426 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+/**
+ * @file navigation_recast_cache.cpp
+ * @brief Save and load the generated navigation mesh.
+ *
+ * Building the navigation mesh takes a few seconds on big maps,
+ * so the Detour tiles are written to a cache file next to the map
+ * and reused as long as the map and the configuration are the same.
+ * The tile cache layers and the off-mesh connections are stored as well,
+ * so tiles can still be rebuilt around obstacles.
+ */
+
+#include "g_local.h"
+#include "navigation_recast_load.h"
+#include "navigation_recast_config.h"
+#include "navigation_recast_tilecache.h"
+#include "navigate.h"
+
+#include "DetourNavMesh.h"
+#include "DetourNavMeshQuery.h"
+#include "DetourAlloc.h"
+
+static constexpr int NAVCACHE_IDENT   = (('C' << 24) + ('V' << 16) + ('A' << 8) + 'N');
+static constexpr int NAVCACHE_VERSION = 3;
+
+/**
+ * @brief Configuration values used to build the mesh.
+ * The cache is rebuilt if any of them change.
+ */
+struct navCacheConfig_t {
+    float recastCellSize;
+    float recastCellHeight;
+    float agentHeight;
+    float agentMaxClimb;
+    float agentMaxSlope;
+    float agentRadius;
+    int   regionMinSize;
+    int   regionMergeSize;
+    float edgeMaxLen;
+    float edgeMaxError;
+    int   vertsPerPoly;
+    float detailSampleDist;
+    float detailSampleMaxError;
+    int   tileSize;
+    int   maxObstacles;
+};
+
+struct navCacheHeader_t {
+    int              ident;
+    int              version;
+    char             mapname[MAX_QPATH];
+    int              mapChecksum;
+    navCacheConfig_t config;
+    dtNavMeshParams  params;
+    int              numTiles;
+    int              tileCacheMaxTiles;
+    int              numLayers;
+    int              numOffMeshConnections;
+    // checksum of everything after the header
+    unsigned int     dataChecksum;
+};
+
+struct navCacheTile_t {
+    dtTileRef tileRef;
+    int       dataSize;
+};
+
+struct navCacheLayer_t {
+    int dataSize;
+};
+
+/*
+============
+NavCache_GetConfig
+============
+*/
+static void NavCache_GetConfig(navCacheConfig_t& navConfig)
+{
+    memset(&navConfig, 0, sizeof(navConfig));
+
+    navConfig.recastCellSize       = NavigationMapConfiguration::recastCellSize;
+    navConfig.recastCellHeight     = NavigationMapConfiguration::recastCellHeight;
+    navConfig.agentHeight          = NavigationMapConfiguration::agentHeight;
+    navConfig.agentMaxClimb        = NavigationMapConfiguration::agentMaxClimb;
+    navConfig.agentMaxSlope        = NavigationMapConfiguration::agentMaxSlope;
+    navConfig.agentRadius          = NavigationMapConfiguration::agentRadius;
+    navConfig.regionMinSize        = NavigationMapConfiguration::regionMinSize;
+    navConfig.regionMergeSize      = NavigationMapConfiguration::regionMergeSize;
+    navConfig.edgeMaxLen           = NavigationMapConfiguration::edgeMaxLen;
+    navConfig.edgeMaxError         = NavigationMapConfiguration::edgeMaxError;
+    navConfig.vertsPerPoly         = NavigationMapConfiguration::vertsPerPoly;
+    navConfig.detailSampleDist     = NavigationMapConfiguration::detailSampleDist;
+    navConfig.detailSampleMaxError = NavigationMapConfiguration::detailSampleMaxError;
+    navConfig.tileSize             = NavigationMapConfiguration::tileSize;
+    navConfig.maxObstacles         = NavigationMapConfiguration::maxObstacles;
+}
+
+/*
+============
+NavCache_Checksum
+
+FNV-1a hash of the data
+============
+*/
+static unsigned int NavCache_Checksum(const byte *data, size_t length)
+{
+    unsigned int hash = 2166136261u;
+    size_t       i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*
+============
+NavCache_GetFileName
+============
+*/
+static str NavCache_GetFileName(const char *mapname)
+{
+    str filename = mapname;
+
+    filename.StripExtension();
+    filename += ".nav";
+
+    return filename;
+}
+
+/*
+============
+NavigationMap::LoadCachedNavMesh
+============
+*/
+bool NavigationMap::LoadCachedNavMesh(const char *mapname)
+{
+    navCacheHeader_t header;
+    navCacheConfig_t navConfig;
+    str              filename;
+    byte            *buffer;
+    const byte      *p;
+    const byte      *end;
+    long             length;
+    dtStatus         status;
+    int              i;
+
+    filename = NavCache_GetFileName(mapname);
+
+    length = gi.FS_ReadFile(filename.c_str(), (void **)&buffer, qtrue);
+    if (length <= 0 || !buffer) {
+        return false;
+    }
+
+    if ((size_t)length < sizeof(header)) {
+        gi.Printf("Navigation cache '%s' is truncated, rebuilding.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    memcpy(&header, buffer, sizeof(header));
+    NavCache_GetConfig(navConfig);
+
+    if (header.ident != NAVCACHE_IDENT || header.version != NAVCACHE_VERSION) {
+        gi.Printf("Navigation cache '%s' has an unsupported version, rebuilding.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    if (Q_stricmp(header.mapname, mapname) || header.mapChecksum != G_GetMapChecksum()
+        || memcmp(&header.config, &navConfig, sizeof(navConfig))) {
+        gi.Printf("Navigation cache '%s' is out of date, rebuilding.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    p   = buffer + sizeof(header);
+    end = buffer + length;
+
+    if (NavCache_Checksum(p, end - p) != header.dataChecksum) {
+        gi.Printf("Navigation cache '%s' is corrupted, rebuilding.\n", filename.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    navMeshDt = dtAllocNavMesh();
+    status    = navMeshDt->init(&header.params);
+
+    for (i = 0; i < header.numTiles && dtStatusSucceed(status); i++) {
+        navCacheTile_t tileHeader;
+        unsigned char *data;
+
+        if (end - p < (ptrdiff_t)sizeof(tileHeader)) {
+            status = DT_FAILURE;
+            break;
+        }
+
+        memcpy(&tileHeader, p, sizeof(tileHeader));
+        p += sizeof(tileHeader);
+
+        if (tileHeader.dataSize <= 0 || end - p < tileHeader.dataSize) {
+            status = DT_FAILURE;
+            break;
+        }
+
+        // Detour needs its own aligned copy of the data
+        data = (unsigned char *)dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM);
+        memcpy(data, p, tileHeader.dataSize);
+        p += tileHeader.dataSize;
+
+        status = navMeshDt->addTile(data, tileHeader.dataSize, DT_TILE_FREE_DATA, tileHeader.tileRef, NULL);
+        if (dtStatusFailed(status)) {
+            dtFree(data);
+        }
+    }
+
+    //
+    // Tile cache layers
+    //
+
+    if (dtStatusSucceed(status) && !InitializeTileCache(header.tileCacheMaxTiles)) {
+        status = DT_FAILURE;
+    }
+
+    for (i = 0; i < header.numLayers && dtStatusSucceed(status); i++) {
+        navCacheLayer_t layerHeader;
+        unsigned char  *data;
+
+        if (end - p < (ptrdiff_t)sizeof(layerHeader)) {
+            status = DT_FAILURE;
+            break;
+        }
+
+        memcpy(&layerHeader, p, sizeof(layerHeader));
+        p += sizeof(layerHeader);
+
+        if (layerHeader.dataSize <= 0 || end - p < layerHeader.dataSize) {
+            status = DT_FAILURE;
+            break;
+        }
+
+        data = (unsigned char *)dtAlloc(layerHeader.dataSize, DT_ALLOC_PERM);
+        memcpy(data, p, layerHeader.dataSize);
+        p += layerHeader.dataSize;
+
+        status = tileCache->addTile(data, layerHeader.dataSize, DT_COMPRESSEDTILE_FREE_DATA, NULL);
+        if (dtStatusFailed(status)) {
+            dtFree(data);
+        }
+    }
+
+    //
+    // Off-mesh connections, for tiles rebuilt by the tile cache
+    //
+
+    if (dtStatusSucceed(status)) {
+        if (header.numOffMeshConnections < 0
+            || end - p != (ptrdiff_t)(sizeof(navOffMeshConnection_t) * header.numOffMeshConnections)) {
+            status = DT_FAILURE;
+        } else {
+            tileCacheMeshProcess->SetOffMeshConnections(
+                (const navOffMeshConnection_t *)p, header.numOffMeshConnections
+            );
+        }
+    }
+
+    gi.FS_FreeFile(buffer);
+
+    if (dtStatusSucceed(status)) {
+        navMeshQuery = dtAllocNavMeshQuery();
+        status       = navMeshQuery->init(navMeshDt, MAX_PATHNODES);
+    }
+
+    if (dtStatusFailed(status)) {
+        gi.Printf("Couldn't load navigation cache '%s', rebuilding.\n", filename.c_str());
+
+        if (navMeshQuery) {
+            dtFreeNavMeshQuery(navMeshQuery);
+            navMeshQuery = NULL;
+        }
+
+        dtFreeNavMesh(navMeshDt);
+        navMeshDt = NULL;
+
+        ClearTileCache();
+        return false;
+    }
+
+    return true;
+}
+
+/*
+============
+NavigationMap::SaveCachedNavMesh
+============
+*/
+void NavigationMap::SaveCachedNavMesh(const char *mapname) const
+{
+    const dtNavMesh *navMesh = navMeshDt;
+    navCacheHeader_t header;
+    str              filename;
+    byte            *buffer;
+    byte            *p;
+    size_t           length;
+    int              i;
+
+    if (!navMesh) {
+        return;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.ident   = NAVCACHE_IDENT;
+    header.version = NAVCACHE_VERSION;
+    Q_strncpyz(header.mapname, mapname, sizeof(header.mapname));
+    header.mapChecksum = G_GetMapChecksum();
+    NavCache_GetConfig(header.config);
+    memcpy(&header.params, navMesh->getParams(), sizeof(header.params));
+
+    length = sizeof(header);
+
+    for (i = 0; i < navMesh->getMaxTiles(); i++) {
+        const dtMeshTile *tile = navMesh->getTile(i);
+        if (!tile || !tile->header || !tile->dataSize) {
+            continue;
+        }
+
+        header.numTiles++;
+        length += sizeof(navCacheTile_t) + tile->dataSize;
+    }
+
+    if (tileCache) {
+        header.tileCacheMaxTiles = tileCache->getParams()->maxTiles;
+
+        for (i = 0; i < tileCache->getTileCount(); i++) {
+            const dtCompressedTile *tile = tileCache->getTile(i);
+            if (!tile->header || !tile->dataSize) {
+                continue;
+            }
+
+            header.numLayers++;
+            length += sizeof(navCacheLayer_t) + tile->dataSize;
+        }
+
+        header.numOffMeshConnections = tileCacheMeshProcess->GetNumOffMeshConnections();
+        length += sizeof(navOffMeshConnection_t) * header.numOffMeshConnections;
+    }
+
+    buffer = (byte *)gi.Malloc(length);
+    p      = buffer + sizeof(header);
+
+    for (i = 0; i < navMesh->getMaxTiles(); i++) {
+        const dtMeshTile *tile = navMesh->getTile(i);
+        navCacheTile_t    tileHeader;
+
+        if (!tile || !tile->header || !tile->dataSize) {
+            continue;
+        }
+
+        tileHeader.tileRef  = navMesh->getTileRef(tile);
+        tileHeader.dataSize = tile->dataSize;
+
+        memcpy(p, &tileHeader, sizeof(tileHeader));
+        p += sizeof(tileHeader);
+        memcpy(p, tile->data, tile->dataSize);
+        p += tile->dataSize;
+    }
+
+    if (tileCache) {
+        for (i = 0; i < tileCache->getTileCount(); i++) {
+            const dtCompressedTile *tile = tileCache->getTile(i);
+            navCacheLayer_t         layerHeader;
+
+            if (!tile->header || !tile->dataSize) {
+                continue;
+            }
+
+            layerHeader.dataSize = tile->dataSize;
+
+            memcpy(p, &layerHeader, sizeof(layerHeader));
+            p += sizeof(layerHeader);
+            memcpy(p, tile->data, tile->dataSize);
+            p += tile->dataSize;
+        }
+
+        if (header.numOffMeshConnections) {
+            memcpy(
+                p,
+                tileCacheMeshProcess->GetOffMeshConnections(),
+                sizeof(navOffMeshConnection_t) * header.numOffMeshConnections
+            );
+            p += sizeof(navOffMeshConnection_t) * header.numOffMeshConnections;
+        }
+    }
+
+    header.dataChecksum = NavCache_Checksum(buffer + sizeof(header), length - sizeof(header));
+    memcpy(buffer, &header, sizeof(header));
+
+    filename = NavCache_GetFileName(mapname);
+    gi.FS_WriteFile(filename.c_str(), buffer, length);
+    gi.Free(buffer);
+
+    gi.DPrintf("Saved navigation cache to '%s'\n", filename.c_str());
+}
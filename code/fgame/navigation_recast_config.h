@@ -47,6 +47,12 @@ namespace NavigationMapConfiguration
     static const int   vertsPerPoly         = 6;
     static const float detailSampleDist     = 12.0;
     static const float detailSampleMaxError = 1.3f;
+
+    // Number of cells on each side of a tile
+    static const int tileSize = 128;
+
+    // Number of obstacles that can be carved into the tile cache at once
+    static const int maxObstacles = 512;
 } // namespace NavigationMapConfiguration
 
 // Polyflags
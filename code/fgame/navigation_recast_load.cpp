@@ -35,31 +35,175 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "navigation_recast_config.h"
 #include "navigation_recast_helpers.h"
 #include "navigation_recast_debug.h"
+#include "navigation_recast_tilecache.h"
 #include "../script/scriptexception.h"
 #include "navigate.h"
 #include "debuglines.h"
 #include "level.h"
 
 #include "Recast.h"
+#include "DetourCommon.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshBuilder.h"
 #include "DetourNavMeshQuery.h"
 #include "DetourNode.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 NavigationMap navigationMap;
 
 /// Recast build context.
 class RecastBuildContext : public rcContext
 {
+public:
+    /// @param deferLogs Keep messages until FlushLog() is called,
+    /// for contexts used outside of the main thread.
+    RecastBuildContext(bool deferLogs = false)
+        : deferLog(deferLogs)
+    {}
+
+    void FlushLog()
+    {
+        if (deferredLog.length()) {
+            gi.DPrintf("%s", deferredLog.c_str());
+            deferredLog = "";
+        }
+    }
+
 protected:
     virtual void doResetLog() override {}
 
     virtual void doLog(const rcLogCategory category, const char *msg, const int len) override
     {
+        if (deferLog) {
+            // va() is not thread-safe
+            char buffer[1024];
+
+            Com_sprintf(buffer, sizeof(buffer), "Recast (category %d): %s\n", (int)category, msg);
+            deferredLog += buffer;
+            return;
+        }
+
         gi.DPrintf("Recast (category %d): %s\n", (int)category, msg);
     }
+
+private:
+    bool deferLog;
+    str  deferredLog;
+};
+
+/// World tile built by a worker thread.
+struct RecastTile {
+    int             tileX;
+    int             tileY;
+    float           bmin[3];
+    float           bmax[3];
+    int            *indexes;
+    int             numIndexes;
+    rcPolyMesh     *polyMesh;
+    unsigned char **layers;
+    int            *layerSizes;
+    int             numLayers;
+};
+
+/// Tile cache layer, turned into navigation mesh data by a worker thread.
+struct RecastLayerTile {
+    const dtCompressedTile *compressedTile;
+    unsigned char          *navData;
+    int                     navDataSize;
 };
 
+/*
+============
+FreeRecastTiles
+============
+*/
+static void FreeRecastTiles(RecastTile *tiles, int numTiles)
+{
+    int i, j;
+
+    for (i = 0; i < numTiles; i++) {
+        RecastTile& tile = tiles[i];
+
+        for (j = 0; j < tile.numLayers; j++) {
+            if (tile.layers[j]) {
+                dtFree(tile.layers[j]);
+            }
+        }
+
+        if (tile.polyMesh) {
+            rcFreePolyMesh(tile.polyMesh);
+        }
+
+        delete[] tile.layerSizes;
+        delete[] tile.layers;
+        delete[] tile.indexes;
+    }
+
+    delete[] tiles;
+}
+
+/*
+============
+RunRecastWorkers
+
+Call work(index, context) for each item, spread across worker threads.
+Recast only works on the data it's given so items can be built concurrently
+============
+*/
+template<typename Func>
+static int RunRecastWorkers(int numItems, const Func& work)
+{
+    std::atomic<int>    nextItem(0);
+    RecastBuildContext *contexts;
+    std::thread        *threads;
+    int                 numThreads;
+    int                 i;
+
+    numThreads = Q_min((int)std::thread::hardware_concurrency(), numItems);
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+
+    contexts = new RecastBuildContext[numThreads];
+    threads  = new std::thread[numThreads];
+
+    auto worker = [&](RecastBuildContext *context) {
+        int itemNum;
+
+        while ((itemNum = nextItem++) < numItems) {
+            work(itemNum, *context);
+        }
+    };
+
+    for (i = 0; i < numThreads; i++) {
+        contexts[i] = RecastBuildContext(true);
+    }
+
+    if (numThreads > 1) {
+        for (i = 0; i < numThreads; i++) {
+            threads[i] = std::thread(worker, &contexts[i]);
+        }
+
+        for (i = 0; i < numThreads; i++) {
+            threads[i].join();
+        }
+    } else {
+        worker(&contexts[0]);
+    }
+
+    for (i = 0; i < numThreads; i++) {
+        contexts[i].FlushLog();
+    }
+
+    delete[] threads;
+    delete[] contexts;
+
+    return numThreads;
+}
+
 /*
 ============
 NavigationMap::GatherOffMeshPoints
@@ -84,18 +228,24 @@ void NavigationMap::GatherOffMeshPoints(Container<offMeshNavigationPoint>& point
 NavigationMap::InitializeNavMesh
 ============
 */
-void NavigationMap::InitializeNavMesh(RecastBuildContext& buildContext, const navMap_t& navMap)
+void NavigationMap::InitializeNavMesh(RecastBuildContext& buildContext, int maxTiles)
 {
     dtNavMeshParams params;
     dtStatus        status;
+    int             tileBits;
 
     params.orig[0]    = MIN_MAP_BOUNDS;
     params.orig[1]    = MIN_MAP_BOUNDS;
     params.orig[2]    = MIN_MAP_BOUNDS;
-    params.tileWidth  = MAP_SIZE * NavigationMapConfiguration::recastCellSize;
-    params.tileHeight = MAP_SIZE * NavigationMapConfiguration::recastCellSize;
-    params.maxTiles   = 32;
-    params.maxPolys   = 32768;
+    params.tileWidth  = NavigationMapConfiguration::tileSize * NavigationMapConfiguration::recastCellSize;
+    params.tileHeight = NavigationMapConfiguration::tileSize * NavigationMapConfiguration::recastCellSize;
+
+    //
+    // Polygon references have 22 bits for the tile and the polygon numbers
+    //
+    tileBits        = Q_min((int)dtIlog2(dtNextPow2(Q_max(maxTiles, 1))), 14);
+    params.maxTiles = 1 << tileBits;
+    params.maxPolys = 1 << (22 - tileBits);
 
     navMeshDt = dtAllocNavMesh();
     status    = navMeshDt->init(&params);
@@ -117,6 +267,76 @@ void NavigationMap::InitializeNavMesh(RecastBuildContext& buildContext, const na
     }
 }
 
+/*
+============
+NavigationMap::InitializeTileCache
+============
+*/
+bool NavigationMap::InitializeTileCache(int maxTiles)
+{
+    dtTileCacheParams params;
+    dtStatus          status;
+
+    memset(&params, 0, sizeof(params));
+    params.orig[0]                = MIN_MAP_BOUNDS;
+    params.orig[1]                = MIN_MAP_BOUNDS;
+    params.orig[2]                = MIN_MAP_BOUNDS;
+    params.cs                     = NavigationMapConfiguration::recastCellSize;
+    params.ch                     = NavigationMapConfiguration::recastCellHeight;
+    params.width                  = NavigationMapConfiguration::tileSize;
+    params.height                 = NavigationMapConfiguration::tileSize;
+    params.walkableHeight         = NavigationMapConfiguration::agentHeight;
+    params.walkableRadius         = NavigationMapConfiguration::agentRadius;
+    params.walkableClimb          = NavigationMapConfiguration::agentMaxClimb;
+    params.maxSimplificationError = NavigationMapConfiguration::edgeMaxError;
+    params.maxTiles               = dtNextPow2(Q_max(maxTiles, 1));
+    params.maxObstacles           = NavigationMapConfiguration::maxObstacles;
+
+    tileCacheAlloc       = new dtTileCacheAlloc();
+    tileCacheCompressor  = new NavigationTileCacheCompressor();
+    tileCacheMeshProcess = new NavigationTileCacheMeshProcess();
+
+    tileCache = dtAllocTileCache();
+    status    = tileCache->init(&params, tileCacheAlloc, tileCacheCompressor, tileCacheMeshProcess);
+
+    if (dtStatusFailed(status)) {
+        gi.Printf("Failed to initialize the navigation tile cache\n");
+        return false;
+    }
+
+    return true;
+}
+
+/*
+============
+NavigationMap::ClearTileCache
+============
+*/
+void NavigationMap::ClearTileCache()
+{
+    if (tileCache) {
+        dtFreeTileCache(tileCache);
+        tileCache = NULL;
+    }
+
+    if (tileCacheMeshProcess) {
+        delete tileCacheMeshProcess;
+        tileCacheMeshProcess = NULL;
+    }
+
+    if (tileCacheCompressor) {
+        delete tileCacheCompressor;
+        tileCacheCompressor = NULL;
+    }
+
+    if (tileCacheAlloc) {
+        delete tileCacheAlloc;
+        tileCacheAlloc = NULL;
+    }
+
+    pendingTileUpdates = false;
+}
+
 /*
 ============
 NavigationMap::InitializeFilter
@@ -181,16 +401,17 @@ void NavigationMap::BuildDetourData(
     RecastBuildContext&                      buildContext,
     rcPolyMesh                              *polyMesh,
     rcPolyMeshDetail                        *polyMeshDetail,
-    int                                      index,
-    const Container<offMeshNavigationPoint>& points
+    int                                      tileX,
+    int                                      tileY,
+    int                                      index
 )
 {
     unsigned char *navData     = NULL;
     int            navDataSize = 0;
     dtStatus       status;
 
-    if (polyMesh->npolys < 2) {
-        // Useless mesh
+    if (!polyMesh->npolys) {
+        // Empty tile
         return;
     }
 
@@ -215,75 +436,48 @@ void NavigationMap::BuildDetourData(
     rcVcopy(dtParams.bmax, polyMesh->bmax);
     dtParams.cs          = NavigationMapConfiguration::recastCellSize;
     dtParams.ch          = NavigationMapConfiguration::recastCellHeight;
-    dtParams.tileX       = 0;
-    dtParams.tileY       = 0;
+    dtParams.tileX       = tileX;
+    dtParams.tileY       = tileY;
     dtParams.tileLayer   = index;
     dtParams.buildBvTree = true;
 
-    if (points.NumObjects()) {
-        dtParams.offMeshConCount = offMeshConCount = points.NumObjects();
-
-        offMeshConVerts  = new float[6 * dtParams.offMeshConCount];
-        offMeshConRad    = new float[dtParams.offMeshConCount];
-        offMeshConFlags  = new unsigned short[dtParams.offMeshConCount];
-        offMeshConAreas  = new unsigned char[dtParams.offMeshConCount];
-        offMeshConDir    = new unsigned char[dtParams.offMeshConCount];
-        offMeshConUserID = new unsigned int[dtParams.offMeshConCount];
-
-        for (int i = 0; i < dtParams.offMeshConCount; i++) {
-            const offMeshNavigationPoint& point = points.ObjectAt(i + 1);
-
-            ConvertGameToRecastCoord(point.start, &offMeshConVerts[i * 6]);
-            ConvertGameToRecastCoord(point.end, &offMeshConVerts[i * 6 + 3]);
-
-            offMeshConRad[i]    = point.radius;
-            offMeshConFlags[i]  = point.flags;
-            offMeshConAreas[i]  = point.area;
-            offMeshConDir[i]    = point.bidirectional ? DT_OFFMESH_CON_BIDIR : 0;
-            offMeshConUserID[i] = i;
-        }
-
-        dtParams.offMeshConVerts  = offMeshConVerts;
-        dtParams.offMeshConRad    = offMeshConRad;
-        dtParams.offMeshConFlags  = offMeshConFlags;
-        dtParams.offMeshConAreas  = offMeshConAreas;
-        dtParams.offMeshConDir    = offMeshConDir;
-        dtParams.offMeshConUserID = offMeshConUserID;
+    if (tileCacheMeshProcess) {
+        tileCacheMeshProcess->ApplyOffMeshConnections(&dtParams);
     }
 
-    dtCreateNavMeshData(&dtParams, &navData, &navDataSize);
+    if (!dtCreateNavMeshData(&dtParams, &navData, &navDataSize)) {
+        navData = NULL;
+    }
 
-    if (points.NumObjects()) {
-        delete[] offMeshConVerts;
-        delete[] offMeshConRad;
-        delete[] offMeshConFlags;
-        delete[] offMeshConAreas;
-        delete[] offMeshConDir;
-        delete[] offMeshConUserID;
+    if (!navData) {
+        buildContext.log(RC_LOG_ERROR, "Failed to create data for tile %d,%d", tileX, tileY);
+        return;
     }
 
     status = navMeshDt->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, NULL);
     if (!dtStatusSucceed(status)) {
+        dtFree(navData);
         buildContext.log(RC_LOG_ERROR, "Failed to create tile for navigation mesh");
     }
 }
 
 /*
 ============
-NavigationMap::GeneratePolyMesh
+NavigationMap::RasterizeGeometry
+
+Rasterize the triangles into a compact heightfield of walkable surfaces
 ============
 */
-void NavigationMap::GeneratePolyMesh(
+rcCompactHeightfield *NavigationMap::RasterizeGeometry(
     RecastBuildContext& buildContext,
-    float              *vertsBuffer,
+    const float        *vertsBuffer,
     int                 numVertices,
-    int                *indexesBuffer,
+    const int          *indexesBuffer,
     int                 numIndexes,
-    rcPolyMesh       *&       outPolyMesh,
-    rcPolyMeshDetail *& outPolyMeshDetail
+    const float        *minBounds,
+    const float        *maxBounds
 )
 {
-    Vector             minBounds, maxBounds;
     int                gridSizeX, gridSizeZ;
     const unsigned int walkableHeight =
         (int)ceilf(NavigationMapConfiguration::agentHeight / NavigationMapConfiguration::recastCellHeight);
@@ -291,14 +485,11 @@ void NavigationMap::GeneratePolyMesh(
         (int)floorf(NavigationMapConfiguration::agentMaxClimb / NavigationMapConfiguration::recastCellHeight);
     const unsigned int walkableRadius =
         (int)ceilf(NavigationMapConfiguration::agentRadius / NavigationMapConfiguration::recastCellSize);
-    const unsigned int maxEdgeLen =
-        (int)(NavigationMapConfiguration::edgeMaxLen / NavigationMapConfiguration::recastCellSize);
     const unsigned int numTris = numIndexes / 3;
 
     //
     // Calculate the grid size
     //
-    rcCalcBounds(vertsBuffer, numVertices, minBounds, maxBounds);
     rcCalcGridSize(minBounds, maxBounds, NavigationMapConfiguration::recastCellSize, &gridSizeX, &gridSizeZ);
 
     rcHeightfield *heightfield = rcAllocHeightfield();
@@ -356,16 +547,98 @@ void NavigationMap::GeneratePolyMesh(
 
     rcErodeWalkableArea(&buildContext, walkableRadius, *compactedHeightfield);
 
-    rcBuildDistanceField(&buildContext, *compactedHeightfield);
+    return compactedHeightfield;
+}
+
+/*
+============
+NavigationMap::BuildTileLayers
+
+Store the heightfield layers of the tile in the tile cache format
+============
+*/
+void NavigationMap::BuildTileLayers(
+    RecastBuildContext& buildContext, const rcCompactHeightfield& compactedHeightfield, int borderSize, RecastTile& tile
+)
+{
+    const unsigned int walkableHeight =
+        (int)ceilf(NavigationMapConfiguration::agentHeight / NavigationMapConfiguration::recastCellHeight);
+    NavigationTileCacheCompressor compressor;
+    rcHeightfieldLayerSet        *layerSet;
+    dtStatus                      status;
+    int                           i;
+
+    layerSet = rcAllocHeightfieldLayerSet();
+
+    if (!rcBuildHeightfieldLayers(&buildContext, compactedHeightfield, borderSize, walkableHeight, *layerSet)) {
+        buildContext.log(RC_LOG_ERROR, "Failed to build layers for tile %d,%d", tile.tileX, tile.tileY);
+        rcFreeHeightfieldLayerSet(layerSet);
+        return;
+    }
+
+    tile.layers     = new unsigned char *[layerSet->nlayers];
+    tile.layerSizes = new int[layerSet->nlayers];
+    tile.numLayers  = 0;
+
+    for (i = 0; i < layerSet->nlayers; i++) {
+        const rcHeightfieldLayer *layer = &layerSet->layers[i];
+        dtTileCacheLayerHeader    header;
+        unsigned char            *data;
+        int                       dataSize;
+
+        header.magic   = DT_TILECACHE_MAGIC;
+        header.version = DT_TILECACHE_VERSION;
+        header.tx      = tile.tileX;
+        header.ty      = tile.tileY;
+        header.tlayer  = i;
+        rcVcopy(header.bmin, layer->bmin);
+        rcVcopy(header.bmax, layer->bmax);
+        header.width  = (unsigned char)layer->width;
+        header.height = (unsigned char)layer->height;
+        header.minx   = (unsigned char)layer->minx;
+        header.maxx   = (unsigned char)layer->maxx;
+        header.miny   = (unsigned char)layer->miny;
+        header.maxy   = (unsigned char)layer->maxy;
+        header.hmin   = (unsigned short)layer->hmin;
+        header.hmax   = (unsigned short)layer->hmax;
+
+        status =
+            dtBuildTileCacheLayer(&compressor, &header, layer->heights, layer->areas, layer->cons, &data, &dataSize);
+        if (dtStatusFailed(status)) {
+            buildContext.log(RC_LOG_ERROR, "Failed to build layer %d for tile %d,%d", i, tile.tileX, tile.tileY);
+            continue;
+        }
+
+        tile.layers[tile.numLayers]     = data;
+        tile.layerSizes[tile.numLayers] = dataSize;
+        tile.numLayers++;
+    }
+
+    rcFreeHeightfieldLayerSet(layerSet);
+}
+
+/*
+============
+NavigationMap::GeneratePolyMesh
+============
+*/
+rcPolyMesh *NavigationMap::GeneratePolyMesh(
+    RecastBuildContext& buildContext, rcCompactHeightfield& compactedHeightfield, int borderSize
+)
+{
+    const unsigned int maxEdgeLen =
+        (int)(NavigationMapConfiguration::edgeMaxLen / NavigationMapConfiguration::recastCellSize);
+
+    rcBuildDistanceField(&buildContext, compactedHeightfield);
     rcBuildRegions(
         &buildContext,
-        *compactedHeightfield,
-        0,
+        compactedHeightfield,
+        borderSize,
         Square(NavigationMapConfiguration::regionMinSize),
         Square(NavigationMapConfiguration::regionMergeSize)
     );
 
-    //rcBuildRegionsMonotone(&buildContext, *compactedHeightfield, 0, Square(NavigationMapConfiguration::regionMinSize), Square(NavigationMapConfiguration::regionMergeSize));
+    //rcBuildRegionsMonotone(&buildContext, compactedHeightfield, 0, Square(NavigationMapConfiguration::regionMinSize), Square(NavigationMapConfiguration::regionMergeSize));
 
     //
     // Simplify region contours
@@ -374,7 +647,7 @@ void NavigationMap::GeneratePolyMesh(
     rcContourSet *contourSet = rcAllocContourSet();
 
     rcBuildContours(
-        &buildContext, *compactedHeightfield, NavigationMapConfiguration::edgeMaxError, maxEdgeLen, *contourSet
+        &buildContext, compactedHeightfield, NavigationMapConfiguration::edgeMaxError, maxEdgeLen, *contourSet
     );
 
     //
@@ -385,47 +658,59 @@ void NavigationMap::GeneratePolyMesh(
 
     rcBuildPolyMesh(&buildContext, *contourSet, NavigationMapConfiguration::vertsPerPoly, *polyMesh);
 
-    //
-    // Create detail mesh to access approximate height for each polygon
-    //
+    rcFreeContourSet(contourSet);
+
+    return polyMesh;
+}
 
+/*
+============
+NavigationMap::GeneratePolyMeshDetail
+
+Create detail mesh to access approximate height for each polygon
+============
+*/
+rcPolyMeshDetail *NavigationMap::GeneratePolyMeshDetail(
+    RecastBuildContext& buildContext, const rcPolyMesh& polyMesh, const rcCompactHeightfield& compactedHeightfield
+)
+{
     rcPolyMeshDetail *polyMeshDetail = rcAllocPolyMeshDetail();
 
     rcBuildPolyMeshDetail(
         &buildContext,
-        *polyMesh,
-        *compactedHeightfield,
+        polyMesh,
+        compactedHeightfield,
         NavigationMapConfiguration::recastCellSize * NavigationMapConfiguration::detailSampleDist,
         NavigationMapConfiguration::detailSampleMaxError,
         *polyMeshDetail
     );
 
-    rcFreeCompactHeightfield(compactedHeightfield);
-    rcFreeContourSet(contourSet);
-
-    outPolyMesh       = polyMesh;
-    outPolyMeshDetail = polyMeshDetail;
+    return polyMeshDetail;
 }
 
 /*
 ============
-NavigationMap::BuildRecastMesh
+NavigationMap::BuildModelGeometry
+
+Convert the model surfaces into Recast vertices and triangles
 ============
 */
-void NavigationMap::BuildRecastMesh(
-    RecastBuildContext& buildContext,
-    const navModel_t&   model,
-    const Vector&       origin,
-    const Vector&       angles,
-    rcPolyMesh       *&       outPolyMesh,
-    rcPolyMeshDetail *& outPolyMeshDetail
+void NavigationMap::BuildModelGeometry(
+    const navModel_t& model,
+    const Vector&     origin,
+    const Vector&     angles,
+    float           *&vertsBuffer,
+    int&              numVertices,
+    int             *&indexesBuffer,
+    int&              numIndexes
 )
 {
-    int numIndexes  = 0;
-    int numVertices = 0;
     int baseVertice, baseIndice;
     int i, j;
 
+    numIndexes  = 0;
+    numVertices = 0;
+
     for (i = 1; i <= model.surfaces.NumObjects(); i++) {
         const navSurface_t& surface = model.surfaces.ObjectAt(i);
 
@@ -436,7 +721,7 @@ void NavigationMap::BuildRecastMesh(
     //
     // Recreate the vertice buffer so it's compatible
     // with Recast's right-handed Y-up coordinate system
-    float *vertsBuffer = new float[numVertices * 3];
+    vertsBuffer = new float[numVertices * 3];
 
     baseIndice  = 0;
     baseVertice = 0;
@@ -478,7 +763,7 @@ void NavigationMap::BuildRecastMesh(
     baseIndice  = 0;
     baseVertice = 0;
 
-    int *indexesBuffer = new int[numIndexes];
+    indexesBuffer = new int[numIndexes];
     for (i = 1; i <= model.surfaces.NumObjects(); i++) {
         const navSurface_t& surface = model.surfaces.ObjectAt(i);
 
@@ -493,28 +778,205 @@ void NavigationMap::BuildRecastMesh(
         baseIndice += surface.indices.NumObjects();
         baseVertice += surface.vertices.NumObjects();
     }
+}
+
+/*
+============
+NavigationMap::BuildRecastMesh
+============
+*/
+void NavigationMap::BuildRecastMesh(
+    RecastBuildContext& buildContext,
+    const navModel_t&   model,
+    const Vector&       origin,
+    const Vector&       angles,
+    rcPolyMesh       *&       outPolyMesh,
+    rcPolyMeshDetail *& outPolyMeshDetail
+)
+{
+    float                *vertsBuffer;
+    int                   numVertices;
+    int                  *indexesBuffer;
+    int                   numIndexes;
+    float                 minBounds[3], maxBounds[3];
+    rcCompactHeightfield *compactedHeightfield;
+    rcPolyMesh           *polyMesh;
+    rcPolyMeshDetail     *polyMeshDetail;
+
+    BuildModelGeometry(model, origin, angles, vertsBuffer, numVertices, indexesBuffer, numIndexes);
 
     //
     // Generate the mesh
     //
 
-    rcPolyMesh       *polyMesh;
-    rcPolyMeshDetail *polyMeshDetail;
+    rcCalcBounds(vertsBuffer, numVertices, minBounds, maxBounds);
+
+    compactedHeightfield =
+        RasterizeGeometry(buildContext, vertsBuffer, numVertices, indexesBuffer, numIndexes, minBounds, maxBounds);
+
+    delete[] indexesBuffer;
+    delete[] vertsBuffer;
+
+    polyMesh       = GeneratePolyMesh(buildContext, *compactedHeightfield, 0);
+    polyMeshDetail = GeneratePolyMeshDetail(buildContext, *polyMesh, *compactedHeightfield);
+
+    rcFreeCompactHeightfield(compactedHeightfield);
+
+    SetPolyFlags(polyMesh);
+
+    outPolyMesh       = polyMesh;
+    outPolyMeshDetail = polyMeshDetail;
+}
+
+/*
+============
+NavigationMap::SetPolyFlags
 
-    GeneratePolyMesh(buildContext, vertsBuffer, numVertices, indexesBuffer, numIndexes, polyMesh, polyMeshDetail);
+Update poly flags from areas
+============
+*/
+void NavigationMap::SetPolyFlags(rcPolyMesh *polyMesh)
+{
+    int i;
 
-    // Update poly flags from areas.
-    for (int i = 0; i < polyMesh->npolys; ++i) {
+    for (i = 0; i < polyMesh->npolys; ++i) {
         if (polyMesh->areas[i] == RC_WALKABLE_AREA) {
             polyMesh->flags[i] = RECAST_POLYFLAG_WALKABLE;
         }
     }
+}
 
-    delete[] indexesBuffer;
-    delete[] vertsBuffer;
+/*
+============
+NavigationMap::BuildTiles
 
-    outPolyMesh       = polyMesh;
-    outPolyMeshDetail = polyMeshDetail;
+Rasterize each tile and build its layers and its poly mesh.
+The poly meshes are only used by navigation extensions
+============
+*/
+void NavigationMap::BuildTiles(
+    const float *vertsBuffer, int numVertices, RecastTile *tiles, int numTiles, int borderSize
+)
+{
+    int numThreads;
+
+    numThreads = RunRecastWorkers(numTiles, [&](int tileNum, RecastBuildContext& context) {
+        RecastTile&           tile = tiles[tileNum];
+        rcCompactHeightfield *compactedHeightfield;
+        float                 minBounds[3], maxBounds[3];
+
+        if (!tile.numIndexes) {
+            return;
+        }
+
+        rcVcopy(minBounds, tile.bmin);
+        rcVcopy(maxBounds, tile.bmax);
+        minBounds[0] -= borderSize * NavigationMapConfiguration::recastCellSize;
+        minBounds[2] -= borderSize * NavigationMapConfiguration::recastCellSize;
+        maxBounds[0] += borderSize * NavigationMapConfiguration::recastCellSize;
+        maxBounds[2] += borderSize * NavigationMapConfiguration::recastCellSize;
+
+        compactedHeightfield = RasterizeGeometry(
+            context, vertsBuffer, numVertices, tile.indexes, tile.numIndexes, minBounds, maxBounds
+        );
+
+        BuildTileLayers(context, *compactedHeightfield, borderSize, tile);
+        tile.polyMesh = GeneratePolyMesh(context, *compactedHeightfield, borderSize);
+
+        rcFreeCompactHeightfield(compactedHeightfield);
+    });
+
+    gi.Printf("  %d tiles built using %d thread(s)\n", numTiles, numThreads);
+}
+
+/*
+============
+NavigationMap::BuildLayerTiles
+
+Create the navigation mesh data of each tile cache layer
+============
+*/
+void NavigationMap::BuildLayerTiles(RecastLayerTile *layerTiles, int numLayerTiles)
+{
+    const dtTileCacheParams *params          = tileCache->getParams();
+    const int                walkableClimbVx = (int)(params->walkableClimb / params->ch);
+
+    RunRecastWorkers(numLayerTiles, [&](int layerNum, RecastBuildContext& context) {
+        RecastLayerTile&              layerTile = layerTiles[layerNum];
+        const dtCompressedTile       *tile      = layerTile.compressedTile;
+        NavigationTileCacheCompressor compressor;
+        dtTileCacheAlloc              alloc;
+        dtTileCacheLayer             *layer    = NULL;
+        dtTileCacheContourSet        *contours = NULL;
+        dtTileCachePolyMesh          *polyMesh = NULL;
+        dtNavMeshCreateParams         dtParams;
+        dtStatus                      status;
+
+        layerTile.navData     = NULL;
+        layerTile.navDataSize = 0;
+
+        // Same as dtTileCache::buildNavMeshTile without obstacles
+        status = dtDecompressTileCacheLayer(&alloc, &compressor, tile->data, tile->dataSize, &layer);
+        if (dtStatusSucceed(status)) {
+            status = dtBuildTileCacheRegions(&alloc, *layer, walkableClimbVx);
+        }
+
+        if (dtStatusSucceed(status)) {
+            contours = dtAllocTileCacheContourSet(&alloc);
+            status   = dtBuildTileCacheContours(
+                &alloc, *layer, walkableClimbVx, params->maxSimplificationError, *contours
+            );
+        }
+
+        if (dtStatusSucceed(status)) {
+            polyMesh = dtAllocTileCachePolyMesh(&alloc);
+            status   = dtBuildTileCachePolyMesh(&alloc, *contours, *polyMesh);
+        }
+
+        if (dtStatusSucceed(status) && polyMesh->npolys) {
+            memset(&dtParams, 0, sizeof(dtParams));
+            dtParams.verts          = polyMesh->verts;
+            dtParams.vertCount      = polyMesh->nverts;
+            dtParams.polys          = polyMesh->polys;
+            dtParams.polyAreas      = polyMesh->areas;
+            dtParams.polyFlags      = polyMesh->flags;
+            dtParams.polyCount      = polyMesh->npolys;
+            dtParams.nvp            = DT_VERTS_PER_POLYGON;
+            dtParams.walkableHeight = params->walkableHeight;
+            dtParams.walkableRadius = params->walkableRadius;
+            dtParams.walkableClimb  = params->walkableClimb;
+            dtParams.tileX          = tile->header->tx;
+            dtParams.tileY          = tile->header->ty;
+            dtParams.tileLayer      = tile->header->tlayer;
+            dtParams.cs             = params->cs;
+            dtParams.ch             = params->ch;
+            dtParams.buildBvTree    = false;
+            rcVcopy(dtParams.bmin, tile->header->bmin);
+            rcVcopy(dtParams.bmax, tile->header->bmax);
+
+            tileCacheMeshProcess->process(&dtParams, polyMesh->areas, polyMesh->flags);
+
+            if (!dtCreateNavMeshData(&dtParams, &layerTile.navData, &layerTile.navDataSize)) {
+                context.log(
+                    RC_LOG_ERROR,
+                    "Failed to create data for layer %d of tile %d,%d",
+                    tile->header->tlayer,
+                    tile->header->tx,
+                    tile->header->ty
+                );
+            }
+        }
+
+        if (polyMesh) {
+            dtFreeTileCachePolyMesh(&alloc, polyMesh);
+        }
+        if (contours) {
+            dtFreeTileCacheContourSet(&alloc, contours);
+        }
+        if (layer) {
+            dtFreeTileCacheLayer(&alloc, layer);
+        }
+    });
 }
 
 /*
@@ -539,6 +1001,12 @@ NavigationMap::NavigationMap()
     : navMeshDt(NULL)
     , navMeshQuery(NULL)
     , queryFilter(NULL)
+    , tileCache(NULL)
+    , tileCacheAlloc(NULL)
+    , tileCacheCompressor(NULL)
+    , tileCacheMeshProcess(NULL)
+    , pendingTileUpdates(false)
+    , revision(0)
 {
     validNavigation = false;
 }
@@ -593,12 +1061,116 @@ const navMap_t& NavigationMap::GetNavigationData() const
     return navigationData.navMap;
 }
 
+/*
+============
+NavigationMap::GetTileCache
+============
+*/
+dtTileCache *NavigationMap::GetTileCache() const
+{
+    return tileCache;
+}
+
+/*
+============
+NavigationMap::GetRevision
+============
+*/
+unsigned int NavigationMap::GetRevision() const
+{
+    return revision;
+}
+
+/*
+============
+NavigationMap::AddObstacle
+============
+*/
+unsigned int NavigationMap::AddObstacle(const Vector& mins, const Vector& maxs)
+{
+    dtObstacleRef ref;
+    Vector        rcMins, rcMaxs;
+    float         bmin[3], bmax[3];
+
+    if (!tileCache) {
+        return 0;
+    }
+
+    ConvertGameToRecastCoord(mins, rcMins);
+    ConvertGameToRecastCoord(maxs, rcMaxs);
+
+    bmin[0] = Q_min(rcMins[0], rcMaxs[0]);
+    bmin[1] = Q_min(rcMins[1], rcMaxs[1]);
+    bmin[2] = Q_min(rcMins[2], rcMaxs[2]);
+    bmax[0] = Q_max(rcMins[0], rcMaxs[0]);
+    bmax[1] = Q_max(rcMins[1], rcMaxs[1]);
+    bmax[2] = Q_max(rcMins[2], rcMaxs[2]);
+
+    // Also block the ground below, where an agent would collide with it
+    bmin[1] -= NavigationMapConfiguration::agentHeight;
+
+    if (dtStatusFailed(tileCache->addBoxObstacle(bmin, bmax, &ref))) {
+        // Too many requests at once, or no more obstacles available
+        return 0;
+    }
+
+    pendingTileUpdates = true;
+
+    return ref;
+}
+
+/*
+============
+NavigationMap::RemoveObstacle
+============
+*/
+bool NavigationMap::RemoveObstacle(unsigned int obstacleRef)
+{
+    if (!tileCache) {
+        return true;
+    }
+
+    if (dtStatusFailed(tileCache->removeObstacle(obstacleRef))) {
+        return false;
+    }
+
+    pendingTileUpdates = true;
+
+    return true;
+}
+
 /*
 ============
 NavigationMap::Update
+
+Rebuild the tiles affected by obstacles, within the time allowed for each frame
 ============
 */
-void NavigationMap::Update() {}
+void NavigationMap::Update()
+{
+    std::chrono::steady_clock::time_point start;
+    bool                                  upToDate;
+    float                                 elapsed;
+
+    if (!pendingTileUpdates || !tileCache || !navMeshDt) {
+        return;
+    }
+
+    start = std::chrono::steady_clock::now();
+
+    do {
+        if (dtStatusFailed(tileCache->update(level.frametime, navMeshDt, &upToDate))) {
+            gi.DPrintf("Failed to rebuild a navigation tile\n");
+        }
+
+        // Paths going through rebuilt tiles have to be checked again
+        revision++;
+
+        elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } while (!upToDate && elapsed < g_navigation_updatetime->value);
+
+    pendingTileUpdates = !upToDate;
+}
 
 /*
 ============
@@ -629,6 +1201,7 @@ void NavigationMap::ClearNavigation()
         queryFilter = NULL;
     }
 
+    ClearTileCache();
     ClearExtensions();
 }
 
@@ -644,22 +1217,245 @@ NavigationMap::BuildWorldMesh
 */
 void NavigationMap::BuildWorldMesh(RecastBuildContext& buildContext, const navMap_t& navigationMap)
 {
-    rcPolyMesh       *polyMesh;
-    rcPolyMeshDetail *polyMeshDetail;
+    const float tileWorldSize = NavigationMapConfiguration::tileSize * NavigationMapConfiguration::recastCellSize;
+    const int   borderSize =
+        (int)ceilf(NavigationMapConfiguration::agentRadius / NavigationMapConfiguration::recastCellSize) + 3;
+    const float      borderWidth  = borderSize * NavigationMapConfiguration::recastCellSize;
+    const int        tilesPerSide = (int)ceilf(MAP_SIZE / tileWorldSize);
+    float           *vertsBuffer;
+    int              numVertices;
+    int             *indexesBuffer;
+    int              numIndexes;
+    float            minBounds[3], maxBounds[3];
+    int              minTileX, minTileY, maxTileX, maxTileY;
+    int              tileWidth, numTiles;
+    int              numLayerTiles;
+    RecastTile      *tiles;
+    RecastLayerTile *layerTiles;
+    rcPolyMesh      *mergedMesh;
+    dtStatus         status;
+    int              i, j, x, y;
+
+    BuildModelGeometry(
+        navigationMap.GetWorldMap(), vec_origin, vec_zero, vertsBuffer, numVertices, indexesBuffer, numIndexes
+    );
+
+    if (!numIndexes) {
+        delete[] indexesBuffer;
+        delete[] vertsBuffer;
+
+        InitializeNavMesh(buildContext, 1);
+        InitializeTileCache(1);
+        return;
+    }
 
-    BuildRecastMesh(buildContext, navigationMap.GetWorldMap(), vec_origin, vec_zero, polyMesh, polyMeshDetail);
+    rcCalcBounds(vertsBuffer, numVertices, minBounds, maxBounds);
 
     //
-    // Create detour data
+    // Split the world into tiles, aligned on the navigation mesh tiles
+    //
+
+    minTileX = Q_clamp_int((int)floorf((minBounds[0] - MIN_MAP_BOUNDS) / tileWorldSize), 0, tilesPerSide - 1);
+    minTileY = Q_clamp_int((int)floorf((minBounds[2] - MIN_MAP_BOUNDS) / tileWorldSize), 0, tilesPerSide - 1);
+    maxTileX = Q_clamp_int((int)floorf((maxBounds[0] - MIN_MAP_BOUNDS) / tileWorldSize), 0, tilesPerSide - 1);
+    maxTileY = Q_clamp_int((int)floorf((maxBounds[2] - MIN_MAP_BOUNDS) / tileWorldSize), 0, tilesPerSide - 1);
+
+    tileWidth = maxTileX - minTileX + 1;
+    numTiles  = tileWidth * (maxTileY - minTileY + 1);
+    tiles     = new RecastTile[numTiles];
+
+    for (y = minTileY; y <= maxTileY; y++) {
+        for (x = minTileX; x <= maxTileX; x++) {
+            RecastTile& tile = tiles[(y - minTileY) * tileWidth + (x - minTileX)];
+
+            tile.tileX      = x;
+            tile.tileY      = y;
+            tile.bmin[0]    = MIN_MAP_BOUNDS + x * tileWorldSize;
+            tile.bmin[1]    = minBounds[1];
+            tile.bmin[2]    = MIN_MAP_BOUNDS + y * tileWorldSize;
+            tile.bmax[0]    = tile.bmin[0] + tileWorldSize;
+            tile.bmax[1]    = maxBounds[1];
+            tile.bmax[2]    = tile.bmin[2] + tileWorldSize;
+            tile.indexes    = NULL;
+            tile.numIndexes = 0;
+            tile.polyMesh   = NULL;
+            tile.layers     = NULL;
+            tile.layerSizes = NULL;
+            tile.numLayers  = 0;
+        }
+    }
+
+    //
+    // Put each triangle into the tiles it overlaps, including their border.
+    // The first pass counts the triangles and the second pass fills the tiles
+    //
+
+    for (j = 0; j < 2; j++) {
+        if (j == 1) {
+            for (i = 0; i < numTiles; i++) {
+                tiles[i].indexes    = new int[tiles[i].numIndexes];
+                tiles[i].numIndexes = 0;
+            }
+        }
+
+        for (i = 0; i < numIndexes; i += 3) {
+            const float *v0 = &vertsBuffer[indexesBuffer[i + 0] * 3];
+            const float *v1 = &vertsBuffer[indexesBuffer[i + 1] * 3];
+            const float *v2 = &vertsBuffer[indexesBuffer[i + 2] * 3];
+            float        triMin[3], triMax[3];
+            int          tx0, ty0, tx1, ty1;
+
+            rcVcopy(triMin, v0);
+            rcVcopy(triMax, v0);
+            rcVmin(triMin, v1);
+            rcVmax(triMax, v1);
+            rcVmin(triMin, v2);
+            rcVmax(triMax, v2);
+
+            tx0 = Q_clamp_int(
+                (int)floorf((triMin[0] - borderWidth - MIN_MAP_BOUNDS) / tileWorldSize), minTileX, maxTileX
+            );
+            ty0 = Q_clamp_int(
+                (int)floorf((triMin[2] - borderWidth - MIN_MAP_BOUNDS) / tileWorldSize), minTileY, maxTileY
+            );
+            tx1 = Q_clamp_int(
+                (int)floorf((triMax[0] + borderWidth - MIN_MAP_BOUNDS) / tileWorldSize), minTileX, maxTileX
+            );
+            ty1 = Q_clamp_int(
+                (int)floorf((triMax[2] + borderWidth - MIN_MAP_BOUNDS) / tileWorldSize), minTileY, maxTileY
+            );
+
+            for (y = ty0; y <= ty1; y++) {
+                for (x = tx0; x <= tx1; x++) {
+                    RecastTile& tile = tiles[(y - minTileY) * tileWidth + (x - minTileX)];
+
+                    if (j == 1) {
+                        tile.indexes[tile.numIndexes + 0] = indexesBuffer[i + 0];
+                        tile.indexes[tile.numIndexes + 1] = indexesBuffer[i + 1];
+                        tile.indexes[tile.numIndexes + 2] = indexesBuffer[i + 2];
+                    }
+
+                    tile.numIndexes += 3;
+                }
+            }
+        }
+    }
+
+    BuildTiles(vertsBuffer, numVertices, tiles, numTiles, borderSize);
+
+    delete[] indexesBuffer;
+    delete[] vertsBuffer;
+
+    //
+    // Each layer of each tile becomes a tile of the navigation mesh
+    //
+
+    numLayerTiles = 0;
+    for (i = 0; i < numTiles; i++) {
+        numLayerTiles += tiles[i].numLayers;
+    }
+
+    InitializeNavMesh(buildContext, numLayerTiles);
+
+    if (!InitializeTileCache(numLayerTiles)) {
+        FreeRecastTiles(tiles, numTiles);
+        throw ScriptException("Couldn't create the tile cache");
+    }
+
+    //
+    // Extensions look for connections across the whole world,
+    // so they are given all tiles merged into one mesh
     //
 
+    Container<rcPolyMesh *>           tileMeshes;
     Container<offMeshNavigationPoint> points;
-    GatherOffMeshPoints(points, polyMesh);
+    int                               regionBase = 0;
 
-    BuildDetourData(buildContext, polyMesh, polyMeshDetail, 0, points);
+    for (i = 0; i < numTiles; i++) {
+        rcPolyMesh *polyMesh = tiles[i].polyMesh;
+        int         maxRegion;
 
-    rcFreePolyMeshDetail(polyMeshDetail);
-    rcFreePolyMesh(polyMesh);
+        if (!polyMesh) {
+            continue;
+        }
+
+        SetPolyFlags(polyMesh);
+
+        // Regions are numbered per tile, make them unique
+        maxRegion = 0;
+        for (j = 0; j < polyMesh->npolys; j++) {
+            if (polyMesh->regs[j]) {
+                maxRegion         = Q_max(maxRegion, (int)polyMesh->regs[j]);
+                polyMesh->regs[j] = (unsigned short)((polyMesh->regs[j] + regionBase) & (RC_BORDER_REG - 1));
+            }
+        }
+        regionBase += maxRegion;
+
+        tileMeshes.AddObject(polyMesh);
+    }
+
+    mergedMesh = rcAllocPolyMesh();
+
+    if (tileMeshes.NumObjects()
+        && rcMergePolyMeshes(&buildContext, &tileMeshes.ObjectAt(1), tileMeshes.NumObjects(), *mergedMesh)) {
+        GatherOffMeshPoints(points, mergedMesh);
+    }
+
+    rcFreePolyMesh(mergedMesh);
+
+    // Off-mesh connections are stored in the tile where they start
+    tileCacheMeshProcess->SetOffMeshConnections(points);
+
+    //
+    // Hand the layers over to the tile cache
+    //
+
+    layerTiles    = new RecastLayerTile[numLayerTiles];
+    numLayerTiles = 0;
+
+    for (i = 0; i < numTiles; i++) {
+        RecastTile& tile = tiles[i];
+
+        for (j = 0; j < tile.numLayers; j++) {
+            dtCompressedTileRef ref;
+
+            status = tileCache->addTile(tile.layers[j], tile.layerSizes[j], DT_COMPRESSEDTILE_FREE_DATA, &ref);
+            if (dtStatusFailed(status)) {
+                buildContext.log(RC_LOG_ERROR, "Failed to add layer %d of tile %d,%d", j, tile.tileX, tile.tileY);
+                continue;
+            }
+
+            // The tile cache owns the data now
+            tile.layers[j] = NULL;
+
+            layerTiles[numLayerTiles].compressedTile = tileCache->getTileByRef(ref);
+            numLayerTiles++;
+        }
+    }
+
+    FreeRecastTiles(tiles, numTiles);
+
+    //
+    // Create detour data
+    //
+
+    BuildLayerTiles(layerTiles, numLayerTiles);
+
+    for (i = 0; i < numLayerTiles; i++) {
+        RecastLayerTile& layerTile = layerTiles[i];
+
+        if (!layerTile.navData) {
+            continue;
+        }
+
+        status = navMeshDt->addTile(layerTile.navData, layerTile.navDataSize, DT_TILE_FREE_DATA, 0, NULL);
+        if (dtStatusFailed(status)) {
+            dtFree(layerTile.navData);
+            buildContext.log(RC_LOG_ERROR, "Failed to create tile for navigation mesh");
+        }
+    }
+
+    delete[] layerTiles;
 }
 
 /*
@@ -698,7 +1494,7 @@ void NavigationMap::BuildMeshesForEntities(RecastBuildContext& buildContext, con
 
         BuildRecastMesh(buildContext, submodel, edict->entity->origin, edict->entity->angles, polyMesh, polyMeshDetail);
 
-        BuildDetourData(buildContext, polyMesh, polyMeshDetail, edict->s.modelindex, {});
+        BuildDetourData(buildContext, polyMesh, polyMeshDetail, 0, 0, edict->s.modelindex);
 
         rcFreePolyMeshDetail(polyMeshDetail);
         rcFreePolyMesh(polyMesh);
@@ -735,6 +1531,29 @@ void NavigationMap::LoadWorldMap(const char *mapname)
         return;
     }
 
+    //
+    // Use the cached navigation mesh if it's up to date
+    //
+
+    start = gi.Milliseconds();
+
+    if (LoadCachedNavMesh(mapname)) {
+        InitializeExtensions();
+        InitializeFilter();
+
+        pathMaster.PostLoadNavigation(*this);
+        navigationObstacleMap.Init();
+
+        ClearExtensions();
+
+        end = gi.Milliseconds();
+
+        gi.Printf("Recast navigation mesh loaded from cache in %.03f seconds\n", (float)((end - start) / 1000.0));
+
+        validNavigation = true;
+        return;
+    }
+
     //
     // Parse the BSP file into triangles
     //
@@ -758,8 +1577,6 @@ void NavigationMap::LoadWorldMap(const char *mapname)
     //
 
     InitializeExtensions();
-
-    InitializeNavMesh(buildContext, navigationData.navMap);
     InitializeFilter();
 
     gi.Printf("Building the navigation mesh...\n");
@@ -772,7 +1589,7 @@ void NavigationMap::LoadWorldMap(const char *mapname)
 
         gi.Printf("  Building meshes for entities...\n");
         // FIXME: TODO
-        //  Split everything into chunks and use a tile-based approach
+        //  Rebuild the tiles the entities are in
         //BuildMeshesForEntities(buildContext, navigationData.navMap);
 
     } catch (const ScriptException& e) {
@@ -791,6 +1608,8 @@ void NavigationMap::LoadWorldMap(const char *mapname)
 
     gi.Printf("Recast navigation mesh(es) generated in %.03f seconds\n", (float)((end - start) / 1000.0));
 
+    SaveCachedNavMesh(mapname);
+
     validNavigation = true;
 }
 
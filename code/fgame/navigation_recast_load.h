@@ -35,7 +35,12 @@ class dtTileCache;
 struct dtTileCacheAlloc;
 struct dtTileCacheCompressor;
 struct dtTileCacheMeshProcess;
+struct NavigationTileCacheCompressor;
+struct NavigationTileCacheMeshProcess;
 class RecastBuildContext;
+struct RecastTile;
+struct RecastLayerTile;
+struct rcCompactHeightfield;
 struct rcPolyMesh;
 struct rcPolyMeshDetail;
 struct offMeshNavigationPoint;
@@ -105,6 +110,38 @@ public:
      */
     const navMap_t& GetNavigationData() const;
 
+    /**
+     * @brief Get the tile cache used to rebuild tiles around obstacles.
+     *
+     * @return dtTileCache* The tile cache.
+     */
+    dtTileCache *GetTileCache() const;
+
+    /**
+     * @brief Return a number that changes each time tiles are rebuilt.
+     * Polygon references from an older revision may no longer be valid.
+     *
+     * @return The revision of the navigation mesh.
+     */
+    unsigned int GetRevision() const;
+
+    /**
+     * @brief Add an obstacle, tiles it touches are rebuilt during the next updates.
+     *
+     * @param mins Minimum bounds in game coordinates.
+     * @param maxs Maximum bounds in game coordinates.
+     * @return The obstacle reference, 0 if it couldn't be added this frame.
+     */
+    unsigned int AddObstacle(const Vector& mins, const Vector& maxs);
+
+    /**
+     * @brief Remove an obstacle, tiles it touched are rebuilt during the next updates.
+     *
+     * @param obstacleRef The obstacle reference returned by AddObstacle().
+     * @return false if it couldn't be removed this frame.
+     */
+    bool RemoveObstacle(unsigned int obstacleRef);
+
     /**
      * @brief Update the navigation map
      * 
@@ -113,30 +150,55 @@ public:
 
 private:
     void GatherOffMeshPoints(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh);
-    void GeneratePolyMesh(
+    rcCompactHeightfield *RasterizeGeometry(
         RecastBuildContext& buildContext,
-        float              *vertsBuffer,
+        const float        *vertsBuffer,
         int                 numVertices,
-        int                *indexesBuffer,
+        const int          *indexesBuffer,
         int                 numIndexes,
-        rcPolyMesh       *&       outPolyMesh,
-        rcPolyMeshDetail *& outPolyMeshDetail
+        const float        *minBounds,
+        const float        *maxBounds
     );
+    void BuildTileLayers(
+        RecastBuildContext&         buildContext,
+        const rcCompactHeightfield& compactedHeightfield,
+        int                         borderSize,
+        RecastTile&                 tile
+    );
+    rcPolyMesh *GeneratePolyMesh(
+        RecastBuildContext& buildContext, rcCompactHeightfield& compactedHeightfield, int borderSize
+    );
+    rcPolyMeshDetail *GeneratePolyMeshDetail(
+        RecastBuildContext& buildContext, const rcPolyMesh& polyMesh, const rcCompactHeightfield& compactedHeightfield
+    );
+    void SetPolyFlags(rcPolyMesh *polyMesh);
 
     void InitializeExtensions();
     void ClearExtensions();
 
-    void InitializeNavMesh(RecastBuildContext& buildContext, const navMap_t& navMap);
+    void InitializeNavMesh(RecastBuildContext& buildContext, int maxTiles);
+    bool InitializeTileCache(int maxTiles);
+    void ClearTileCache();
     void InitializeFilter();
 
     void BuildDetourData(
-        RecastBuildContext&                      buildContext,
-        rcPolyMesh                              *polyMesh,
-        rcPolyMeshDetail                        *polyMeshDetail,
-        int                                      index,
-        const Container<offMeshNavigationPoint>& points
+        RecastBuildContext& buildContext,
+        rcPolyMesh         *polyMesh,
+        rcPolyMeshDetail   *polyMeshDetail,
+        int                 tileX,
+        int                 tileY,
+        int                 index
     );
 
+    void BuildModelGeometry(
+        const navModel_t& model,
+        const Vector&     origin,
+        const Vector&     angles,
+        float           *&vertsBuffer,
+        int&              numVertices,
+        int             *&indexesBuffer,
+        int&              numIndexes
+    );
     void BuildRecastMesh(
         RecastBuildContext& buildContext,
         const navModel_t&   model,
@@ -147,24 +209,40 @@ private:
     );
     void ProcessBSPForNavigation(const char *mapname, navMap_t& outNavigationMap);
 
+    void BuildTiles(const float *vertsBuffer, int numVertices, RecastTile *tiles, int numTiles, int borderSize);
+    void BuildLayerTiles(RecastLayerTile *layerTiles, int numLayerTiles);
     void BuildWorldMesh(RecastBuildContext& buildContext, const navMap_t& navigationMap);
     void BuildMeshesForEntities(RecastBuildContext& buildContext, const navMap_t& navigationMap);
 
+    /**
+     * @brief Load the navigation mesh from the cache file of the map.
+     * 
+     * @param mapname The .bsp map file.
+     * @return true if the cache is up to date and was loaded.
+     */
+    bool LoadCachedNavMesh(const char *mapname);
+
+    /**
+     * @brief Write the navigation mesh to the cache file of the map.
+     * 
+     * @param mapname The .bsp map file.
+     */
+    void SaveCachedNavMesh(const char *mapname) const;
+
 private:
     dtNavMesh      *navMeshDt;
     dtNavMeshQuery *navMeshQuery;
     dtQueryFilter  *queryFilter;
     NavigationBSP   navigationData;
 
-public:
-    float          *offMeshConVerts;
-    float          *offMeshConRad;
-    unsigned short *offMeshConFlags;
-    unsigned char  *offMeshConAreas;
-    unsigned char  *offMeshConDir;
-    unsigned int   *offMeshConUserID;
-    int             offMeshConCount;
+    dtTileCache                    *tileCache;
+    dtTileCacheAlloc               *tileCacheAlloc;
+    NavigationTileCacheCompressor  *tileCacheCompressor;
+    NavigationTileCacheMeshProcess *tileCacheMeshProcess;
+    bool                            pendingTileUpdates;
+    unsigned int                    revision;
 
+public:
     Container<INavigationMapExtension *> extensions;
 
     str  currentMap;
@@ -30,148 +30,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "entity.h"
 #include "trigger.h"
 
-#include "DetourNavMeshQuery.h"
-
 NavigationObstacleMap navigationObstacleMap;
 
-/**
- * @brief Iterate through polys and set flags
- * 
- */
-class NavigationObstacleQueryBase : public dtPolyQuery
-{
-protected:
-    const dtNavMesh         *navMesh;
-    NavigationObstacleTiles& tiles;
-
-public:
-    float maxRadiusSqr;
-
-public:
-    NavigationObstacleQueryBase(const dtNavMesh *inNavMesh, NavigationObstacleTiles& inTiles)
-        : navMesh(inNavMesh)
-        , tiles(inTiles)
-    {}
-
-    float getPolySizeSqr(const dtMeshTile *tile, const dtPoly *poly, Vector& centroid) const
-    {
-        Vector rcBounds[2];
-        Vector rcCentroid;
-        Vector size;
-        int    i;
-
-        //
-        // Calculate the polys bounds
-        //
-
-        ClearBounds(rcBounds[0], rcBounds[1]);
-
-        for (i = 0; i < poly->vertCount; i++) {
-            const float *pv = &tile->verts[poly->verts[i] * 3];
-
-            AddPointToBounds(pv, rcBounds[0], rcBounds[1]);
-        }
-
-        size       = rcBounds[1] - rcBounds[0];
-        rcCentroid = (rcBounds[1] + rcBounds[0]) * 0.5;
-        ConvertRecastToGameCoord(rcCentroid, centroid);
-
-        return size.lengthSquared();
-    }
-};
-
-class NavigationObstacleQueryOccupied : public NavigationObstacleQueryBase
-{
-private:
-    int complexEntityNum;
-
-public:
-    NavigationObstacleQueryOccupied(
-        const dtNavMesh *inNavMesh, NavigationObstacleTiles& inTiles, int inComplexEntityNum
-    )
-        : NavigationObstacleQueryBase(inNavMesh, inTiles)
-        , complexEntityNum(inComplexEntityNum)
-    {}
-
-    void process(const dtMeshTile *tile, dtPoly **polys, dtPolyRef *refs, int count) override
-    {
-        const int tileNum = tile - navMesh->getTile(0);
-        int       i;
-
-        for (i = 0; i < count; i++) {
-            const int   polyNum = polys[i] - tile->polys;
-            Vector      centroid;
-            const float radiusSqr = getPolySizeSqr(tile, polys[i], centroid);
-
-            if (radiusSqr > maxRadiusSqr) {
-                continue;
-            }
-
-            // Still count the poly even if it collides with an object
-            // This is because we don't keep history of collision when releasing
-            tiles.polysRef[tileNum][polyNum]++;
-
-            if (complexEntityNum != -1) {
-                trace_t trace;
-                Vector  mins(MINS_X * 0.75, MINS_Y * 0.75, MINS_Z);
-                Vector  maxs(MAXS_X * 0.75, MAXS_Y * 0.75, MAXS_Z);
-
-                trace = G_Trace(
-                    centroid, mins, maxs, centroid, NULL, CONTENTS_SOLID, qfalse, "NavigationObstacleQueryOccupied"
-                );
-
-                if (trace.entityNum != complexEntityNum && trace.entityNum != ENTITYNUM_WORLD) {
-                    // No valid collision
-                    continue;
-                }
-            }
-
-            // Mark as busy as long as the poly size is below the allowed radius
-            polys[i]->flags |= RECAST_POLYFLAG_BUSY;
-        }
-
-        tiles.tilesRef[tileNum]++;
-    }
-};
-
-class NavigationObstacleQueryReleased : public NavigationObstacleQueryBase
-{
-public:
-    NavigationObstacleQueryReleased(const dtNavMesh *inNavMesh, NavigationObstacleTiles& inTiles)
-        : NavigationObstacleQueryBase(inNavMesh, inTiles)
-    {}
-
-    void process(const dtMeshTile *tile, dtPoly **polys, dtPolyRef *refs, int count) override
-    {
-        const int tileNum = tile - navMesh->getTile(0);
-        int       i;
-
-        for (i = 0; i < count; i++) {
-            const int   polyNum = polys[i] - tile->polys;
-            Vector      centroid;
-            const float radiusSqr = getPolySizeSqr(tile, polys[i], centroid);
-
-            if (radiusSqr > maxRadiusSqr) {
-                continue;
-            }
-
-            // Last poly, release it
-            if (tiles.polysRef[tileNum][polyNum] == 1) {
-                polys[i]->flags &= ~RECAST_POLYFLAG_BUSY;
-            }
-
-            assert(tiles.polysRef[tileNum][polyNum] > 0);
-            if (tiles.polysRef[tileNum][polyNum] > 0) {
-                tiles.polysRef[tileNum][polyNum]--;
-            }
-        }
-
-        assert(tiles.tilesRef[tileNum] > 0);
-        if (tiles.tilesRef[tileNum] > 0) {
-            tiles.tilesRef[tileNum]--;
-        }
-    }
-};
+// Objects moving less than this are not rebuilt,
+// so slowly moving objects don't rebuild tiles every frame
+static const float NAVOBS_MOVE_EPSILON = 16;
 
 const Vector& NavigationObstacleEntities::GetMin(unsigned int entnum) const
 {
@@ -209,6 +72,16 @@ void NavigationObstacleEntities::SetBounds(unsigned int entnum, const Vector& mi
     bounds[1][entnum] = max;
 }
 
+unsigned int NavigationObstacleEntities::GetObstacle(unsigned int entnum) const
+{
+    return obstacle[entnum];
+}
+
+void NavigationObstacleEntities::SetObstacle(unsigned int entnum, unsigned int obstacleRef)
+{
+    obstacle[entnum] = obstacleRef;
+}
+
 bool NavigationObstacleEntities::IsActive(unsigned int entnum) const
 {
     return flag[entnum] & NAVOBS_FLAG_ACTIVE;
@@ -231,76 +104,7 @@ void NavigationObstacleEntities::Remove(unsigned int entnum)
     flag[entnum]      = 0;
     contents[entnum]  = 0;
     solid[entnum]     = SOLID_NOT;
-}
-
-NavigationObstacleTiles::NavigationObstacleTiles()
-{
-    tilesRef = NULL;
-    polysRef = NULL;
-}
-
-NavigationObstacleTiles::~NavigationObstacleTiles()
-{
-    Clear();
-}
-
-void NavigationObstacleTiles::Init()
-{
-    const dtNavMesh *navMesh = navigationMap.GetNavMesh();
-    int              numTotalPolys;
-    int              i;
-    int              totalSize;
-    byte            *start;
-    byte            *buffer;
-
-    Clear();
-
-    numTiles      = navMesh->getMaxTiles();
-    numTotalPolys = 0;
-
-    //
-    // Calculate the total number of polys from all tiles
-    //
-
-    for (i = 0; i < numTiles; i++) {
-        const dtMeshTile *tile = navMesh->getTile(i);
-        if (tile && tile->header) {
-            numTotalPolys += tile->header->polyCount;
-        }
-    }
-
-    //
-    // Allocate one giant big chunk of memory to hold all that information
-    //
-
-    totalSize =
-        sizeof(unsigned int) * numTiles + sizeof(unsigned int *) * numTiles + sizeof(unsigned int) * numTotalPolys;
-    buffer = start = (byte *)gi.Malloc(totalSize);
-
-    tilesRef = new (buffer) unsigned int[numTiles]();
-    buffer += sizeof(unsigned int) * numTiles;
-
-    polysRef = new (buffer) unsigned int *[numTiles];
-    buffer += sizeof(unsigned int *) * numTiles;
-
-    for (i = 0; i < numTiles; i++) {
-        const dtMeshTile *tile = navMesh->getTile(i);
-        if (tile && tile->header) {
-            polysRef[i] = new (buffer) unsigned int[tile->header->polyCount]();
-            buffer += sizeof(unsigned int) * tile->header->polyCount;
-        }
-    }
-
-    assert(buffer - start <= totalSize);
-}
-
-void NavigationObstacleTiles::Clear()
-{
-    // Single block of memory
-    if (tilesRef) {
-        gi.Free(tilesRef);
-        tilesRef = NULL;
-    }
+    obstacle[entnum]  = 0;
 }
 
 NavigationObstacleEntities::NavigationObstacleEntities()
@@ -308,7 +112,8 @@ NavigationObstacleEntities::NavigationObstacleEntities()
     int i;
 
     for (i = 0; i < ARRAY_LEN(flag); i++) {
-        flag[i] = 0;
+        flag[i]     = 0;
+        obstacle[i] = 0;
     }
 }
 
@@ -324,12 +129,11 @@ NavigationObstacleMap::~NavigationObstacleMap()
 
 void NavigationObstacleMap::Clear()
 {
+    // Obstacles are freed along with the tile cache
     if (ents) {
         delete ents;
         ents = NULL;
     }
-
-    tiles.Clear();
 }
 
 void NavigationObstacleMap::Init()
@@ -337,7 +141,6 @@ void NavigationObstacleMap::Init()
     Clear();
 
     ents = new NavigationObstacleEntities();
-    tiles.Init();
 }
 
 void NavigationObstacleMap::Update()
@@ -402,8 +205,11 @@ bool NavigationObstacleMap::HasChanged(gentity_t *ent) const
 {
     const int entnum = ent - g_entities;
 
-    if (ents->GetMin(entnum) != ent->r.absmin || ents->GetMax(entnum) != ent->r.absmax) {
-        return true;
+    for (int i = 0; i < 3; i++) {
+        if (fabs(ents->GetMin(entnum)[i] - ent->r.absmin[i]) > NAVOBS_MOVE_EPSILON
+            || fabs(ents->GetMax(entnum)[i] - ent->r.absmax[i]) > NAVOBS_MOVE_EPSILON) {
+            return true;
+        }
     }
 
     if (ents->GetSolidType(entnum) != ent->solid) {
@@ -438,103 +244,92 @@ bool NavigationObstacleMap::IsSpecialEntity(gentity_t *ent) const
     return true;
 }
 
-void NavigationObstacleMap::EntityAdded(gentity_t *ent)
+bool NavigationObstacleMap::IsObstacle(const Vector& min, const Vector& max) const
 {
-    int entnum = ent - g_entities;
+    const Vector halfExtents = (max - min) * 0.5;
 
-    ents->Add(entnum);
-    ents->SetBounds(entnum, ent->r.absmin, ent->r.absmax);
-    ents->SetSolidType(entnum, ent->solid);
-    ents->SetContents(entnum, ent->r.contents);
+    // Minimum size of 100 units (sphere)
+    // So objects like barrels that the bot can get around are ignored.
+    return halfExtents.lengthXYSquared() >= Square(100);
+}
+
+bool NavigationObstacleMap::AddObstacle(gentity_t *ent)
+{
+    const int    entnum = ent - g_entities;
+    unsigned int obstacleRef;
+
+    if (!IsObstacle(ent->r.absmin, ent->r.absmax)) {
+        ents->SetObstacle(entnum, 0);
+        return true;
+    }
 
-    // Mark the poly as occupied
-    EngagePolysAt(ent, ent->r.absmin, ent->r.absmax);
+    obstacleRef = navigationMap.AddObstacle(ent->r.absmin, ent->r.absmax);
+    if (!obstacleRef) {
+        return false;
+    }
+
+    ents->SetObstacle(entnum, obstacleRef);
+    return true;
 }
 
-void NavigationObstacleMap::EntityRemoved(gentity_t *ent)
+bool NavigationObstacleMap::RemoveObstacle(gentity_t *ent)
 {
-    int entnum = ent - g_entities;
+    const int entnum = ent - g_entities;
 
-    // Release the poly
-    ReleasePolysAt(ent, ents->GetMin(entnum), ents->GetMax(entnum));
+    if (!ents->GetObstacle(entnum)) {
+        return true;
+    }
 
-    ents->Remove(entnum);
+    if (!navigationMap.RemoveObstacle(ents->GetObstacle(entnum))) {
+        return false;
+    }
+
+    ents->SetObstacle(entnum, 0);
+    return true;
 }
 
-void NavigationObstacleMap::EntityChanged(gentity_t *ent)
+void NavigationObstacleMap::EntityAdded(gentity_t *ent)
 {
     int entnum = ent - g_entities;
 
-    // Release polys at the old location
-    ReleasePolysAt(ent, ents->GetMin(entnum), ents->GetMax(entnum));
+    // Try again next frame if the tile cache is busy
+    if (!AddObstacle(ent)) {
+        return;
+    }
 
-    // Mark polys as occupied at the new location
-    EngagePolysAt(ent, ent->r.absmin, ent->r.absmax);
+    ents->Add(entnum);
     ents->SetBounds(entnum, ent->r.absmin, ent->r.absmax);
     ents->SetSolidType(entnum, ent->solid);
     ents->SetContents(entnum, ent->r.contents);
 }
 
-void NavigationObstacleMap::EngagePolysAt(gentity_t *ent, const Vector& min, const Vector& max)
+void NavigationObstacleMap::EntityRemoved(gentity_t *ent)
 {
-    dtNavMeshQuery *navMeshQuery = navigationMap.GetNavMeshQuery();
-    // Use complex collision for BSP brushes
-    NavigationObstacleQueryOccupied query(
-        navigationMap.GetNavMesh(), tiles, ent->solid == SOLID_BSP ? ent - g_entities : -1
-    );
-
-    Vector center;
-    Vector halfExtents;
-    Vector size;
-    float  radiusSqr;
-    center      = (max + min) * 0.5;
-    size        = max - min;
-    halfExtents = size * 0.5;
-
-    radiusSqr = halfExtents.lengthXYSquared();
-    // Minimum size of 100 units (sphere)
-    // So objects like barrels that the bot can get around are ignored.
-    if (radiusSqr < Square(100)) {
+    int entnum = ent - g_entities;
+
+    if (!RemoveObstacle(ent)) {
         return;
     }
 
-    // Allow the object to cover polygons up to twice its size
-    query.maxRadiusSqr = radiusSqr * Square(1.5);
-
-    float rcCenter[3];
-    float rcHalfExtents[3];
-    ConvertGameToRecastCoord(center, rcCenter);
-    ConvertGameToRecastExtents(halfExtents, rcHalfExtents);
-
-    dtQueryFilter filter;
-    navMeshQuery->queryPolygons(rcCenter, rcHalfExtents, &filter, &query);
+    ents->Remove(entnum);
 }
 
-void NavigationObstacleMap::ReleasePolysAt(gentity_t *ent, const Vector& min, const Vector& max)
+void NavigationObstacleMap::EntityChanged(gentity_t *ent)
 {
-    dtNavMeshQuery                 *navMeshQuery = navigationMap.GetNavMeshQuery();
-    NavigationObstacleQueryReleased query(navigationMap.GetNavMesh(), tiles);
-
-    Vector center;
-    Vector halfExtents;
-    Vector size;
-    float  radiusSqr;
-    center      = (max + min) * 0.5;
-    size        = max - min;
-    halfExtents = size * 0.5;
-
-    radiusSqr = halfExtents.lengthXYSquared();
-    if (radiusSqr < Square(100)) {
+    int entnum = ent - g_entities;
+
+    // Remove the obstacle at the old location
+    if (!RemoveObstacle(ent)) {
         return;
     }
 
-    query.maxRadiusSqr = radiusSqr * Square(1.5);
-
-    float rcCenter[3];
-    float rcHalfExtents[3];
-    ConvertGameToRecastCoord(center, rcCenter);
-    ConvertGameToRecastExtents(halfExtents, rcHalfExtents);
+    if (!AddObstacle(ent)) {
+        // Added back next frame
+        ents->Remove(entnum);
+        return;
+    }
 
-    dtQueryFilter filter;
-    navMeshQuery->queryPolygons(rcCenter, rcHalfExtents, &filter, &query);
+    ents->SetBounds(entnum, ent->r.absmin, ent->r.absmax);
+    ents->SetSolidType(entnum, ent->solid);
+    ents->SetContents(entnum, ent->r.contents);
 }
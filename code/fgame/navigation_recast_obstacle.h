@@ -43,39 +43,24 @@ public:
     solid_t       GetSolidType(unsigned int entnum) const;
     void          SetSolidType(unsigned int entnum, solid_t type);
     void          SetBounds(unsigned int entnum, const Vector& min, const Vector& max);
+    unsigned int  GetObstacle(unsigned int entnum) const;
+    void          SetObstacle(unsigned int entnum, unsigned int obstacleRef);
     bool          IsActive(unsigned int entnum) const;
     void          Add(unsigned int entnum);
     void          Set(unsigned int entnum, const Vector& position);
     void          Remove(unsigned int entnum);
 
 public:
-    int     contents[MAX_GENTITIES];
-    Vector  bounds[2][MAX_GENTITIES];
-    byte    flag[MAX_GENTITIES];
-    solid_t solid[MAX_GENTITIES];
-};
-
-/**
- * @brief Store a list of tiles only containing a number of references,
- * used to keep track of the number of entities occupying space.
- * 
- */
-struct NavigationObstacleTiles {
-public:
-    NavigationObstacleTiles();
-    ~NavigationObstacleTiles();
-
-    void Init();
-    void Clear();
-
-public:
-    unsigned int  *tilesRef;
-    unsigned int **polysRef;
-    unsigned int   numTiles;
+    int          contents[MAX_GENTITIES];
+    Vector       bounds[2][MAX_GENTITIES];
+    byte         flag[MAX_GENTITIES];
+    solid_t      solid[MAX_GENTITIES];
+    unsigned int obstacle[MAX_GENTITIES];
 };
 
 /**
  * @brief Manages obstacle on the map.
+ * Obstacles are carved into the navigation mesh using the tile cache.
  * 
  */
 class NavigationObstacleMap
@@ -92,18 +77,18 @@ private:
     bool IsValidEntity(gentity_t *ent) const;
     bool IsSpecialEntity(gentity_t *ent) const;
     bool HasChanged(gentity_t *ent) const;
+    bool IsObstacle(const Vector& min, const Vector& max) const;
 
     void EntityAdded(gentity_t *ent);
     void EntityRemoved(gentity_t *ent);
     void EntityChanged(gentity_t *ent);
 
-    void EngagePolysAt(gentity_t *ent, const Vector& min, const Vector& max);
-    void ReleasePolysAt(gentity_t *ent, const Vector& min, const Vector& max);
+    bool AddObstacle(gentity_t *ent);
+    bool RemoveObstacle(gentity_t *ent);
 
 private:
     // This instance is quite big so only allocate it when used
     NavigationObstacleEntities *ents;
-    NavigationObstacleTiles     tiles;
 };
 
 extern NavigationObstacleMap navigationObstacleMap;
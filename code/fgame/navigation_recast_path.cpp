@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "navigation_recast_path.h"
 #include "navigation_recast_load.h"
 #include "navigation_recast_helpers.h"
+#include "navigate.h"
 #include "level.h"
 
 #include "DetourPathCorridor.h"
@@ -55,6 +56,10 @@ public:
 RecastPather::RecastPather()
     : lastCheckTime(0)
     , moving(false)
+    , navRevision(0)
+    , pathRequest(-1)
+    , nextWaiting(NULL)
+    , requestEndRef(0)
 {
     detourData = new DetourData();
     detourData->corridor.init(256);
@@ -62,6 +67,8 @@ RecastPather::RecastPather()
 
 RecastPather::~RecastPather()
 {
+    pathMaster.CancelRequest(this);
+
     if (detourData) {
         delete detourData;
         detourData = NULL;
@@ -90,26 +97,7 @@ void RecastPather::FindPath(const Vector& start, const Vector& end, const PathSe
         return;
     }
 
-    dtPolyRef polys[MAX_NPOLYS];
-    int       nPolys = 0;
-    navigationMap.GetNavMeshQuery()->findPath(startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1);
-
-    if (nPolys) {
-        vec3_t   closestPos;
-        dtStatus status;
-
-        if (polys[nPolys - 1] != endRef) {
-            status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(polys[nPolys - 1], endPt, closestPos, 0);
-            if (dtStatusFailed(status)) {
-                VectorCopy(endPt, closestPos);
-            }
-        } else {
-            VectorCopy(endPt, closestPos);
-        }
-
-        moving = true;
-        detourData->corridor.setCorridor(closestPos, polys, nPolys);
-    }
+    RequestPath(startRef, endRef, startPt, endPt);
 }
 
 void RecastPather::FindPathNear(
@@ -144,26 +132,7 @@ void RecastPather::FindPathNear(
         return;
     }
 
-    dtPolyRef polys[MAX_NPOLYS];
-    int       nPolys = 0;
-    navigationMap.GetNavMeshQuery()->findPath(startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1);
-
-    if (nPolys) {
-        vec3_t   closestPos;
-        dtStatus status;
-
-        if (polys[nPolys - 1] != endRef) {
-            status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(polys[nPolys - 1], endPt, closestPos, 0);
-            if (dtStatusFailed(status)) {
-                VectorCopy(endPt, closestPos);
-            }
-        } else {
-            VectorCopy(endPt, closestPos);
-        }
-
-        moving = true;
-        detourData->corridor.setCorridor(closestPos, polys, nPolys);
-    }
+    RequestPath(startRef, endRef, startPt, endPt);
 }
 
 void RecastPather::FindPathAway(
@@ -216,31 +185,7 @@ void RecastPather::FindPathAway(
             if (navigationMap.GetNavMeshQuery()->findNearestPoly(point, DETOUR_EXTENT, filter, &endRef, endPt)
                     == DT_SUCCESS
                 && endRef) {
-                dtPolyRef polys[MAX_NPOLYS];
-                int       nPolys = 0;
-                navigationMap.GetNavMeshQuery()->findPath(
-                    startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1
-                );
-
-                if (nPolys) {
-                    vec3_t   closestPos;
-                    dtStatus status;
-
-                    if (polys[nPolys - 1] != endRef) {
-                        status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(
-                            polys[nPolys - 1], endPt, closestPos, 0
-                        );
-                        if (dtStatusFailed(status)) {
-                            VectorCopy(endPt, closestPos);
-                        }
-                    } else {
-                        VectorCopy(endPt, closestPos);
-                    }
-
-                    moving = true;
-                    detourData->corridor.setCorridor(closestPos, polys, nPolys);
-                }
-
+                RequestPath(startRef, endRef, startPt, endPt);
                 return;
             }
         }
@@ -317,37 +262,19 @@ void RecastPather::UpdatePos(const Vector& origin)
             // traversed
             traversingOffMeshLink = false;
         }
+    } else if (navRevision != navigationMap.GetRevision()) {
+        // Tiles were rebuilt, the path may go through polys that are gone
+        navRevision = navigationMap.GetRevision();
+
+        if (moving && !detourData->corridor.isValid(MAX_NPOLYS, navigationMap.GetNavMeshQuery(), filter)) {
+            Replan(origin);
+        }
     } else if (level.inttime >= lastCheckTime + 2000) {
         vec3_t delta;
         VectorSubtract(recastOrigin, detourData->corridor.getPos(), delta);
 
         if (VectorLengthSquared(delta) > Square(64)) {
-            dtPolyRef startRef, endRef;
-            vec3_t    startPt, endPt;
-
-            //
-            // Get the target position
-            //
-            endRef = detourData->corridor.getLastPoly();
-            VectorCopy(detourData->corridor.getTarget(), endPt);
-
-            ResetPosition(origin);
-
-            startRef = 0;
-            navigationMap.GetNavMeshQuery()->findNearestPoly(recastOrigin, DETOUR_EXTENT, filter, &startRef, startPt);
-
-            if (startRef) {
-                dtPolyRef polys[MAX_NPOLYS];
-                int       nPolys = 0;
-                navigationMap.GetNavMeshQuery()->findPath(
-                    startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1
-                );
-
-                if (nPolys) {
-                    moving = true;
-                    detourData->corridor.setCorridor(endPt, polys, nPolys);
-                }
-            }
+            Replan(origin);
         }
 
         lastCheckTime = level.inttime;
@@ -531,7 +458,79 @@ bool RecastPather::HasReachedGoal(const Vector& origin) const
 
 bool RecastPather::IsQuerying() const
 {
-    return false;
+    return pathRequest != -1;
+}
+
+void RecastPather::Replan(const Vector& origin)
+{
+    const dtQueryFilter *filter = navigationMap.GetQueryFilter();
+    dtPolyRef            startRef, endRef;
+    vec3_t               startPt, endPt;
+    Vector               recastOrigin;
+
+    ConvertGameToRecastCoord(origin, recastOrigin);
+
+    //
+    // Get the target position
+    //
+    endRef = detourData->corridor.getLastPoly();
+    VectorCopy(detourData->corridor.getTarget(), endPt);
+
+    if (!navigationMap.GetNavMesh()->isValidPolyRef(endRef)) {
+        // The target poly was rebuilt
+        endRef = 0;
+        navigationMap.GetNavMeshQuery()->findNearestPoly(endPt, DETOUR_EXTENT, filter, &endRef, endPt);
+    }
+
+    ResetPosition(origin);
+
+    startRef = 0;
+    navigationMap.GetNavMeshQuery()->findNearestPoly(recastOrigin, DETOUR_EXTENT, filter, &startRef, startPt);
+
+    if (startRef && endRef) {
+        RequestPath(startRef, endRef, startPt, endPt);
+    }
+}
+
+void RecastPather::RequestPath(dtPolyRef startRef, dtPolyRef endRef, const float *startPt, const float *endPt)
+{
+    requestEndRef = endRef;
+    VectorCopy(endPt, requestEndPt);
+
+    if (!pathMaster.QueueRequest(this, startRef, endRef, startPt, endPt)) {
+        // The queue is full, search right away
+        const dtQueryFilter *filter = navigationMap.GetQueryFilter();
+        dtPolyRef            polys[MAX_NPOLYS];
+        int                  nPolys = 0;
+
+        navigationMap.GetNavMeshQuery()->findPath(
+            startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1
+        );
+
+        SetPathResult(polys, nPolys);
+    }
+}
+
+void RecastPather::SetPathResult(const dtPolyRef *polys, int nPolys)
+{
+    vec3_t   closestPos;
+    dtStatus status;
+
+    if (!nPolys) {
+        return;
+    }
+
+    if (polys[nPolys - 1] != requestEndRef) {
+        status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(polys[nPolys - 1], requestEndPt, closestPos, 0);
+        if (dtStatusFailed(status)) {
+            VectorCopy(requestEndPt, closestPos);
+        }
+    } else {
+        VectorCopy(requestEndPt, closestPos);
+    }
+
+    moving = true;
+    detourData->corridor.setCorridor(closestPos, polys, nPolys);
 }
 
 void RecastPather::ResetPosition(const Vector& origin)
@@ -539,8 +538,12 @@ void RecastPather::ResetPosition(const Vector& origin)
     const dtQueryFilter *filter = navigationMap.GetQueryFilter();
     vec3_t               agentPos;
 
+    // A new path supersedes the pending one
+    pathMaster.CancelRequest(this);
+
     traversingOffMeshLink = false;
     lastCheckTime         = level.inttime;
+    navRevision           = navigationMap.GetRevision();
 
     moving = false;
 
@@ -567,8 +570,213 @@ void RecastPather::ResetPosition(const Vector& origin)
     }
 }
 
-void RecastPathMaster::PostLoadNavigation(const NavigationMap& map) {}
+RecastPathMaster::RecastPathMaster()
+    : navMeshQuery(NULL)
+    , firstRequest(0)
+    , numRequests(0)
+    , searching(false)
+{}
+
+RecastPathMaster::~RecastPathMaster()
+{
+    if (navMeshQuery) {
+        dtFreeNavMeshQuery(navMeshQuery);
+        navMeshQuery = NULL;
+    }
+}
+
+void RecastPathMaster::PostLoadNavigation(const NavigationMap& map)
+{
+    dtStatus status;
+
+    ClearNavigation();
 
-void RecastPathMaster::ClearNavigation() {}
+    // The sliced search state is kept in the query,
+    // so it must not be shared with the synchronous queries
+    navMeshQuery = dtAllocNavMeshQuery();
+    status       = navMeshQuery->init(map.GetNavMesh(), MAX_PATHNODES);
+
+    if (dtStatusFailed(status)) {
+        gi.Printf("Couldn't initialize the path request query\n");
+
+        dtFreeNavMeshQuery(navMeshQuery);
+        navMeshQuery = NULL;
+    }
+}
 
-void RecastPathMaster::Update() {}
+void RecastPathMaster::ClearNavigation()
+{
+    RecastPather *pather;
+    RecastPather *next;
+    int           i;
+
+    for (i = 0; i < numRequests; i++) {
+        PathRequest& request = requests[(firstRequest + i) % MAX_PATH_REQUESTS];
+
+        for (pather = request.waiting; pather; pather = next) {
+            next                = pather->nextWaiting;
+            pather->pathRequest = -1;
+            pather->nextWaiting = NULL;
+        }
+
+        request.waiting = NULL;
+    }
+
+    firstRequest = 0;
+    numRequests  = 0;
+    searching    = false;
+
+    if (navMeshQuery) {
+        dtFreeNavMeshQuery(navMeshQuery);
+        navMeshQuery = NULL;
+    }
+}
+
+void RecastPathMaster::Update()
+{
+    dtStatus status;
+    int      maxIters;
+    int      doneIters;
+
+    if (!navMeshQuery) {
+        return;
+    }
+
+    maxIters = Q_max(g_navigation_pathiterations->integer, 1);
+
+    while (numRequests && maxIters > 0) {
+        PathRequest& request = requests[firstRequest];
+
+        if (!request.waiting) {
+            // All pathers cancelled the request
+            searching    = false;
+            firstRequest = (firstRequest + 1) % MAX_PATH_REQUESTS;
+            numRequests--;
+            continue;
+        }
+
+        if (!searching) {
+            status = navMeshQuery->initSlicedFindPath(
+                request.startRef, request.endRef, request.startPt, request.endPt, navigationMap.GetQueryFilter()
+            );
+
+            if (dtStatusFailed(status)) {
+                FinishRequest(request, status);
+                continue;
+            }
+
+            searching = true;
+        }
+
+        doneIters = 0;
+        status    = navMeshQuery->updateSlicedFindPath(maxIters, &doneIters);
+        maxIters -= Q_max(doneIters, 1);
+
+        if (dtStatusInProgress(status)) {
+            continue;
+        }
+
+        if (dtStatusFailed(status) && request.numRestarts < MAX_PATH_RESTARTS
+            && navigationMap.GetNavMesh()->isValidPolyRef(request.startRef)
+            && navigationMap.GetNavMesh()->isValidPolyRef(request.endRef)) {
+            // Tiles were rebuilt during the search, start over
+            request.numRestarts++;
+            searching = false;
+            continue;
+        }
+
+        FinishRequest(request, status);
+    }
+}
+
+bool RecastPathMaster::QueueRequest(
+    RecastPather *pather, dtPolyRef startRef, dtPolyRef endRef, const float *startPt, const float *endPt
+)
+{
+    int index;
+    int i;
+
+    if (!navMeshQuery) {
+        return false;
+    }
+
+    CancelRequest(pather);
+
+    for (i = 0; i < numRequests; i++) {
+        index = (firstRequest + i) % MAX_PATH_REQUESTS;
+
+        PathRequest& request = requests[index];
+        if (request.startRef == startRef && request.endRef == endRef) {
+            // Share the result with the other pathers
+            pather->pathRequest = index;
+            pather->nextWaiting = request.waiting;
+            request.waiting     = pather;
+            return true;
+        }
+    }
+
+    if (numRequests >= MAX_PATH_REQUESTS) {
+        return false;
+    }
+
+    index = (firstRequest + numRequests) % MAX_PATH_REQUESTS;
+    numRequests++;
+
+    PathRequest& request = requests[index];
+    request.startRef     = startRef;
+    request.endRef       = endRef;
+    VectorCopy(startPt, request.startPt);
+    VectorCopy(endPt, request.endPt);
+    request.waiting     = pather;
+    request.numRestarts = 0;
+
+    pather->pathRequest = index;
+    pather->nextWaiting = NULL;
+
+    return true;
+}
+
+void RecastPathMaster::CancelRequest(RecastPather *pather)
+{
+    RecastPather **link;
+
+    if (pather->pathRequest == -1) {
+        return;
+    }
+
+    for (link = &requests[pather->pathRequest].waiting; *link; link = &(*link)->nextWaiting) {
+        if (*link == pather) {
+            *link = pather->nextWaiting;
+            break;
+        }
+    }
+
+    pather->pathRequest = -1;
+    pather->nextWaiting = NULL;
+}
+
+void RecastPathMaster::FinishRequest(PathRequest& request, dtStatus status)
+{
+    dtPolyRef     polys[MAX_NPOLYS];
+    int           nPolys = 0;
+    RecastPather *pather;
+    RecastPather *next;
+
+    if (dtStatusSucceed(status)) {
+        navMeshQuery->finalizeSlicedFindPath(polys, &nPolys, ARRAY_LEN(polys) - 1);
+    }
+
+    searching    = false;
+    firstRequest = (firstRequest + 1) % MAX_PATH_REQUESTS;
+    numRequests--;
+
+    for (pather = request.waiting; pather; pather = next) {
+        next                = pather->nextWaiting;
+        pather->pathRequest = -1;
+        pather->nextWaiting = NULL;
+
+        pather->SetPathResult(polys, nPolys);
+    }
+
+    request.waiting = NULL;
+}
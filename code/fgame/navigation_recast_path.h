@@ -24,7 +24,10 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "navigation_path.h"
 
+#include "DetourNavMesh.h"
+
 class dtNavMesh;
+class dtNavMeshQuery;
 class dtPathCorridor;
 class NavigationMap;
 struct DetourData;
@@ -63,24 +66,89 @@ public:
     virtual bool    IsQuerying() const override;
 
 private:
+    friend class RecastPathMaster;
+
+    void Replan(const Vector& origin);
     void ResetPosition(const Vector& origin);
+    void RequestPath(dtPolyRef startRef, dtPolyRef endRef, const float *startPt, const float *endPt);
+    void SetPathResult(const dtPolyRef *polys, int nPolys);
 
 private:
-    DetourData *detourData;
-    bool        moving;
-    Vector      lastorg;
-    Vector      lastValidOrg;
-    Vector      currentNodePos;
-    int         lastCheckTime;
-    int         traversingOffMeshLink;
+    DetourData   *detourData;
+    bool          moving;
+    Vector        lastorg;
+    Vector        lastValidOrg;
+    Vector        currentNodePos;
+    int           lastCheckTime;
+    int           traversingOffMeshLink;
+    // Revision of the navigation mesh the path was built with
+    unsigned int  navRevision;
+    // Queued request slot, -1 if there is none
+    int           pathRequest;
+    RecastPather *nextWaiting;
+    dtPolyRef     requestEndRef;
+    vec3_t        requestEndPt;
 };
 
+/**
+ * @brief Queue of path requests, processed with sliced Detour queries
+ * so the cost of searching is spread across frames.
+ *
+ */
 class RecastPathMaster
 {
 public:
+    RecastPathMaster();
+    ~RecastPathMaster();
+
     void PostLoadNavigation(const NavigationMap& map);
     void ClearNavigation();
     void Update();
+
+    /**
+     * @brief Queue a path request for the specified pather.
+     * Pending requests with the same start and end polygons are shared.
+     *
+     * @param pather The pather that will receive the path.
+     * @param startRef Start polygon.
+     * @param endRef End polygon.
+     * @param startPt Start position, in Recast coordinates.
+     * @param endPt End position, in Recast coordinates.
+     * @return false if the queue is full.
+     */
+    bool
+    QueueRequest(RecastPather *pather, dtPolyRef startRef, dtPolyRef endRef, const float *startPt, const float *endPt);
+
+    /**
+     * @brief Remove the pather from the request it's waiting for.
+     *
+     * @param pather The pather to remove.
+     */
+    void CancelRequest(RecastPather *pather);
+
+private:
+    struct PathRequest {
+        dtPolyRef     startRef;
+        dtPolyRef     endRef;
+        vec3_t        startPt;
+        vec3_t        endPt;
+        RecastPather *waiting;
+        // Number of times the search started over because tiles were rebuilt
+        int numRestarts;
+    };
+
+    void FinishRequest(PathRequest& request, dtStatus status);
+
+private:
+    static const int MAX_PATH_REQUESTS = 64;
+    // A request keeps failing if a tile along the path is rebuilt every frame
+    static const int MAX_PATH_RESTARTS = 4;
+
+    dtNavMeshQuery *navMeshQuery;
+    PathRequest     requests[MAX_PATH_REQUESTS];
+    int             firstRequest;
+    int             numRequests;
+    bool            searching;
 };
 
 extern RecastPathMaster pathMaster;
@@ -0,0 +1,303 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+/**
+ * @file navigation_recast_tilecache.cpp
+ * @brief Detour tile cache support.
+ *
+ * Each tile of the world is kept as compressed heightfield layers,
+ * so tiles touched by an obstacle can be rebuilt quickly.
+ */
+
+#include "g_local.h"
+#include "navigation_recast_tilecache.h"
+#include "navigation_recast_load_ext.h"
+#include "navigation_recast_config.h"
+#include "navigation_recast_helpers.h"
+
+#include "DetourNavMesh.h"
+#include "DetourNavMeshBuilder.h"
+
+#include <mutex>
+
+// The LZ77 dictionary is shared by all instances
+static std::mutex compressMutex;
+
+/*
+============
+NavigationTileCacheCompressor::maxCompressedSize
+============
+*/
+int NavigationTileCacheCompressor::maxCompressedSize(const int bufferSize)
+{
+    // Worst case for incompressible data
+    return bufferSize + bufferSize / 16 + 64 + 3;
+}
+
+/*
+============
+NavigationTileCacheCompressor::compress
+============
+*/
+dtStatus NavigationTileCacheCompressor::compress(
+    const unsigned char *buffer,
+    const int            bufferSize,
+    unsigned char       *compressed,
+    const int            maxCompressedSize,
+    int                 *compressedSize
+)
+{
+    std::lock_guard<std::mutex> lock(compressMutex);
+    size_t                      outSize;
+
+    lz77.Compress((unsigned char *)buffer, bufferSize, compressed, &outSize);
+
+    assert(outSize <= (size_t)maxCompressedSize);
+    *compressedSize = (int)outSize;
+
+    return DT_SUCCESS;
+}
+
+/*
+============
+NavigationTileCacheCompressor::decompress
+============
+*/
+dtStatus NavigationTileCacheCompressor::decompress(
+    const unsigned char *compressed,
+    const int            compressedSize,
+    unsigned char       *buffer,
+    const int            maxBufferSize,
+    int                 *bufferSize
+)
+{
+    size_t outSize;
+    int    result;
+
+    // the layers can come from a cache file, don't trust them
+    result = lz77.Decompress((unsigned char *)compressed, compressedSize, buffer, maxBufferSize, &outSize);
+    if (result == -3) {
+        return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+    } else if (result) {
+        return DT_FAILURE;
+    }
+
+    *bufferSize = (int)outSize;
+
+    return DT_SUCCESS;
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::NavigationTileCacheMeshProcess
+============
+*/
+NavigationTileCacheMeshProcess::NavigationTileCacheMeshProcess()
+    : connections(NULL)
+    , numConnections(0)
+    , conVerts(NULL)
+    , conRad(NULL)
+    , conFlags(NULL)
+    , conAreas(NULL)
+    , conDir(NULL)
+    , conUserID(NULL)
+{}
+
+/*
+============
+NavigationTileCacheMeshProcess::~NavigationTileCacheMeshProcess
+============
+*/
+NavigationTileCacheMeshProcess::~NavigationTileCacheMeshProcess()
+{
+    ClearOffMeshConnections();
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::SetOffMeshConnections
+============
+*/
+void NavigationTileCacheMeshProcess::SetOffMeshConnections(const Container<offMeshNavigationPoint>& points)
+{
+    int i;
+
+    ClearOffMeshConnections();
+
+    numConnections = points.NumObjects();
+    if (!numConnections) {
+        return;
+    }
+
+    connections = new navOffMeshConnection_t[numConnections];
+
+    for (i = 0; i < numConnections; i++) {
+        const offMeshNavigationPoint& point      = points.ObjectAt(i + 1);
+        navOffMeshConnection_t&       connection = connections[i];
+
+        ConvertGameToRecastCoord(point.start, &connection.verts[0]);
+        ConvertGameToRecastCoord(point.end, &connection.verts[3]);
+
+        connection.radius = point.radius;
+        connection.userId = i;
+        connection.flags  = point.flags;
+        connection.area   = point.area;
+        connection.dir    = point.bidirectional ? DT_OFFMESH_CON_BIDIR : 0;
+    }
+
+    BuildArrays();
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::SetOffMeshConnections
+============
+*/
+void NavigationTileCacheMeshProcess::SetOffMeshConnections(const navOffMeshConnection_t *inConnections, int count)
+{
+    ClearOffMeshConnections();
+
+    numConnections = count;
+    if (!numConnections) {
+        return;
+    }
+
+    connections = new navOffMeshConnection_t[numConnections];
+    memcpy(connections, inConnections, sizeof(navOffMeshConnection_t) * numConnections);
+
+    BuildArrays();
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::ClearOffMeshConnections
+============
+*/
+void NavigationTileCacheMeshProcess::ClearOffMeshConnections()
+{
+    if (!connections) {
+        return;
+    }
+
+    delete[] connections;
+    delete[] conVerts;
+    delete[] conRad;
+    delete[] conFlags;
+    delete[] conAreas;
+    delete[] conDir;
+    delete[] conUserID;
+
+    connections    = NULL;
+    conVerts       = NULL;
+    conRad         = NULL;
+    conFlags       = NULL;
+    conAreas       = NULL;
+    conDir         = NULL;
+    conUserID      = NULL;
+    numConnections = 0;
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::GetOffMeshConnections
+============
+*/
+const navOffMeshConnection_t *NavigationTileCacheMeshProcess::GetOffMeshConnections() const
+{
+    return connections;
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::GetNumOffMeshConnections
+============
+*/
+int NavigationTileCacheMeshProcess::GetNumOffMeshConnections() const
+{
+    return numConnections;
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::BuildArrays
+============
+*/
+void NavigationTileCacheMeshProcess::BuildArrays()
+{
+    int i;
+
+    conVerts  = new float[6 * numConnections];
+    conRad    = new float[numConnections];
+    conFlags  = new unsigned short[numConnections];
+    conAreas  = new unsigned char[numConnections];
+    conDir    = new unsigned char[numConnections];
+    conUserID = new unsigned int[numConnections];
+
+    for (i = 0; i < numConnections; i++) {
+        const navOffMeshConnection_t& connection = connections[i];
+
+        memcpy(&conVerts[i * 6], connection.verts, sizeof(connection.verts));
+        conRad[i]    = connection.radius;
+        conFlags[i]  = connection.flags;
+        conAreas[i]  = connection.area;
+        conDir[i]    = connection.dir;
+        conUserID[i] = connection.userId;
+    }
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::ApplyOffMeshConnections
+
+Detour only keeps connections starting inside the tile
+============
+*/
+void NavigationTileCacheMeshProcess::ApplyOffMeshConnections(dtNavMeshCreateParams *params) const
+{
+    params->offMeshConCount  = numConnections;
+    params->offMeshConVerts  = conVerts;
+    params->offMeshConRad    = conRad;
+    params->offMeshConFlags  = conFlags;
+    params->offMeshConAreas  = conAreas;
+    params->offMeshConDir    = conDir;
+    params->offMeshConUserID = conUserID;
+}
+
+/*
+============
+NavigationTileCacheMeshProcess::process
+============
+*/
+void NavigationTileCacheMeshProcess::process(
+    dtNavMeshCreateParams *params, unsigned char *polyAreas, unsigned short *polyFlags
+)
+{
+    int i;
+
+    for (i = 0; i < params->polyCount; i++) {
+        if (polyAreas[i] == DT_TILECACHE_WALKABLE_AREA) {
+            polyFlags[i] = RECAST_POLYFLAG_WALKABLE;
+        }
+    }
+
+    ApplyOffMeshConnections(params);
+}
@@ -0,0 +1,135 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+/**
+ * @brief Detour tile cache support, used to rebuild tiles when obstacles change.
+ *
+ */
+
+#pragma once
+
+#include "../qcommon/q_shared.h"
+#include "../corepp/container.h"
+#include "../corepp/lz77.h"
+
+#include "DetourTileCache.h"
+#include "DetourTileCacheBuilder.h"
+
+struct offMeshNavigationPoint;
+
+/**
+ * @brief Off-mesh connection in Recast coordinates,
+ * in the layout stored by the navigation cache.
+ *
+ */
+struct navOffMeshConnection_t {
+    float          verts[6];
+    float          radius;
+    unsigned int   userId;
+    unsigned short flags;
+    unsigned char  area;
+    unsigned char  dir;
+};
+
+/**
+ * @brief Compress tile cache layers using LZ77.
+ * Layers are compressed by the worker threads building the tiles.
+ *
+ */
+struct NavigationTileCacheCompressor : public dtTileCacheCompressor {
+public:
+    int      maxCompressedSize(const int bufferSize) override;
+    dtStatus compress(
+        const unsigned char *buffer,
+        const int            bufferSize,
+        unsigned char       *compressed,
+        const int            maxCompressedSize,
+        int                 *compressedSize
+    ) override;
+    dtStatus decompress(
+        const unsigned char *compressed,
+        const int            compressedSize,
+        unsigned char       *buffer,
+        const int            maxBufferSize,
+        int                 *bufferSize
+    ) override;
+
+private:
+    cLZ77 lz77;
+};
+
+/**
+ * @brief Set poly flags and off-mesh connections of the tiles built by the tile cache.
+ *
+ */
+struct NavigationTileCacheMeshProcess : public dtTileCacheMeshProcess {
+public:
+    NavigationTileCacheMeshProcess();
+    ~NavigationTileCacheMeshProcess();
+
+    /**
+     * @brief Set the off-mesh connections that are given to each tile.
+     *
+     * @param points Off-mesh points in game coordinates.
+     */
+    void SetOffMeshConnections(const Container<offMeshNavigationPoint>& points);
+
+    /**
+     * @brief Set the off-mesh connections that are given to each tile.
+     *
+     * @param connections Off-mesh connections in Recast coordinates.
+     * @param count Number of connections.
+     */
+    void SetOffMeshConnections(const navOffMeshConnection_t *connections, int count);
+
+    /**
+     * @brief Free all off-mesh connections.
+     */
+    void ClearOffMeshConnections();
+
+    const navOffMeshConnection_t *GetOffMeshConnections() const;
+    int                           GetNumOffMeshConnections() const;
+
+    /**
+     * @brief Fill the off-mesh connections of the navigation mesh parameters.
+     *
+     * @param params Parameters used to create the tile data.
+     */
+    void ApplyOffMeshConnections(struct dtNavMeshCreateParams *params) const;
+
+    void process(struct dtNavMeshCreateParams *params, unsigned char *polyAreas, unsigned short *polyFlags) override;
+
+private:
+    void BuildArrays();
+
+private:
+    navOffMeshConnection_t *connections;
+    int                     numConnections;
+
+    // Arrays in the layout Detour expects
+    float          *conVerts;
+    float          *conRad;
+    unsigned short *conFlags;
+    unsigned char  *conAreas;
+    unsigned char  *conDir;
+    unsigned int   *conUserID;
+};
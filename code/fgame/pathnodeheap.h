@@ -0,0 +1,206 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// pathnodeheap.h: Open set of the path node search
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+/**
+ * @brief Indexed binary heap ordered by the node cost (f).
+ * Nodes with the same cost are popped in reverse insertion order.
+ * The node type must have the f, inopen, heapIndex and heapOrder fields.
+ * 
+ * @tparam NodeType The type of the node.
+ * @tparam maxNodes The maximum number of nodes.
+ */
+template<typename NodeType, int maxNodes>
+class PathNodeHeap
+{
+public:
+    PathNodeHeap();
+
+    void      Clear();
+    bool      IsEmpty() const;
+    int       NumNodes() const;
+    void      Push(NodeType *node);
+    NodeType *Pop();
+    void      Remove(NodeType *node);
+
+private:
+    static bool IsBefore(const NodeType *node1, const NodeType *node2);
+
+    void SetNodeAt(int index, NodeType *node);
+    void SiftUp(int index);
+    void SiftDown(int index);
+
+private:
+    NodeType *nodes[maxNodes];
+    int       numNodes;
+    int       order;
+};
+
+template<typename NodeType, int maxNodes>
+PathNodeHeap<NodeType, maxNodes>::PathNodeHeap()
+{
+    Clear();
+}
+
+template<typename NodeType, int maxNodes>
+void PathNodeHeap<NodeType, maxNodes>::Clear()
+{
+    // nodes still in the heap keep their inopen flag,
+    // the search uses its find count to ignore them
+    numNodes = 0;
+    order    = 0;
+}
+
+template<typename NodeType, int maxNodes>
+bool PathNodeHeap<NodeType, maxNodes>::IsEmpty() const
+{
+    return numNodes == 0;
+}
+
+template<typename NodeType, int maxNodes>
+int PathNodeHeap<NodeType, maxNodes>::NumNodes() const
+{
+    return numNodes;
+}
+
+template<typename NodeType, int maxNodes>
+bool PathNodeHeap<NodeType, maxNodes>::IsBefore(const NodeType *node1, const NodeType *node2)
+{
+    if (node1->f != node2->f) {
+        return node1->f < node2->f;
+    }
+
+    // the most recent node goes first
+    return node1->heapOrder > node2->heapOrder;
+}
+
+template<typename NodeType, int maxNodes>
+void PathNodeHeap<NodeType, maxNodes>::SetNodeAt(int index, NodeType *node)
+{
+    nodes[index]    = node;
+    node->heapIndex = index;
+}
+
+template<typename NodeType, int maxNodes>
+void PathNodeHeap<NodeType, maxNodes>::SiftUp(int index)
+{
+    NodeType *node = nodes[index];
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (!IsBefore(node, nodes[parent])) {
+            break;
+        }
+
+        SetNodeAt(index, nodes[parent]);
+        index = parent;
+    }
+
+    SetNodeAt(index, node);
+}
+
+template<typename NodeType, int maxNodes>
+void PathNodeHeap<NodeType, maxNodes>::SiftDown(int index)
+{
+    NodeType *node = nodes[index];
+
+    for (;;) {
+        int child = index * 2 + 1;
+
+        if (child >= numNodes) {
+            break;
+        }
+
+        if (child + 1 < numNodes && IsBefore(nodes[child + 1], nodes[child])) {
+            child++;
+        }
+
+        if (!IsBefore(nodes[child], node)) {
+            break;
+        }
+
+        SetNodeAt(index, nodes[child]);
+        index = child;
+    }
+
+    SetNodeAt(index, node);
+}
+
+template<typename NodeType, int maxNodes>
+void PathNodeHeap<NodeType, maxNodes>::Push(NodeType *node)
+{
+    assert(numNodes < maxNodes);
+
+    node->inopen    = true;
+    node->heapOrder = ++order;
+    SetNodeAt(numNodes++, node);
+    SiftUp(node->heapIndex);
+}
+
+template<typename NodeType, int maxNodes>
+NodeType *PathNodeHeap<NodeType, maxNodes>::Pop()
+{
+    NodeType *node;
+
+    if (!numNodes) {
+        return NULL;
+    }
+
+    node = nodes[0];
+    Remove(node);
+
+    return node;
+}
+
+template<typename NodeType, int maxNodes>
+void PathNodeHeap<NodeType, maxNodes>::Remove(NodeType *node)
+{
+    int       index;
+    NodeType *last;
+
+    index = node->heapIndex;
+    assert(index >= 0 && index < numNodes && nodes[index] == node);
+
+    node->inopen    = false;
+    node->heapIndex = -1;
+
+    numNodes--;
+    if (index == numNodes) {
+        return;
+    }
+
+    last = nodes[numNodes];
+    SetNodeAt(index, last);
+
+    if (index > 0 && IsBefore(last, nodes[(index - 1) / 2])) {
+        SiftUp(index);
+    } else {
+        SiftDown(index);
+    }
+}
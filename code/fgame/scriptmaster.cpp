@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "worldspawn.h"
 #include "scriptcompiler.h"
 #include "scriptexception.h"
+#include "scriptprofiler.h"
 
 #ifdef WIN32
 #    include <direct.h>
@@ -763,6 +764,11 @@ void ScriptMaster::Reset(qboolean samemap)
         CloseGameScript();
         StringDict.clear();
         InitConstStrings();
+
+        if (world) {
+            // the target lists are indexed by const string
+            world->RebuildTargetListIndex();
+        }
     }
 
     ScriptDelegate::ResetAllDelegates();
@@ -857,6 +863,9 @@ void ScriptMaster::CloseGameScript(void)
     }
 
     m_GameScripts.clear();
+
+    // The profiled lines are kept across maps
+    ScriptProfile.ClearCodePositions();
 }
 
 GameScript *ScriptMaster::GetGameScriptInternal(str& filename)
@@ -947,6 +956,36 @@ GameScript *ScriptMaster::GetGameScript(str filename, qboolean recompile)
     }
 }
 
+/*
+============
+ScriptMaster::RecompileGameScripts
+
+Compile again all the loaded scripts, with the current settings
+============
+*/
+void ScriptMaster::RecompileGameScripts(void)
+{
+    con_map_enum<const_str, GameScript *> en(m_GameScripts);
+    GameScript                          **g;
+    Container<const_str>                  filenames;
+    int                                   i;
+
+    for (g = en.NextValue(); g != NULL; g = en.NextValue()) {
+        if (*g) {
+            filenames.AddObject((*g)->ConstFilename());
+        }
+    }
+
+    // the scripted events would point to the old scripts
+    for (i = 0; i < SE_MAX; i++) {
+        scriptedEvents[i] = ScriptEvent();
+    }
+
+    for (i = 1; i <= filenames.NumObjects(); i++) {
+        GetScript(filenames.ObjectAt(i), qtrue);
+    }
+}
+
 GameScript *ScriptMaster::GetScript(const_str filename, qboolean recompile)
 {
     try {
@@ -1004,6 +1043,18 @@ void ScriptMaster::Archive(Archiver& arc)
     int          num;
     ScriptVM    *scriptVM;
     ScriptVM    *prevScriptVM;
+    qboolean     optimize;
+
+    // Added in OPM
+    //  The saved code positions depend on whether the scripts were optimized,
+    //  so the scripts must be compiled the same way before the threads are read
+    optimize = g_scriptoptimize->integer != 0;
+    arc.ArchiveBoolean(&optimize);
+
+    if (arc.Loading() && optimize != (g_scriptoptimize->integer != 0)) {
+        gi.cvar_set2("g_scriptoptimize", optimize ? "1" : "0", qtrue);
+        RecompileGameScripts();
+    }
 
     if (arc.Saving()) {
         count = (int)ScriptClass_allocator.Count();
@@ -1653,6 +1653,15 @@ Event EV_ScriptThread_GetTimeZone
     "Gets current time zone",
     EV_RETURN
 );
+Event EV_ScriptThread_GetRealTime
+(
+    "getrealtime",
+    EV_DEFAULT,
+    NULL,
+    NULL,
+    "Gets the real time in milliseconds, to measure how long script code takes to run",
+    EV_RETURN
+);
 Event EV_ScriptThread_PregMatch
 (
     "preg_match",
@@ -2284,6 +2293,7 @@ CLASS_DECLARATION(Listener, ScriptThread, NULL) {
     {&EV_ScriptThread_CancelWaiting,           &ScriptThread::CancelWaiting           },
     {&EV_ScriptThread_GetTime,                 &ScriptThread::GetTime                 },
     {&EV_ScriptThread_GetTimeZone,             &ScriptThread::GetTimeZone             },
+    {&EV_ScriptThread_GetRealTime,             &ScriptThread::GetRealTime             },
     {&EV_ScriptThread_PregMatch,               &ScriptThread::PregMatch               },
     {&EV_ScriptThread_FlagClear,               &ScriptThread::FlagClear               },
     {&EV_ScriptThread_FlagInit,                &ScriptThread::FlagInit                },
@@ -6468,6 +6478,11 @@ void ScriptThread::GetTimeZone(Event *ev)
     ev->AddInteger(timediff);
 }
 
+void ScriptThread::GetRealTime(Event *ev)
+{
+    ev->AddInteger(gi.Milliseconds());
+}
+
 // IMPORTANT NOTE:
 // SLRE is buggy, consider switch to Boost.Regex or .xpressive
 
@@ -299,6 +299,7 @@ public:
     void GetTime(Event *ev);
     void GetDate(Event *ev);
     void GetTimeZone(Event *ev);
+    void GetRealTime(Event *ev);
     void PregMatch(Event *ev);
     void EventIHudDraw3d(Event *ev);
     void EventIHudDrawShader(Event *ev);
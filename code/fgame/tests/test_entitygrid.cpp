@@ -0,0 +1,175 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../entitygrid.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+static const int NUM_ENTITIES = 1000;
+static const int NUM_QUERIES  = 2000;
+
+static EntityGrid      grid;
+static EntityGridQuery query;
+static vec3_t          centroids[MAX_GENTITIES];
+static float           radiuses2[MAX_GENTITIES];
+static bool            linked[MAX_GENTITIES];
+
+static float random_float(float min, float max)
+{
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+static void random_entity(int entnum)
+{
+    float radius;
+
+    centroids[entnum][0] = random_float(-8192, 8192);
+    centroids[entnum][1] = random_float(-8192, 8192);
+    centroids[entnum][2] = random_float(-1024, 1024);
+
+    // a few entities are bigger than a cell
+    radius            = (entnum % 50) ? random_float(0, 64) : random_float(512, 4096);
+    radiuses2[entnum] = radius * radius;
+    linked[entnum]    = true;
+
+    grid.Link(entnum, centroids[entnum], radiuses2[entnum]);
+}
+
+static int brute_force(const vec3_t org, float radius, bool check)
+{
+    vec3_t delta;
+    int    count;
+    int    i;
+
+    count = 0;
+    for (i = 0; i < NUM_ENTITIES; i++) {
+        if (!linked[i]) {
+            continue;
+        }
+
+        VectorSubtract(org, centroids[i], delta);
+        if (DotProduct(delta, delta) - radiuses2[i] <= radius * radius) {
+            count++;
+        }
+    }
+
+    if (check) {
+        if (count != query.NumEntities()) {
+            return -1;
+        }
+
+        for (i = query.NextEntityNum(-1); i != -1; i = query.NextEntityNum(i)) {
+            if (!linked[i]) {
+                return -1;
+            }
+
+            VectorSubtract(org, centroids[i], delta);
+            if (DotProduct(delta, delta) - radiuses2[i] > radius * radius) {
+                return -1;
+            }
+        }
+    }
+
+    return count;
+}
+
+bool test_queries()
+{
+    vec3_t org;
+    float  radius;
+    int    i;
+
+    srand(1);
+
+    for (i = 0; i < NUM_ENTITIES; i++) {
+        random_entity(i);
+    }
+
+    for (i = 0; i < NUM_QUERIES; i++) {
+        if (i % 10 == 0) {
+            // move or remove some entities
+            int entnum = rand() % NUM_ENTITIES;
+            if (rand() & 1) {
+                grid.Unlink(entnum);
+                linked[entnum] = false;
+            } else {
+                random_entity(entnum);
+            }
+        }
+
+        org[0] = random_float(-8192, 8192);
+        org[1] = random_float(-8192, 8192);
+        org[2] = random_float(-1024, 1024);
+        radius = (i % 100) ? random_float(0, 1024) : random_float(1024, 16384);
+
+        grid.QueryRadius(org, radius, query);
+        if (brute_force(org, radius, true) == -1) {
+            std::cerr << "Query " << i << " doesn't match" << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "Checked " << NUM_QUERIES << " queries" << std::endl;
+    return true;
+}
+
+void benchmark_queries()
+{
+    std::chrono::steady_clock::time_point start;
+    double                                gridTime, bruteTime;
+    vec3_t                                org;
+    int                                   total;
+    int                                   i;
+
+    total = 0;
+    start = std::chrono::steady_clock::now();
+    for (i = 0; i < NUM_QUERIES; i++) {
+        VectorSet(org, centroids[i % NUM_ENTITIES][0], centroids[i % NUM_ENTITIES][1], 0);
+        grid.QueryRadius(org, 256, query);
+        total += query.NumEntities();
+    }
+    gridTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (i = 0; i < NUM_QUERIES; i++) {
+        VectorSet(org, centroids[i % NUM_ENTITIES][0], centroids[i % NUM_ENTITIES][1], 0);
+        total -= brute_force(org, 256, false);
+    }
+    bruteTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Grid: " << gridTime / NUM_QUERIES << " us/query, linear: " << bruteTime / NUM_QUERIES
+              << " us/query (" << NUM_ENTITIES << " entities, difference " << total << ")" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_queries()) {
+        std::cerr << "Entity grid queries failed!" << std::endl;
+        return 1;
+    }
+
+    benchmark_queries();
+
+    return 0;
+}
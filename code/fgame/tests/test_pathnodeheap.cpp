@@ -0,0 +1,328 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../pathnodeheap.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+//
+// Node graph laid out like the path nodes of a map:
+// a grid of nodes 128 units apart, each one connected to its close neighbors
+//
+
+static const int GRID_SIZE    = 64;
+static const int MAX_NODES    = GRID_SIZE * GRID_SIZE;
+static const int MAX_CHILDREN = 8;
+static const int NUM_SEARCHES = 200;
+
+struct TestNode {
+    float     x, y;
+    int       children[MAX_CHILDREN];
+    float     dists[MAX_CHILDREN];
+    int       numChildren;
+    int       findCount;
+    float     f, g, h;
+    TestNode *Parent;
+    bool      inopen;
+    int       heapIndex;
+    int       heapOrder;
+    TestNode *PrevNode;
+    TestNode *NextNode;
+};
+
+static TestNode nodes[MAX_NODES];
+static int      findFrame;
+
+static PathNodeHeap<TestNode, MAX_NODES> heap;
+
+static void build_graph()
+{
+    int x, y, dx, dy;
+
+    srand(1);
+
+    for (y = 0; y < GRID_SIZE; y++) {
+        for (x = 0; x < GRID_SIZE; x++) {
+            TestNode *node = &nodes[y * GRID_SIZE + x];
+
+            node->x           = x * 128 + (rand() % 64);
+            node->y           = y * 128 + (rand() % 64);
+            node->numChildren = 0;
+        }
+    }
+
+    for (y = 0; y < GRID_SIZE; y++) {
+        for (x = 0; x < GRID_SIZE; x++) {
+            TestNode *node = &nodes[y * GRID_SIZE + x];
+
+            for (dy = -1; dy <= 1; dy++) {
+                for (dx = -1; dx <= 1; dx++) {
+                    TestNode *other;
+
+                    if ((!dx && !dy) || x + dx < 0 || x + dx >= GRID_SIZE || y + dy < 0 || y + dy >= GRID_SIZE) {
+                        continue;
+                    }
+
+                    // some connections are blocked
+                    if (rand() % 8 == 0) {
+                        continue;
+                    }
+
+                    other                             = &nodes[(y + dy) * GRID_SIZE + x + dx];
+                    node->children[node->numChildren] = (y + dy) * GRID_SIZE + x + dx;
+                    node->dists[node->numChildren]    = hypotf(other->x - node->x, other->y - node->y);
+                    node->numChildren++;
+                }
+            }
+        }
+    }
+}
+
+//
+// The previous implementation, with the open set as a sorted list
+//
+static TestNode *find_path_list(TestNode *start, TestNode *to)
+{
+    TestNode *open;
+    TestNode *Node;
+    TestNode *NewNode;
+    TestNode *prev, *next;
+    int       i, g, f;
+
+    findFrame++;
+
+    start->g         = 0;
+    start->Parent    = NULL;
+    start->findCount = findFrame;
+    start->inopen    = true;
+    start->PrevNode  = NULL;
+    start->NextNode  = NULL;
+    open             = start;
+
+    while (open) {
+        Node         = open;
+        open->inopen = false;
+        open         = Node->NextNode;
+        if (open) {
+            open->PrevNode = NULL;
+        }
+
+        if (Node == to) {
+            return Node;
+        }
+
+        for (i = Node->numChildren - 1; i >= 0; i--) {
+            NewNode = &nodes[Node->children[i]];
+            g       = (int)(Node->dists[i] + Node->g + 1.0f);
+
+            if (NewNode->findCount == findFrame) {
+                if (NewNode->g <= g) {
+                    continue;
+                }
+
+                if (NewNode->inopen) {
+                    NewNode->inopen = false;
+                    next            = NewNode->NextNode;
+                    prev            = NewNode->PrevNode;
+                    if (next) {
+                        next->PrevNode = prev;
+                    }
+                    if (prev) {
+                        prev->NextNode = next;
+                    } else {
+                        open = next;
+                    }
+                }
+            }
+
+            NewNode->h         = hypotf(to->x - NewNode->x, to->y - NewNode->y);
+            f                  = (int)((float)g + NewNode->h);
+            NewNode->Parent    = Node;
+            NewNode->g         = (float)g;
+            NewNode->f         = (float)f;
+            NewNode->findCount = findFrame;
+            NewNode->inopen    = true;
+
+            if (!open || open->f >= f) {
+                NewNode->NextNode = open;
+                NewNode->PrevNode = NULL;
+                if (open) {
+                    open->PrevNode = NewNode;
+                }
+                open = NewNode;
+                continue;
+            }
+
+            prev = open;
+            for (next = open->NextNode; next; next = next->NextNode) {
+                if (next->f >= f) {
+                    break;
+                }
+                prev = next;
+            }
+
+            NewNode->NextNode = next;
+            if (next) {
+                next->PrevNode = NewNode;
+            }
+            prev->NextNode    = NewNode;
+            NewNode->PrevNode = prev;
+        }
+    }
+
+    return NULL;
+}
+
+static TestNode *find_path_heap(TestNode *start, TestNode *to)
+{
+    TestNode *Node;
+    TestNode *NewNode;
+    int       i, g, f;
+
+    findFrame++;
+    heap.Clear();
+
+    start->g         = 0;
+    start->Parent    = NULL;
+    start->findCount = findFrame;
+    heap.Push(start);
+
+    while (!heap.IsEmpty()) {
+        Node = heap.Pop();
+
+        if (Node == to) {
+            return Node;
+        }
+
+        for (i = Node->numChildren - 1; i >= 0; i--) {
+            NewNode = &nodes[Node->children[i]];
+            g       = (int)(Node->dists[i] + Node->g + 1.0f);
+
+            if (NewNode->findCount == findFrame) {
+                if (NewNode->g <= g) {
+                    continue;
+                }
+
+                if (NewNode->inopen) {
+                    heap.Remove(NewNode);
+                }
+            }
+
+            NewNode->h         = hypotf(to->x - NewNode->x, to->y - NewNode->y);
+            f                  = (int)((float)g + NewNode->h);
+            NewNode->Parent    = Node;
+            NewNode->g         = (float)g;
+            NewNode->f         = (float)f;
+            NewNode->findCount = findFrame;
+
+            heap.Push(NewNode);
+        }
+    }
+
+    return NULL;
+}
+
+static int path_length(TestNode *node, TestNode **path)
+{
+    int count;
+
+    for (count = 0; node; node = node->Parent) {
+        path[count++] = node;
+    }
+
+    return count;
+}
+
+bool test_paths()
+{
+    static TestNode *listPath[MAX_NODES];
+    static TestNode *heapPath[MAX_NODES];
+    int              i, j;
+    int              listCount, heapCount;
+
+    srand(2);
+
+    for (i = 0; i < NUM_SEARCHES; i++) {
+        TestNode *start = &nodes[rand() % MAX_NODES];
+        TestNode *end   = &nodes[rand() % MAX_NODES];
+
+        listCount = path_length(find_path_list(start, end), listPath);
+        heapCount = path_length(find_path_heap(start, end), heapPath);
+
+        // the heap must pop nodes in the same order as the list
+        if (listCount != heapCount) {
+            std::cerr << "Search " << i << ": " << listCount << " != " << heapCount << " nodes" << std::endl;
+            return false;
+        }
+
+        for (j = 0; j < listCount; j++) {
+            if (listPath[j] != heapPath[j]) {
+                std::cerr << "Search " << i << ": paths differ at node " << j << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "Checked " << NUM_SEARCHES << " searches" << std::endl;
+    return true;
+}
+
+void benchmark_paths()
+{
+    std::chrono::steady_clock::time_point start;
+    double                                listTime, heapTime;
+    int                                   i;
+
+    srand(3);
+    start = std::chrono::steady_clock::now();
+    for (i = 0; i < NUM_SEARCHES; i++) {
+        find_path_list(&nodes[rand() % MAX_NODES], &nodes[rand() % MAX_NODES]);
+    }
+    listTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    srand(3);
+    start = std::chrono::steady_clock::now();
+    for (i = 0; i < NUM_SEARCHES; i++) {
+        find_path_heap(&nodes[rand() % MAX_NODES], &nodes[rand() % MAX_NODES]);
+    }
+    heapTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Sorted list: " << listTime / NUM_SEARCHES << " us/search, heap: " << heapTime / NUM_SEARCHES
+              << " us/search (" << MAX_NODES << " nodes)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    build_graph();
+
+    if (!test_paths()) {
+        std::cerr << "Path search failed!" << std::endl;
+        return 1;
+    }
+
+    benchmark_paths();
+
+    return 0;
+}
@@ -1035,6 +1035,11 @@ Listener *World::GetTarget(str targetname, bool quiet)
 }
 
 Listener *World::GetScriptTarget(str targetname)
+{
+    return GetScriptTarget(Director.AddString(targetname));
+}
+
+Listener *World::GetScriptTarget(const_str targetname)
 {
     TargetList *targetList = GetTargetList(targetname);
 
@@ -1048,54 +1053,99 @@ Listener *World::GetScriptTarget(str targetname)
         ScriptError(
             "There are %d entities with targetname '%s'. You are using a command that requires exactly one.",
             targetList->list.NumObjects(),
-            targetname.c_str()
+            Director.GetString(targetname).c_str()
         );
     }
 
     return NULL;
 }
 
-TargetList *World::GetExistingTargetList(const str& targetname)
+TargetList *World::CreateTargetList(const str& targetname, const_str name)
 {
     TargetList *targetList;
-    int         i;
 
+    targetList = new TargetList(targetname);
+    m_targetListContainer.AddObject(targetList);
+    m_targetListMap[name] = targetList;
+
+    return targetList;
+}
+
+TargetList *World::GetExistingTargetList(const str& targetname)
+{
     if (!targetname.length()) {
         return NULL;
     }
 
-    for (i = m_targetListContainer.NumObjects(); i > 0; i--) {
-        targetList = m_targetListContainer.ObjectAt(i);
-        if (targetname == targetList->targetname) {
-            return targetList;
-        }
+    // a target list always has its name in the string dictionary
+    return GetExistingTargetList(Director.GetString(targetname.c_str()));
+}
+
+TargetList *World::GetExistingTargetList(const_str targetname)
+{
+    TargetList **targetList;
+
+    if (targetname == STRING_NULL || targetname == STRING_EMPTY) {
+        return NULL;
     }
 
-    return NULL;
+    targetList = m_targetListMap.find(targetname);
+    if (!targetList) {
+        return NULL;
+    }
+
+    assert((*targetList)->targetname == Director.GetString(targetname));
+    return *targetList;
 }
 
 TargetList *World::GetTargetList(str& targetname)
+{
+    if (!targetname.length()) {
+        // Fixed in OPM
+        //  Don't create a targetlist for the empty target name
+        return NULL;
+    }
+
+    return GetTargetList(Director.AddString(targetname));
+}
+
+TargetList *World::GetTargetList(const_str targetname)
 {
     TargetList *targetList;
-    int         i;
 
-    if (!targetname.length()) {
+    if (targetname == STRING_NULL || targetname == STRING_EMPTY) {
         // Fixed in OPM
         //  Don't create a targetlist for the empty target name
         return NULL;
     }
 
-    for (i = m_targetListContainer.NumObjects(); i > 0; i--) {
-        targetList = m_targetListContainer.ObjectAt(i);
-        if (targetname == targetList->targetname) {
-            return targetList;
-        }
+    targetList = GetExistingTargetList(targetname);
+    if (targetList) {
+        return targetList;
     }
 
-    targetList = new TargetList(targetname);
-    m_targetListContainer.AddObject(targetList);
+    return CreateTargetList(Director.GetString(targetname), targetname);
+}
 
-    return targetList;
+/*
+====================
+RebuildTargetListIndex
+
+Must be called whenever the string dictionary is cleared,
+as the target lists are indexed by const string
+====================
+*/
+void World::RebuildTargetListIndex()
+{
+    TargetList *targetList;
+    int         i;
+
+    m_targetListMap.clear();
+
+    for (i = 1; i <= m_targetListContainer.NumObjects(); i++) {
+        targetList = m_targetListContainer.ObjectAt(i);
+        m_targetListMap[Director.AddString(targetList->targetname)] = targetList;
+    }
 }
 
 void World::AddTargetEntity(SimpleEntity *ent)
@@ -1164,6 +1214,7 @@ void World::FreeTargetList()
     }
 
     m_targetListContainer.FreeObjectList();
+    m_targetListMap.clear();
 }
 
 void World::Archive(Archiver& arc)
@@ -1180,8 +1231,7 @@ void World::Archive(Archiver& arc)
         for (i = 1; i <= num; i++) {
             arc.ArchiveString(&targetname);
 
-            targetList = new TargetList(targetname);
-            m_targetListContainer.AddObject(targetList);
+            targetList = CreateTargetList(targetname, Director.AddString(targetname));
 
             arc.ArchiveObjectPosition((LightClass *)&targetList->list);
             arc.ArchiveInteger(&num2);
@@ -100,9 +100,13 @@ public:
 
 class World : public Entity
 {
-    Container<TargetList *> m_targetListContainer;
-    qboolean                world_dying;
-    Vector                  bounds[2];
+    Container<TargetList *>          m_targetListContainer;
+    con_map<const_str, TargetList *> m_targetListMap; // target lists indexed by targetname
+    qboolean                         world_dying;
+    Vector                           bounds[2];
+
+private:
+    TargetList *CreateTargetList(const str& targetname, const_str name);
 
 public:
     // farplane variables
@@ -149,14 +153,18 @@ public:
     void RemoveTargetEntity(SimpleEntity *ent);
 
     void FreeTargetList();
+    void RebuildTargetListIndex();
 
     SimpleEntity *GetNextEntity(str targetname, SimpleEntity *ent);
     Listener     *GetScriptTarget(str targetname);
+    Listener     *GetScriptTarget(const_str targetname);
     Listener     *GetTarget(str targetname, bool quiet);
     int           GetTargetnameIndex(SimpleEntity *ent);
 
     TargetList *GetExistingTargetList(const str& targetname);
+    TargetList *GetExistingTargetList(const_str targetname);
     TargetList *GetTargetList(str& targetname);
+    TargetList *GetTargetList(const_str targetname);
 
     void SetFarClipOverride(Event *ev);
     void SetFarPlaneColorOverride(Event *ev);
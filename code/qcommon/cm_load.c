@@ -54,6 +54,7 @@ void SetPlaneSignbits (cplane_t *out) {
 
 clipMap_t	cm;
 int			c_pointcontents;
+Q_THREAD_LOCAL int	c_threadpointcontents;
 int			c_traces, c_brush_traces, c_patch_traces, c_terrain_patch_traces;
 
 
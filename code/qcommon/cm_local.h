@@ -233,6 +233,8 @@ typedef struct {
 
 extern	clipMap_t	cm;
 extern	int			c_pointcontents;
+// counted per thread as points are looked up from jobs, see CM_MergeThreadCounters
+extern	Q_THREAD_LOCAL int	c_threadpointcontents;
 extern	int			c_traces, c_brush_traces, c_patch_traces, c_terrain_patch_traces;
 extern	cvar_t		*cm_noAreas;
 extern	cvar_t		*cm_noCurves;
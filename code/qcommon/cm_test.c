@@ -48,11 +48,25 @@ int CM_PointLeafnum_r( const vec3_t p, int num ) {
 			num = node->children[0];
 	}
 
-	c_pointcontents++;		// optimize counter
+	c_threadpointcontents++;		// optimize counter
 
 	return -1 - num;
 }
 
+/*
+==================
+CM_MergeThreadCounters
+
+Adds the points looked up by the calling thread to c_pointcontents.
+Job workers call it when they are done, and the main thread before
+reading the counter
+==================
+*/
+void CM_MergeThreadCounters( void ) {
+	c_pointcontents += c_threadpointcontents;
+	c_threadpointcontents = 0;
+}
+
 int CM_PointLeafnum( const vec3_t p ) {
 	if ( !cm.numNodes ) {	// map not loaded
 		return 0;
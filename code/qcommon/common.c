@@ -2479,6 +2479,9 @@ void Com_Frame( void ) {
 		extern	int c_traces, c_brush_traces, c_patch_traces, c_terrain_patch_traces;
 		extern	int	c_pointcontents;
 
+		// jobs have merged their counts when they finished
+		CM_MergeThreadCounters();
+
 		Com_Printf ("%4i traces  (%ib %ip %itp) %4i points\n", c_traces,
 			c_brush_traces, c_patch_traces, c_terrain_patch_traces, c_pointcontents);
 		c_traces = 0;
@@ -2501,6 +2504,8 @@ Com_Shutdown
 =================
 */
 void Com_Shutdown (void) {
+	Com_ShutdownJobs();
+
 	if (logfile) {
 		FS_FCloseFile (logfile);
 		logfile = 0;
@@ -27,7 +27,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "q_shared.h"
 #include "qcommon.h"
 
-static int			bloc = 0;
+// per thread, messages can be written from jobs
+static thread_local int	bloc = 0;
 
 void	Huff_putBit( int bit, byte *fout, int *offset) {
 	bloc = *offset;
@@ -394,7 +395,7 @@ void Huff_Decompress(msg_t *mbuf, int offset) {
 	Com_Memcpy(mbuf->data + offset, seq, cch);
 }
 
-extern 	int oldsize;
+extern thread_local int oldsize;
 
 void Huff_Compress(msg_t *mbuf, int offset) {
 	int			i, ch;
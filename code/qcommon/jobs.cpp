@@ -0,0 +1,278 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// jobs.cpp: Pool of worker threads for work that is split per item
+
+#include "q_shared.h"
+#include "qcommon.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobPool
+{
+public:
+    JobPool();
+    ~JobPool();
+
+    void Run(jobFunc_t func, void *data, int count, int numThreads);
+    void Shutdown();
+    void Lock();
+    void Unlock();
+
+private:
+    void Resize(int numWorkers);
+    void WorkerLoop(unsigned int generation);
+    void RunItems();
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex               mutex;
+    std::condition_variable  wake;
+    std::condition_variable  done;
+    // serializes code that isn't safe to run from jobs
+    std::mutex lock;
+
+    // current run
+    jobFunc_t        func;
+    void            *data;
+    int              count;
+    std::atomic<int> nextItem;
+    int              numBusyWorkers;
+    unsigned int     generation;
+    bool             quit;
+};
+
+static JobPool jobPool;
+
+JobPool::JobPool()
+    : func(NULL)
+    , data(NULL)
+    , count(0)
+    , nextItem(0)
+    , numBusyWorkers(0)
+    , generation(0)
+    , quit(false)
+{}
+
+JobPool::~JobPool()
+{
+    Shutdown();
+}
+
+/*
+===============
+JobPool::Run
+
+Calls func for each item, on the calling thread and on numThreads - 1 workers.
+Returns once all items are done
+===============
+*/
+void JobPool::Run(jobFunc_t newFunc, void *newData, int newCount, int numThreads)
+{
+    int i;
+
+    if (numThreads > newCount) {
+        numThreads = newCount;
+    }
+
+    if (numThreads <= 1) {
+        for (i = 0; i < newCount; i++) {
+            newFunc(newData, i);
+        }
+        return;
+    }
+
+    Resize(numThreads - 1);
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        func  = newFunc;
+        data  = newData;
+        count = newCount;
+        nextItem.store(0, std::memory_order_relaxed);
+        numBusyWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    RunItems();
+
+    std::unique_lock<std::mutex> guard(mutex);
+    done.wait(guard, [this] { return numBusyWorkers == 0; });
+
+    func = NULL;
+    data = NULL;
+}
+
+/*
+===============
+JobPool::Shutdown
+===============
+*/
+void JobPool::Shutdown()
+{
+    Resize(0);
+}
+
+void JobPool::Lock()
+{
+    lock.lock();
+}
+
+void JobPool::Unlock()
+{
+    lock.unlock();
+}
+
+/*
+===============
+JobPool::Resize
+
+Starts or stops workers, must not be called while running
+===============
+*/
+void JobPool::Resize(int numWorkers)
+{
+    size_t i;
+
+    if (workers.size() == (size_t)numWorkers) {
+        return;
+    }
+
+    if (workers.size()) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+
+        for (i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+        workers.clear();
+
+        quit = false;
+    }
+
+    for (i = 0; i < (size_t)numWorkers; i++) {
+        workers.emplace_back(&JobPool::WorkerLoop, this, generation);
+    }
+}
+
+/*
+===============
+JobPool::WorkerLoop
+===============
+*/
+void JobPool::WorkerLoop(unsigned int lastGeneration)
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(mutex);
+            wake.wait(guard, [this, lastGeneration] { return quit || generation != lastGeneration; });
+
+            if (quit) {
+                return;
+            }
+
+            lastGeneration = generation;
+        }
+
+        RunItems();
+
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            // the counters are read by the main thread once all workers are done
+            CM_MergeThreadCounters();
+
+            if (!--numBusyWorkers) {
+                done.notify_one();
+            }
+        }
+    }
+}
+
+/*
+===============
+JobPool::RunItems
+
+Takes items until there are none left
+===============
+*/
+void JobPool::RunItems()
+{
+    int item;
+
+    for (;;) {
+        item = nextItem.fetch_add(1, std::memory_order_relaxed);
+        if (item >= count) {
+            break;
+        }
+
+        func(data, item);
+    }
+}
+
+/*
+===============
+Com_RunJobs
+===============
+*/
+void Com_RunJobs(jobFunc_t func, void *data, int count, int numThreads)
+{
+    jobPool.Run(func, data, count, numThreads);
+}
+
+/*
+===============
+Com_ShutdownJobs
+===============
+*/
+void Com_ShutdownJobs(void)
+{
+    jobPool.Shutdown();
+}
+
+/*
+===============
+Com_JobLock
+===============
+*/
+void Com_JobLock(void)
+{
+    jobPool.Lock();
+}
+
+/*
+===============
+Com_JobUnlock
+===============
+*/
+void Com_JobUnlock(void)
+{
+    jobPool.Unlock();
+}
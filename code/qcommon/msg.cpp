@@ -22,11 +22,15 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "q_shared.h"
 #include "qcommon.h"
 
+#include <atomic>
+#include <cstdint>
+
 huffman_t msgHuff;
 
 qboolean msgInit = qfalse;
 
-int oldsize = 0;
+// per thread, messages can be written from jobs
+thread_local int oldsize = 0;
 
 // Changed in 2.0
 //  Network message profiling has been enabled starting Spearhead 2.0
@@ -173,7 +177,7 @@ bit functions
 =============================================================================
 */
 
-int	overflows;
+thread_local int	overflows;
 
 int MSG_WriteNegateValue_ver_15(int value, int bits)
 {
@@ -237,6 +241,234 @@ int MSG_ReadNegateValue(int value, int bits)
 	}
 }
 
+/*
+==============================================================================
+
+			HUFFMAN TABLES
+
+The message huffman tree never changes after MSG_initHuffman,
+so the code of each byte and the symbol of each short enough code
+are looked up instead of walking the tree for each bit.
+Bits are in message order, the first bit is the lowest one.
+==============================================================================
+*/
+
+// Codes up to this length are decoded with one lookup
+static constexpr int HUFF_DECODE_BITS = 11;
+// Longer codes are written by walking the tree
+static constexpr int HUFF_MAX_CODE_BITS = 32;
+// Bits that can be accumulated before writing them,
+// leaving room for the bits already in the first byte
+static constexpr int MSG_ACCUMULATOR_BITS = 56;
+
+typedef struct {
+	uint32_t	code;
+	int			length;		// 0 if the tree must be used
+} huffCode_t;
+
+typedef struct {
+	uint8_t		symbol;
+	uint8_t		length;		// 0 if the tree must be used
+} huffDecode_t;
+
+static huffCode_t	msgHuffCodes[HMAX];
+static huffDecode_t	msgHuffDecode[1 << HUFF_DECODE_BITS];
+
+/*
+=================
+MSG_BuildHuffmanEncode
+=================
+*/
+static void MSG_BuildHuffmanEncode( const huff_t *huff ) {
+	const node_t	*node;
+	uint32_t		code;
+	int				length;
+	int				ch;
+
+	for ( ch = 0; ch < HMAX; ch++ ) {
+		msgHuffCodes[ch].code = 0;
+		msgHuffCodes[ch].length = 0;
+
+		node = huff->loc[ch];
+		if ( !node ) {
+			continue;
+		}
+
+		// the code is sent from the root, so the last bit found is the first one
+		code = 0;
+		length = 0;
+		for ( ; node->parent; node = node->parent ) {
+			if ( length == HUFF_MAX_CODE_BITS ) {
+				length = 0;
+				break;
+			}
+			code = ( code << 1 ) | ( node->parent->right == node ? 1 : 0 );
+			length++;
+		}
+
+		msgHuffCodes[ch].code = code;
+		msgHuffCodes[ch].length = length;
+	}
+}
+
+/*
+=================
+MSG_BuildHuffmanDecode
+
+Fills the entries of every code starting with the path to node
+=================
+*/
+static void MSG_BuildHuffmanDecode( const node_t *node, int code, int length ) {
+	int i;
+
+	if ( !node || length > HUFF_DECODE_BITS ) {
+		return;
+	}
+
+	if ( node->symbol == INTERNAL_NODE ) {
+		MSG_BuildHuffmanDecode( node->left, code, length + 1 );
+		MSG_BuildHuffmanDecode( node->right, code | ( 1 << length ), length + 1 );
+		return;
+	}
+
+	if ( node->symbol >= HMAX ) {
+		// NYT is left to the tree
+		return;
+	}
+
+	for ( i = 0; i < ( 1 << ( HUFF_DECODE_BITS - length ) ); i++ ) {
+		msgHuffDecode[code | ( i << length )].symbol = node->symbol;
+		msgHuffDecode[code | ( i << length )].length = length;
+	}
+}
+
+/*
+=================
+MSG_BuildHuffmanTables
+=================
+*/
+static void MSG_BuildHuffmanTables( void ) {
+	Com_Memset( msgHuffDecode, 0, sizeof( msgHuffDecode ) );
+
+	MSG_BuildHuffmanEncode( &msgHuff.compressor );
+	MSG_BuildHuffmanDecode( msgHuff.decompressor.tree, 0, 0 );
+}
+
+/*
+=================
+MSG_PutBits
+
+Writes accumulated bits, same as Huff_putBit for each bit.
+The message must have room for them
+=================
+*/
+static void MSG_PutBits( msg_t *msg, uint64_t bits, int numBits ) {
+	byte	*out;
+	int		shift;
+	int		n;
+
+	out = &msg->data[msg->bit >> 3];
+	shift = msg->bit & 7;
+	if ( shift ) {
+		// keep the bits already written in the first byte
+		bits = ( bits << shift ) | ( out[0] & ( ( 1 << shift ) - 1 ) );
+	}
+
+	for ( n = shift + numBits; n > 0; n -= 8 ) {
+		*out++ = (byte)bits;
+		bits >>= 8;
+	}
+
+	msg->bit += numBits;
+}
+
+/*
+=================
+MSG_WriteHuffmanBits
+
+Writes bits with the huffman tables, returns false if the tree
+must be used instead because the message may overflow or a code is too long
+=================
+*/
+static qboolean MSG_WriteHuffmanBits( msg_t *msg, unsigned int value, int bits ) {
+	const huffCode_t	*code;
+	uint64_t			acc;
+	int					accBits;
+	int					totalBits;
+	int					nbits;
+	int					i;
+
+	nbits = bits & 7;
+	totalBits = nbits;
+	for ( i = nbits; i < bits; i += 8 ) {
+		code = &msgHuffCodes[( value >> i ) & 0xff];
+		if ( !code->length ) {
+			return qfalse;
+		}
+		totalBits += code->length;
+	}
+
+	if ( msg->bit + totalBits >= msg->maxsize << 3 ) {
+		// let the tree handle the overflow
+		return qfalse;
+	}
+
+	acc = value & ( ( 1 << nbits ) - 1 );
+	accBits = nbits;
+	value >>= nbits;
+
+	for ( i = nbits; i < bits; i += 8 ) {
+#if NET_MESSAGE_PROFILING
+		huffstats[value & 0xff]++;
+#endif
+		code = &msgHuffCodes[value & 0xff];
+		if ( accBits + code->length > MSG_ACCUMULATOR_BITS ) {
+			MSG_PutBits( msg, acc, accBits );
+			acc = 0;
+			accBits = 0;
+		}
+
+		acc |= (uint64_t)code->code << accBits;
+		accBits += code->length;
+		value >>= 8;
+	}
+
+	if ( accBits ) {
+		MSG_PutBits( msg, acc, accBits );
+	}
+
+	msg->cursize = ( msg->bit >> 3 ) + 1;
+	return qtrue;
+}
+
+/*
+=================
+MSG_PeekBits
+
+Returns up to 24 bits starting at the read position,
+the bits must be in the message
+=================
+*/
+static unsigned int MSG_PeekBits( const msg_t *msg, int bits ) {
+	const byte		*in;
+	unsigned int	value;
+	int				shift;
+
+	in = &msg->data[msg->bit >> 3];
+	shift = msg->bit & 7;
+
+	// don't read bytes past the bits
+	value = in[0];
+	if ( shift + bits > 8 ) {
+		value |= in[1] << 8;
+		if ( shift + bits > 16 ) {
+			value |= in[2] << 16;
+		}
+	}
+
+	return ( value >> shift ) & ( ( 1 << bits ) - 1 );
+}
+
 // negative bit values include signs
 void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 	int	i;
@@ -300,6 +532,10 @@ void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 		}
 	} else {
 		value &= (0xffffffff>>(32-bits));
+		if (MSG_WriteHuffmanBits(msg, value, bits)) {
+			return;
+		}
+
 		if (bits&7) {
 			int nbits;
 			nbits = bits&7;
@@ -387,14 +623,24 @@ int MSG_ReadBits( msg_t *msg, int bits ) {
 				msg->readcount = msg->cursize + 1;
 				return 0;
 			}
-			for(i=0;i<nbits;i++) {
-				value |= (Huff_getBit(msg->data, &msg->bit)<<i);
-			}
+			value = MSG_PeekBits(msg, nbits);
+			msg->bit += nbits;
 			bits = bits - nbits;
 		}
 		if (bits) {
 			for(i=0;i<bits;i+=8) {
-				Huff_offsetReceive (msgHuff.decompressor.tree, &get, msg->data, &msg->bit, msg->cursize<<3);
+				const huffDecode_t *decode = NULL;
+
+				if (msg->bit + HUFF_DECODE_BITS <= msg->cursize << 3) {
+					decode = &msgHuffDecode[MSG_PeekBits(msg, HUFF_DECODE_BITS)];
+				}
+
+				if (decode && decode->length) {
+					get = decode->symbol;
+					msg->bit += decode->length;
+				} else {
+					Huff_offsetReceive (msgHuff.decompressor.tree, &get, msg->data, &msg->bit, msg->cursize<<3);
+				}
 				value |= (get<<(i+nbits));
 
 				if (msg->bit > msg->cursize<<3) {
@@ -2433,6 +2679,312 @@ void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entity
 	}
 }
 
+/*
+=============================================================================
+
+entityState_t delta cache
+
+Clients often delta the same entity from the same state, like the baseline
+or the state of the previous frame. The encoded delta only depends on the
+states, so it's written once and the bits are copied to the other messages.
+The message huffman tree is static, so the bits are the same wherever they are
+written in the message.
+Entries can be used and added from multiple threads at the same time.
+
+=============================================================================
+*/
+
+#define DELTA_CACHE_SIZE      2048 // must be a power of 2
+#define DELTA_CACHE_PROBES    8
+#define DELTA_CACHE_MAX_BYTES 384
+
+typedef struct {
+    // generation * 2 while being written, generation * 2 + 1 once ready
+    std::atomic<unsigned int> state;
+
+    int           number;
+    qboolean      force;
+    float         frameTime;
+    entityState_t from;
+    entityState_t to;
+    // -1 if the delta is too big to be cached
+    int  numBits;
+    byte data[DELTA_CACHE_MAX_BYTES];
+    // profiling counters updated when the delta was written,
+    // they are updated again each time it's taken from the cache
+    int  sizeBits;
+    int  numOverflows;
+    int  numChangedFields;
+    byte changedFields[numBiggestEntityStateFields];
+} deltaCacheEntry_t;
+
+static deltaCacheEntry_t *deltaCache;
+static unsigned int       deltaCacheGeneration;
+static std::atomic<int>   deltaCacheLookups;
+static std::atomic<int>   deltaCacheHits;
+
+/*
+=================
+MSG_ClearDeltaCache
+
+Drops all entries, must not be called while messages are being written
+=================
+*/
+void MSG_ClearDeltaCache(void)
+{
+    int i;
+
+    if (!deltaCache) {
+        deltaCache = new deltaCacheEntry_t[DELTA_CACHE_SIZE];
+        for (i = 0; i < DELTA_CACHE_SIZE; i++) {
+            deltaCache[i].state.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    deltaCacheGeneration++;
+    if (deltaCacheGeneration >= 0x7FFFFFFF) {
+        for (i = 0; i < DELTA_CACHE_SIZE; i++) {
+            deltaCache[i].state.store(0, std::memory_order_relaxed);
+        }
+        deltaCacheGeneration = 1;
+    }
+}
+
+/*
+=================
+MSG_GetDeltaCacheStats
+=================
+*/
+void MSG_GetDeltaCacheStats(int *lookups, int *hits)
+{
+    *lookups = deltaCacheLookups.load(std::memory_order_relaxed);
+    *hits    = deltaCacheHits.load(std::memory_order_relaxed);
+}
+
+/*
+=================
+MSG_ResetDeltaCacheStats
+=================
+*/
+void MSG_ResetDeltaCacheStats(void)
+{
+    deltaCacheLookups.store(0, std::memory_order_relaxed);
+    deltaCacheHits.store(0, std::memory_order_relaxed);
+}
+
+static unsigned int MSG_HashEntityState(const entityState_t *state, unsigned int hash)
+{
+    const unsigned int *p = (const unsigned int *)state;
+    size_t              i;
+
+    for (i = 0; i < sizeof(*state) / sizeof(*p); i++) {
+        hash = (hash ^ p[i]) * 16777619;
+    }
+
+    return hash;
+}
+
+/*
+=================
+MSG_WriteEncodedBits
+
+Appends bits that were written by MSG_WriteBits to another message
+=================
+*/
+static void MSG_WriteEncodedBits(msg_t *msg, const byte *data, int numBits)
+{
+    byte *out;
+    int   shift;
+    int   n;
+
+    if (msg->overflowed || !numBits) {
+        return;
+    }
+
+    if (msg->bit + numBits >= msg->maxsize << 3) {
+        msg->overflowed = qtrue;
+        return;
+    }
+
+    while (numBits > 0) {
+        n     = numBits < 8 ? numBits : 8;
+        out   = &msg->data[msg->bit >> 3];
+        shift = msg->bit & 7;
+
+        // same as Huff_putBit, a byte is cleared when starting it
+        if (!shift) {
+            out[0] = *data;
+        } else {
+            out[0] |= *data << shift;
+            if (shift + n > 8) {
+                out[1] = *data >> (8 - shift);
+            }
+        }
+
+        data++;
+        msg->bit += n;
+        numBits -= n;
+    }
+
+    msg->cursize = (msg->bit >> 3) + 1;
+}
+
+/*
+=================
+MSG_DeltaCacheSetCounters
+
+Keeps what writing the delta added to the profiling counters
+=================
+*/
+static void MSG_DeltaCacheSetCounters(
+    deltaCacheEntry_t *entry, const entityState_t *from, const entityState_t *to, int startSize, int startOverflows
+)
+{
+    netField_t *entityStateFields;
+    netField_t *field;
+    size_t      numFields;
+    size_t      i;
+
+    entry->sizeBits         = oldsize - startSize;
+    entry->numOverflows     = overflows - startOverflows;
+    entry->numChangedFields = 0;
+
+    entityStateFields = MSG_GetEntityStateFields(numFields);
+    for (i = 0, field = entityStateFields; i < numFields; i++, field++) {
+        if (MSG_DeltaNeeded(
+                (const byte *)from + field->offset, (const byte *)to + field->offset, field->type, field->bits, field->size
+            )) {
+            entry->changedFields[entry->numChangedFields++] = i;
+        }
+    }
+}
+
+/*
+=================
+MSG_DeltaCacheAddCounters
+
+Updates the profiling counters like writing the delta would have.
+The value statistics used to tune the Huffman table are only counted when the delta is written
+=================
+*/
+static void MSG_DeltaCacheAddCounters(const deltaCacheEntry_t *entry)
+{
+    int i;
+
+    oldsize += entry->sizeBits;
+    overflows += entry->numOverflows;
+
+#if NET_MESSAGE_PROFILING
+    for (i = 0; i < entry->numChangedFields; i++) {
+        iEntityFieldChanges[entry->changedFields[i] % ARRAY_LEN(iEntityFieldChanges)]++;
+    }
+#endif
+}
+
+static qboolean MSG_DeltaCacheEntryMatches(
+    const deltaCacheEntry_t *entry, const entityState_t *from, const entityState_t *to, qboolean force, float frameTime
+)
+{
+    return entry->number == to->number && entry->force == force && entry->frameTime == frameTime
+        && !memcmp(&entry->to, to, sizeof(*to)) && !memcmp(&entry->from, from, sizeof(*from));
+}
+
+/*
+=================
+MSG_WriteDeltaEntityCached
+
+Same as MSG_WriteDeltaEntity, but the delta is taken from the cache if it was already written.
+Both states are required
+=================
+*/
+void MSG_WriteDeltaEntityCached(
+    msg_t *msg, struct entityState_s *from, struct entityState_s *to, qboolean force, float frameTime
+)
+{
+    deltaCacheEntry_t *entry;
+    msg_t              encoded;
+    byte               encodedData[1024];
+    unsigned int       hash;
+    unsigned int       generation;
+    unsigned int       state;
+    int                startSize;
+    int                startOverflows;
+    int                i;
+
+    if (!force && !memcmp(from, to, sizeof(*to))) {
+        // nothing is written for unchanged entities
+        return;
+    }
+
+    if (!deltaCache || msg->oob || msg->overflowed) {
+        MSG_WriteDeltaEntity(msg, from, to, force, frameTime);
+        return;
+    }
+
+    deltaCacheLookups.fetch_add(1, std::memory_order_relaxed);
+
+    hash       = MSG_HashEntityState(to, MSG_HashEntityState(from, 2166136261u ^ to->number ^ (force << 16)));
+    generation = deltaCacheGeneration;
+
+    for (i = 0; i < DELTA_CACHE_PROBES; i++) {
+        entry = &deltaCache[(hash + i) & (DELTA_CACHE_SIZE - 1)];
+        state = entry->state.load(std::memory_order_acquire);
+
+        if (state == generation * 2 + 1) {
+            if (!MSG_DeltaCacheEntryMatches(entry, from, to, force, frameTime)) {
+                continue;
+            }
+
+            if (entry->numBits < 0) {
+                break;
+            }
+
+            deltaCacheHits.fetch_add(1, std::memory_order_relaxed);
+            MSG_DeltaCacheAddCounters(entry);
+            MSG_WriteEncodedBits(msg, entry->data, entry->numBits);
+            return;
+        }
+
+        if (state == generation * 2) {
+            // another thread is writing it
+            continue;
+        }
+
+        // stale entry, take it
+        if (!entry->state.compare_exchange_strong(state, generation * 2, std::memory_order_acquire)) {
+            continue;
+        }
+
+        startSize      = oldsize;
+        startOverflows = overflows;
+
+        MSG_Init(&encoded, encodedData, sizeof(encodedData));
+        MSG_WriteDeltaEntity(&encoded, from, to, force, frameTime);
+        MSG_DeltaCacheSetCounters(entry, from, to, startSize, startOverflows);
+
+        entry->number    = to->number;
+        entry->force     = force;
+        entry->frameTime = frameTime;
+        entry->from      = *from;
+        entry->to        = *to;
+        if (!encoded.overflowed && encoded.bit <= DELTA_CACHE_MAX_BYTES * 8) {
+            entry->numBits = encoded.bit;
+            Com_Memcpy(entry->data, encoded.data, (encoded.bit + 7) >> 3);
+        } else {
+            entry->numBits = -1;
+        }
+        entry->state.store(generation * 2 + 1, std::memory_order_release);
+
+        if (entry->numBits >= 0) {
+            MSG_WriteEncodedBits(msg, entry->data, entry->numBits);
+            return;
+        }
+        break;
+    }
+
+    MSG_WriteDeltaEntity(msg, from, to, force, frameTime);
+}
+
 int MSG_PackAngle(float angle, int bits)
 {
 	int bit;
@@ -4249,4 +4801,6 @@ void MSG_initHuffman( void ) {
 			Huff_addRef(&msgHuff.decompressor,	(byte)i);			// Do update
 		}
 	}
+
+	MSG_BuildHuffmanTables();
 }
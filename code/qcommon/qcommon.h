@@ -118,6 +118,11 @@ void MSG_ReadDeltaUsercmdKey( msg_t *msg, int key, usercmd_t *from, usercmd_t *t
 
 void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entityState_s *to
 						   , qboolean force, float frameTime);
+void MSG_WriteDeltaEntityCached( msg_t *msg, struct entityState_s *from, struct entityState_s *to
+						   , qboolean force, float frameTime);
+void MSG_ClearDeltaCache(void);
+void MSG_GetDeltaCacheStats(int *lookups, int *hits);
+void MSG_ResetDeltaCacheStats(void);
 
 void MSG_ReadSounds (msg_t *msg, server_sound_t *sounds, int *snapshot_number_of_sounds);
 void MSG_WriteSounds (msg_t *msg, server_sound_t *sounds, int snapshot_number_of_sounds);
@@ -1011,6 +1016,17 @@ void		Com_RunAndTimeServerPacket(netadr_t *evFrom, msg_t *buf);
 
 qboolean	Com_IsVoipTarget(uint8_t *voipTargets, int voipTargetsSize, int clientNum);
 
+// jobs.cpp
+typedef void (*jobFunc_t)(void *data, int index);
+
+// calls func for each index in [0, count), spread over numThreads threads including the caller,
+// and returns once all of them are done
+void		Com_RunJobs(jobFunc_t func, void *data, int count, int numThreads);
+void		Com_ShutdownJobs(void);
+// serializes code that isn't thread-safe when called from jobs
+void		Com_JobLock(void);
+void		Com_JobUnlock(void);
+
 void		Com_StartupVariable( const char *match );
 // checks for and removes command line "+set var arg" constructs
 // if match is NULL, all set commands will be executed, otherwise
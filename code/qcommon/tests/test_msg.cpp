@@ -0,0 +1,353 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../q_shared.h"
+#include "../qcommon.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static const int NUM_PAYLOADS = 64;
+static const int PAYLOAD_SIZE = 1400;
+static const int NUM_ROUNDS   = 50;
+
+extern "C" {
+cvar_t *cl_shownet;
+cvar_t *com_protocol;
+}
+
+extern huffman_t msgHuff;
+
+struct writeOp {
+    int value;
+    int bits;
+};
+
+struct payload {
+    std::vector<writeOp> ops;
+    byte                 data[MAX_MSGLEN];
+    int                  cursize;
+    int                  bit;
+};
+
+static std::vector<payload> payloads;
+
+/*
+ * The bit writer and reader before the huffman tables,
+ * to check the messages don't change.
+ */
+static void ref_write_bits(msg_t *msg, int value, int bits)
+{
+    int i;
+
+    if (msg->overflowed) {
+        return;
+    }
+
+    value &= (0xffffffff >> (32 - bits));
+    if (bits & 7) {
+        int nbits = bits & 7;
+        if (msg->bit + nbits >= msg->maxsize << 3) {
+            msg->overflowed = qtrue;
+            return;
+        }
+        for (i = 0; i < nbits; i++) {
+            Huff_putBit((value & 1), msg->data, &msg->bit);
+            value = (value >> 1);
+        }
+        bits = bits - nbits;
+    }
+    if (bits) {
+        for (i = 0; i < bits; i += 8) {
+            Huff_offsetTransmit(&msgHuff.compressor, (value & 0xff), msg->data, &msg->bit, msg->maxsize << 3);
+            value = (value >> 8);
+
+            if (msg->bit >= msg->maxsize << 3) {
+                msg->overflowed = qtrue;
+                return;
+            }
+        }
+    }
+    msg->cursize = (msg->bit >> 3) + 1;
+}
+
+static int ref_read_bits(msg_t *msg, int bits)
+{
+    int value, get, i, nbits;
+
+    if (msg->readcount > msg->cursize) {
+        return 0;
+    }
+
+    value = 0;
+    nbits = 0;
+    if (bits & 7) {
+        nbits = bits & 7;
+        if (msg->bit + nbits > msg->cursize << 3) {
+            msg->readcount = msg->cursize + 1;
+            return 0;
+        }
+        for (i = 0; i < nbits; i++) {
+            value |= (Huff_getBit(msg->data, &msg->bit) << i);
+        }
+        bits = bits - nbits;
+    }
+    if (bits) {
+        for (i = 0; i < bits; i += 8) {
+            Huff_offsetReceive(msgHuff.decompressor.tree, &get, msg->data, &msg->bit, msg->cursize << 3);
+            value |= (get << (i + nbits));
+
+            if (msg->bit > msg->cursize << 3) {
+                msg->readcount = msg->cursize + 1;
+                return 0;
+            }
+        }
+    }
+    msg->readcount = (msg->bit >> 3) + 1;
+
+    return value;
+}
+
+static int mask_value(int value, int bits)
+{
+    return value & (0xffffffff >> (32 - bits));
+}
+
+/*
+ * Generates the writes of a snapshot: entity numbers, change bits,
+ * field counts and field values, mostly small or unchanged.
+ */
+static void random_op(writeOp& op)
+{
+    static const int fieldBits[] = {1, 1, 1, 1, 1, 1, 2, 5, 6, 8, 8, 10, 12, 16, 16, 17, 19, 20, 24, 32};
+
+    op.bits = fieldBits[rand() % ARRAY_LEN(fieldBits)];
+    switch (rand() % 4) {
+    case 0:
+        op.value = 0;
+        break;
+    case 1:
+        op.value = mask_value(rand() & 0xff, op.bits);
+        break;
+    default:
+        op.value = mask_value(rand() ^ (rand() << 16), op.bits);
+        break;
+    }
+}
+
+static void generate_payloads()
+{
+    msg_t   msg;
+    writeOp op;
+    int     i;
+
+    payloads.resize(NUM_PAYLOADS);
+
+    for (i = 0; i < NUM_PAYLOADS; i++) {
+        payload& p = payloads[i];
+
+        MSG_Init(&msg, p.data, sizeof(p.data));
+        while (msg.cursize < PAYLOAD_SIZE) {
+            random_op(op);
+            p.ops.push_back(op);
+            ref_write_bits(&msg, op.value, op.bits);
+        }
+        p.cursize = msg.cursize;
+        p.bit     = msg.bit;
+    }
+}
+
+bool test_write()
+{
+    byte  data[MAX_MSGLEN];
+    msg_t msg;
+    int   i;
+
+    for (i = 0; i < NUM_PAYLOADS; i++) {
+        const payload& p = payloads[i];
+
+        MSG_Init(&msg, data, sizeof(data));
+        for (const writeOp& op : p.ops) {
+            MSG_WriteBits(&msg, op.value, op.bits);
+        }
+
+        // the last byte counted by cursize isn't always written
+        if (msg.cursize != p.cursize || msg.bit != p.bit || memcmp(data, p.data, (p.bit + 7) >> 3)) {
+            std::cerr << "Payload " << i << " is written differently" << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "Checked writing " << NUM_PAYLOADS << " payloads" << std::endl;
+    return true;
+}
+
+bool test_read()
+{
+    payload copy;
+    msg_t   msg, ref;
+    int     value;
+    int     i;
+
+    for (i = 0; i < NUM_PAYLOADS; i++) {
+        const payload& p = payloads[i];
+
+        copy = p;
+        MSG_Init(&msg, copy.data, sizeof(copy.data));
+        msg.cursize = p.cursize;
+        MSG_BeginReading(&msg);
+
+        for (const writeOp& op : p.ops) {
+            value = MSG_ReadBits(&msg, op.bits);
+            if (value != op.value) {
+                std::cerr << "Payload " << i << " read " << value << " instead of " << op.value << std::endl;
+                return false;
+            }
+        }
+
+        // reading past the end must stop at the same place
+        ref = msg;
+        while (msg.readcount <= msg.cursize) {
+            value = MSG_ReadBits(&msg, 8);
+            if (value != ref_read_bits(&ref, 8) || msg.bit != ref.bit || msg.readcount != ref.readcount) {
+                std::cerr << "Payload " << i << " reads past the end differently" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "Checked reading " << NUM_PAYLOADS << " payloads" << std::endl;
+    return true;
+}
+
+bool test_overflow()
+{
+    byte    data[MAX_MSGLEN], refData[MAX_MSGLEN];
+    msg_t   msg, ref;
+    writeOp op;
+    int     size;
+
+    for (size = 1; size < 64; size++) {
+        MSG_Init(&msg, data, size);
+        MSG_Init(&ref, refData, size);
+
+        while (!ref.overflowed) {
+            random_op(op);
+            MSG_WriteBits(&msg, op.value, op.bits);
+            ref_write_bits(&ref, op.value, op.bits);
+
+            if (msg.overflowed != ref.overflowed || msg.bit != ref.bit || msg.cursize != ref.cursize) {
+                std::cerr << "Message of " << size << " bytes overflows differently" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "Checked overflows" << std::endl;
+    return true;
+}
+
+void benchmark_payloads()
+{
+    std::chrono::steady_clock::time_point start;
+    double                                writeTime, refWriteTime, readTime, refReadTime;
+    byte                                  data[MAX_MSGLEN];
+    msg_t                                 msg;
+    int                                   total;
+    int                                   round;
+    int                                   numBytes;
+
+    numBytes = 0;
+    for (const payload& p : payloads) {
+        numBytes += p.cursize;
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (round = 0; round < NUM_ROUNDS; round++) {
+        for (const payload& p : payloads) {
+            MSG_Init(&msg, data, sizeof(data));
+            for (const writeOp& op : p.ops) {
+                MSG_WriteBits(&msg, op.value, op.bits);
+            }
+        }
+    }
+    writeTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (round = 0; round < NUM_ROUNDS; round++) {
+        for (const payload& p : payloads) {
+            MSG_Init(&msg, data, sizeof(data));
+            for (const writeOp& op : p.ops) {
+                ref_write_bits(&msg, op.value, op.bits);
+            }
+        }
+    }
+    refWriteTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    total = 0;
+    start = std::chrono::steady_clock::now();
+    for (round = 0; round < NUM_ROUNDS; round++) {
+        for (payload& p : payloads) {
+            MSG_Init(&msg, p.data, sizeof(p.data));
+            msg.cursize = p.cursize;
+            for (const writeOp& op : p.ops) {
+                total += MSG_ReadBits(&msg, op.bits);
+            }
+        }
+    }
+    readTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (round = 0; round < NUM_ROUNDS; round++) {
+        for (payload& p : payloads) {
+            MSG_Init(&msg, p.data, sizeof(p.data));
+            msg.cursize = p.cursize;
+            for (const writeOp& op : p.ops) {
+                total -= ref_read_bits(&msg, op.bits);
+            }
+        }
+    }
+    refReadTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Write: " << numBytes * (double)NUM_ROUNDS / writeTime << " MB/s, tree: "
+              << numBytes * (double)NUM_ROUNDS / refWriteTime << " MB/s" << std::endl;
+    std::cout << "Read: " << numBytes * (double)NUM_ROUNDS / readTime << " MB/s, tree: "
+              << numBytes * (double)NUM_ROUNDS / refReadTime << " MB/s (difference " << total << ")" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    srand(1);
+    generate_payloads();
+
+    if (!test_write() || !test_read() || !test_overflow()) {
+        std::cerr << "Message bits failed!" << std::endl;
+        return 1;
+    }
+
+    benchmark_payloads();
+
+    return 0;
+}
@@ -65,6 +65,8 @@ void ScriptCompiler::Reset()
     m_iMaxCallStackOffset        = 0;
     m_iMaxExternalVarStackOffset = 0;
     m_iVarStackOffset            = 0;
+    m_iNumInlineCaches           = 0;
+    m_bOptimize                  = false;
 
     bCanBreak    = false;
     bCanContinue = false;
@@ -136,9 +138,13 @@ void ScriptCompiler::AddContinueJumpLocation(unsigned char *pos)
 
 void ScriptCompiler::AddJumpLocation(unsigned char *pos)
 {
-    unsigned int offset = code_pos - sizeof(unsigned int) - pos;
+    // The jump is NULL when it was optimized out
+    if (pos) {
+        unsigned int offset = code_pos - sizeof(unsigned int) - pos;
+
+        EmitAt(pos, offset, sizeof(offset));
+    }
 
-    EmitAt(pos, offset, sizeof(offset));
     ClearPrevOpcode();
 }
 
@@ -281,18 +287,87 @@ void ScriptCompiler::EmitAssignmentStatement(sval_t lhs, unsigned int sourcePos)
     }
 
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+    EmitInlineCacheIndex();
 }
 
 void ScriptCompiler::EmitBoolJumpFalse(unsigned int sourcePos)
 {
     if (PrevOpcode() == OP_UN_CAST_BOOLEAN) {
         AbsorbPrevOpcode();
-        EmitOpcode(OP_VAR_JUMP_FALSE4, sourcePos);
+
+        const int compareOpcode = PrevOpcode();
+
+        if (m_bOptimize && compareOpcode >= OP_BIN_EQUALITY && compareOpcode <= OP_BIN_GREATER_THAN_OR_EQUAL) {
+            // Compare and jump with a single opcode
+            AbsorbPrevOpcode();
+
+            if (!EmitLocalCompareJumpFalse(compareOpcode, sourcePos)) {
+                EmitOpcode(OP_BIN_COMPARE_JUMP_FALSE4, sourcePos);
+                EmitOpcodeValue((byte)compareOpcode, sizeof(byte));
+            }
+        } else {
+            EmitOpcode(OP_VAR_JUMP_FALSE4, sourcePos);
+        }
     } else {
         EmitOpcode(OP_BOOL_JUMP_FALSE4, sourcePos);
     }
 }
 
+/*
+====================
+EmitLocalCompareJumpFalse
+
+Fuses a local variable compared with a constant into the conditional jump.
+The constant is pushed first, it has no side effect so the order doesn't matter
+====================
+*/
+bool ScriptCompiler::EmitLocalCompareJumpFalse(int compareOpcode, unsigned int sourcePos)
+{
+    ScriptVariable value;
+    unsigned char  constant[sizeof(unsigned int)];
+    unsigned char  field[sizeof(op_name_t) + sizeof(op_cacheIndex_t)];
+    unsigned char *old_code_pos;
+    unsigned int   old_prev_opcode_pos;
+    int            old_var_stack_offset;
+    int            constantOpcode;
+    int            constantLength;
+
+    if (!EvalPrevConstant(value)) {
+        return false;
+    }
+
+    constantOpcode = PrevOpcode();
+    constantLength = OpcodeLength(constantOpcode) - 1;
+    Com_Memcpy(constant, code_pos - constantLength, constantLength);
+
+    old_code_pos         = code_pos;
+    old_prev_opcode_pos  = prev_opcode_pos;
+    old_var_stack_offset = m_iVarStackOffset;
+
+    AbsorbPrevOpcode();
+
+    if (PrevOpcode() != OP_STORE_LOCAL_VAR) {
+        code_pos          = old_code_pos;
+        prev_opcode_pos   = old_prev_opcode_pos;
+        m_iVarStackOffset = old_var_stack_offset;
+        return false;
+    }
+
+    Com_Memcpy(field, code_pos - sizeof(field), sizeof(field));
+    AbsorbPrevOpcode();
+
+    // The VM loads the variable above the constant,
+    // the stack size already counts both values
+    EmitOpcode(constantOpcode, sourcePos);
+    EmitOpcodeValue(constant, constantLength);
+
+    EmitOpcode(OP_LOCAL_COMPARE_JUMP_FALSE4, sourcePos);
+    EmitOpcodeValue(field, sizeof(field));
+    EmitOpcodeValue((byte)compareOpcode, sizeof(byte));
+
+    return true;
+}
+
 void ScriptCompiler::EmitBoolJumpTrue(unsigned int sourcePos)
 {
     if (PrevOpcode() == OP_UN_CAST_BOOLEAN) {
@@ -440,11 +515,7 @@ void ScriptCompiler::EmitDoWhileJump(sval_t while_stmt, sval_t while_expr, unsig
     EmitValue(while_expr);
     EmitVarToBool(sourcePos);
 
-    label2 = EmitNot(sourcePos);
-
-    unsigned char *jmp = code_pos;
-
-    code_pos += sizeof(unsigned int);
+    unsigned char *jmp = EmitNotJump(sourcePos, label2);
 
     if (showopcodes->integer) {
         glbs.DPrintf("JUMP_BACK4 <LABEL%d>\n", label1);
@@ -501,20 +572,23 @@ void ScriptCompiler::EmitField(sval_t listener_val, sval_t field_val, unsigned i
     index    = Director.AddString(name);
     eventnum = Event::FindGetterEventNum(name);
 
-    prev_index = GetOpcodeValue<unsigned int>(sizeof(unsigned int), sizeof(unsigned int));
+    prev_index = GetOpcodeValue<unsigned int>(sizeof(op_name_t) + sizeof(op_cacheIndex_t), sizeof(op_name_t));
 
     if (listener_val.node[0].type != ENUM_listener
         || (eventnum && BuiltinReadVariable(sourcePos, listener_val.node[1].intValue, eventnum))) {
         EmitValue(listener_val);
         EmitOpcode(OP_STORE_FIELD, sourcePos);
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+        EmitInlineCacheIndex();
     } else if (PrevOpcode() != (OP_LOAD_GAME_VAR + listener_val.node[1].intValue) || prev_index != index) {
         EmitOpcode(OP_STORE_GAME_VAR + listener_val.node[1].intValue, sourcePos);
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+        EmitInlineCacheIndex();
     } else {
         AbsorbPrevOpcode();
         EmitOpcode(OP_LOAD_STORE_GAME_VAR + listener_val.node[1].intValue, sourcePos);
-        code_pos += sizeof(unsigned int);
+        // Keep the name and the inline cache of the absorbed opcode
+        code_pos += sizeof(op_name_t) + sizeof(op_cacheIndex_t);
     }
 }
 
@@ -525,6 +599,102 @@ void ScriptCompiler::EmitFloat(float value, unsigned int sourcePos)
     EmitOpcodeValue(value, sizeof(float));
 }
 
+void ScriptCompiler::EmitFunc2(int opcode, unsigned int sourcePos)
+{
+    if (m_bOptimize) {
+        ScriptVariable lhs;
+        ScriptVariable rhs;
+
+        if (EvalPrevConstants(lhs, rhs)) {
+            bool folded = true;
+
+            try {
+                switch (opcode) {
+                case OP_BIN_BITWISE_AND:
+                    lhs &= rhs;
+                    break;
+                case OP_BIN_BITWISE_OR:
+                    lhs |= rhs;
+                    break;
+                case OP_BIN_BITWISE_EXCL_OR:
+                    lhs ^= rhs;
+                    break;
+                case OP_BIN_EQUALITY:
+                    lhs.setIntValue(lhs == rhs);
+                    break;
+                case OP_BIN_INEQUALITY:
+                    lhs.setIntValue(lhs != rhs);
+                    break;
+                case OP_BIN_LESS_THAN:
+                    lhs.lessthan(rhs);
+                    break;
+                case OP_BIN_GREATER_THAN:
+                    lhs.greaterthan(rhs);
+                    break;
+                case OP_BIN_LESS_THAN_OR_EQUAL:
+                    lhs.lessthanorequal(rhs);
+                    break;
+                case OP_BIN_GREATER_THAN_OR_EQUAL:
+                    lhs.greaterthanorequal(rhs);
+                    break;
+                case OP_BIN_PLUS:
+                    lhs += rhs;
+                    break;
+                case OP_BIN_MINUS:
+                    lhs -= rhs;
+                    break;
+                case OP_BIN_MULTIPLY:
+                    lhs *= rhs;
+                    break;
+                case OP_BIN_DIVIDE:
+                case OP_BIN_PERCENTAGE:
+                    // Let the VM report divisions by zero
+                    if (!rhs.booleanValue()) {
+                        folded = false;
+                    } else if (opcode == OP_BIN_DIVIDE) {
+                        lhs /= rhs;
+                    } else {
+                        lhs %= rhs;
+                    }
+                    break;
+                case OP_BIN_SHIFT_LEFT:
+                    lhs <<= rhs;
+                    break;
+                case OP_BIN_SHIFT_RIGHT:
+                    lhs >>= rhs;
+                    break;
+                default:
+                    folded = false;
+                    break;
+                }
+            } catch (ScriptException&) {
+                // Incompatible types, the VM will report the error at runtime
+                folded = false;
+            }
+
+            switch (lhs.GetType()) {
+            case VARIABLE_INTEGER:
+            case VARIABLE_FLOAT:
+            case VARIABLE_STRING:
+            case VARIABLE_CONSTSTRING:
+                break;
+            default:
+                folded = false;
+                break;
+            }
+
+            if (folded) {
+                AbsorbPrevOpcode();
+                AbsorbPrevOpcode();
+
+                return EmitValue(lhs, sourcePos);
+            }
+        }
+    }
+
+    EmitOpcode(opcode, sourcePos);
+}
+
 void ScriptCompiler::EmitFunc1(int opcode, unsigned int sourcePos)
 {
     if (opcode == OP_UN_MINUS) {
@@ -588,10 +758,7 @@ void ScriptCompiler::EmitIfElseJump(sval_t if_stmt, sval_t else_stmt, unsigned i
     unsigned char *jmp1, *jmp2;
     int            label1, label2;
 
-    label1 = EmitNot(sourcePos);
-    jmp1   = code_pos;
-    code_pos += sizeof(unsigned int);
-    ClearPrevOpcode();
+    jmp1 = EmitNotJump(sourcePos, label1);
 
     EmitValue(if_stmt);
 
@@ -624,11 +791,9 @@ void ScriptCompiler::EmitIfJump(sval_t if_stmt, unsigned int sourcePos)
 {
     unsigned char *jmp;
 
-    int label = EmitNot(sourcePos);
-    jmp       = code_pos;
-    code_pos += sizeof(unsigned int);
+    int label;
 
-    ClearPrevOpcode();
+    jmp = EmitNotJump(sourcePos, label);
 
     EmitValue(if_stmt);
 
@@ -639,6 +804,12 @@ void ScriptCompiler::EmitIfJump(sval_t if_stmt, unsigned int sourcePos)
     AddJumpLocation(jmp);
 }
 
+void ScriptCompiler::EmitInlineCacheIndex()
+{
+    EmitOpcodeValue((op_cacheIndex_t)m_iNumInlineCaches, sizeof(op_cacheIndex_t));
+    m_iNumInlineCaches++;
+}
+
 void ScriptCompiler::EmitInteger(unsigned int value, unsigned int sourcePos)
 {
     if (value == 0) {
@@ -805,6 +976,7 @@ void ScriptCompiler::EmitMethodExpression(int iParamCount, int eventnum, unsigne
     }
 
     EmitOpcodeValue((unsigned int)eventnum, sizeof(unsigned int));
+    EmitInlineCacheIndex();
 }
 
 void ScriptCompiler::EmitNil(unsigned int sourcePos)
@@ -844,6 +1016,41 @@ int ScriptCompiler::EmitNot(unsigned int sourcePos)
     return label;
 }
 
+unsigned char *ScriptCompiler::EmitNotJump(unsigned int sourcePos, int& label)
+{
+    unsigned char *jmp;
+
+    label = 0;
+
+    if (m_bOptimize && PrevOpcode() == OP_BOOL_STORE_TRUE) {
+        // The condition is always true, so the jump is never taken
+        AbsorbPrevOpcode();
+        ClearPrevOpcode();
+        return NULL;
+    }
+
+    if (m_bOptimize && PrevOpcode() == OP_BOOL_STORE_FALSE) {
+        // The condition is always false, so always jump
+        AbsorbPrevOpcode();
+
+        if (showopcodes->integer) {
+            label = current_label++;
+            glbs.DPrintf("JUMP <LABEL%d>\n", label);
+        }
+
+        EmitOpcode(OP_JUMP4, sourcePos);
+    } else {
+        label = EmitNot(sourcePos);
+    }
+
+    jmp = code_pos;
+    code_pos += sizeof(unsigned int);
+
+    ClearPrevOpcode();
+
+    return jmp;
+}
+
 void ScriptCompiler::EmitOpcode(int opcode, unsigned int sourcePos)
 {
     int IsExternal;
@@ -934,6 +1141,7 @@ void ScriptCompiler::EmitParameter(sval_t lhs, unsigned int sourcePos)
 
         unsigned int index = Director.AddString(name);
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+        EmitInlineCacheIndex();
     }
 }
 
@@ -980,6 +1188,7 @@ void ScriptCompiler::EmitRef(sval_t val, unsigned int sourcePos)
     EmitValue(val.node[1]);
     EmitOpcode(OP_STORE_FIELD_REF, sourcePos);
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
+    EmitInlineCacheIndex();
 }
 
 void ScriptCompiler::EmitStatementList(sval_t val)
@@ -1037,6 +1246,8 @@ void ScriptCompiler::EmitValue(ScriptVariable& var, unsigned int sourcePos)
         EmitInteger(var.intValue(), sourcePos);
     } else if (var.GetType() == VARIABLE_FLOAT) {
         EmitFloat(var.floatValue(), sourcePos);
+    } else if (var.GetType() == VARIABLE_STRING || var.GetType() == VARIABLE_CONSTSTRING) {
+        EmitString(var.stringValue(), sourcePos);
     }
 }
 
@@ -1166,7 +1377,15 @@ __emit:
 
             EmitValue(val.node[1]);
 
-            if (iParamCount > 5) {
+            if (m_bOptimize && PrevOpcode() == OP_STORE_SELF) {
+                // Execute on self without pushing it
+                AbsorbPrevOpcode();
+
+                SetOpcodeVarStackOffset(OP_EXEC_CMD_SELF_METHOD_COUNT1, -(int32_t)iParamCount);
+                EmitOpcode(OP_EXEC_CMD_SELF_METHOD_COUNT1, val.node[4].sourcePosValue);
+
+                EmitOpcodeValue((byte)iParamCount, sizeof(byte));
+            } else if (iParamCount > 5) {
                 SetOpcodeVarStackOffset(OP_EXEC_CMD_COUNT1, -(int32_t)iParamCount);
                 EmitOpcode(OP_EXEC_CMD_METHOD_COUNT1, val.node[4].sourcePosValue);
 
@@ -1176,6 +1395,7 @@ __emit:
             }
 
             EmitOpcodeValue((op_ev_t)eventnum, sizeof(op_ev_t));
+            EmitInlineCacheIndex();
             break;
         }
 
@@ -1250,7 +1470,7 @@ __emit:
     case ENUM_func2_expr:
         EmitValue(val.node[2]);
         EmitValue(val.node[3]);
-        EmitOpcode(val.node[1].byteValue, val.node[4].sourcePosValue);
+        EmitFunc2(val.node[1].byteValue, val.node[4].sourcePosValue);
         break;
 
     case ENUM_statement_list:
@@ -1335,10 +1555,7 @@ void ScriptCompiler::EmitWhileJump(sval_t while_expr, sval_t while_stmt, sval_t
     EmitValue(while_expr);
     EmitVarToBool(sourcePos);
 
-    label2             = EmitNot(sourcePos);
-    unsigned char *jmp = code_pos;
-    code_pos += sizeof(unsigned int);
-    ClearPrevOpcode();
+    unsigned char *jmp = EmitNotJump(sourcePos, label2);
 
     bool old_bCanBreak    = bCanBreak;
     bool old_bCanContinue = bCanContinue;
@@ -1414,6 +1631,170 @@ bool ScriptCompiler::EvalPrevValue(ScriptVariable& var)
     return true;
 }
 
+bool ScriptCompiler::EvalPrevConstant(ScriptVariable& var)
+{
+    if (PrevOpcode() == OP_STORE_STRING) {
+        var.setConstStringValue(GetOpcodeValue<op_name_t>(sizeof(op_name_t), sizeof(op_name_t)));
+        return true;
+    }
+
+    return EvalPrevValue(var);
+}
+
+bool ScriptCompiler::EvalPrevConstants(ScriptVariable& lhs, ScriptVariable& rhs)
+{
+    unsigned char *old_code_pos;
+    unsigned int   old_prev_opcode_pos;
+    int            old_var_stack_offset;
+    bool           success;
+
+    if (!EvalPrevConstant(rhs)) {
+        return false;
+    }
+
+    old_code_pos         = code_pos;
+    old_prev_opcode_pos  = prev_opcode_pos;
+    old_var_stack_offset = m_iVarStackOffset;
+
+    // Look at the opcode before, then put back the right operand
+    AbsorbPrevOpcode();
+    success = EvalPrevConstant(lhs);
+
+    code_pos          = old_code_pos;
+    prev_opcode_pos   = old_prev_opcode_pos;
+    m_iVarStackOffset = old_var_stack_offset;
+
+    return success;
+}
+
+static unsigned int GetJumpOffset(const unsigned char *operand)
+{
+    unsigned int offset;
+
+    Com_Memcpy(&offset, operand, sizeof(offset));
+    return offset;
+}
+
+/*
+====================
+FollowJumps
+
+Returns where execution ends up when starting at pos,
+after going through unconditional jumps
+====================
+*/
+unsigned char *ScriptCompiler::FollowJumps(unsigned char *pos, unsigned char *start, unsigned char *end)
+{
+    unsigned char *next;
+    int            i;
+
+    // Jumps may loop, so only follow a few of them
+    for (i = 0; i < 16; i++) {
+        if (*pos == OP_JUMP4) {
+            next = pos + 1 + sizeof(unsigned int) + GetJumpOffset(pos + 1);
+        } else if (*pos == OP_JUMP_BACK4) {
+            next = pos + 1 - GetJumpOffset(pos + 1);
+        } else {
+            break;
+        }
+
+        if (next < start || next >= end) {
+            break;
+        }
+
+        pos = next;
+    }
+
+    return pos;
+}
+
+/*
+====================
+OptimizeJumps
+
+Makes jumps landing on an unconditional jump go straight to its destination.
+The program is not moved, so labels and source positions stay valid
+====================
+*/
+void ScriptCompiler::OptimizeJumps(unsigned char *start, unsigned char *end)
+{
+    unsigned char *pos;
+    unsigned char *operand;
+    unsigned char *target;
+    unsigned char *newTarget;
+    int            length;
+
+    // OP_DONE has no length in the opcode table, leave it out
+    if (end > start && end[-1] == OP_DONE) {
+        end--;
+    }
+
+    // Make sure each opcode can be found from its length
+    for (pos = start; pos < end; pos += length) {
+        if (*pos >= OP_MAX) {
+            return;
+        }
+
+        length = OpcodeLength(*pos);
+        if (length <= 0) {
+            return;
+        }
+    }
+
+    if (pos != end) {
+        return;
+    }
+
+    for (pos = start; pos < end; pos += OpcodeLength(*pos)) {
+        switch (*pos) {
+        case OP_JUMP_BACK4:
+            operand = pos + 1;
+            target  = operand - GetJumpOffset(operand);
+            break;
+
+        case OP_JUMP4:
+        case OP_BOOL_JUMP_FALSE4:
+        case OP_BOOL_JUMP_TRUE4:
+        case OP_VAR_JUMP_FALSE4:
+        case OP_VAR_JUMP_TRUE4:
+        case OP_BOOL_LOGICAL_AND:
+        case OP_BOOL_LOGICAL_OR:
+        case OP_VAR_LOGICAL_AND:
+        case OP_VAR_LOGICAL_OR:
+        case OP_BIN_COMPARE_JUMP_FALSE4:
+        case OP_LOCAL_COMPARE_JUMP_FALSE4:
+            // The offset is always the last operand
+            operand = pos + OpcodeLength(*pos) - sizeof(unsigned int);
+            target  = operand + sizeof(unsigned int) + GetJumpOffset(operand);
+            break;
+
+        default:
+            continue;
+        }
+
+        if (target < start || target >= end) {
+            continue;
+        }
+
+        newTarget = FollowJumps(target, start, end);
+        if (newTarget == target) {
+            continue;
+        }
+
+        if (newTarget >= operand + sizeof(unsigned int)) {
+            if (*pos == OP_JUMP_BACK4) {
+                *pos = OP_JUMP4;
+            }
+
+            EmitAt(operand, (unsigned int)(newTarget - operand - sizeof(unsigned int)), sizeof(unsigned int));
+        } else if (*pos == OP_JUMP4 || *pos == OP_JUMP_BACK4) {
+            // Only unconditional jumps can go backward
+            *pos = OP_JUMP_BACK4;
+            EmitAt(operand, (unsigned int)(operand - newTarget), sizeof(unsigned int));
+        }
+    }
+}
+
 void ScriptCompiler::ProcessBreakJumpLocations(int iStartBreakJumpLocCount)
 {
     if (iBreakJumpLocCount > iStartBreakJumpLocCount) {
@@ -1567,6 +1948,7 @@ bool ScriptCompiler::Compile(GameScript *gameScript, unsigned char *progBuffer,
     gameScript->m_ProgToSource = new con_set<const unsigned char *, sourceinfo_t>;
 
     compileSuccess = true;
+    m_bOptimize    = g_scriptoptimize->integer != 0;
 
     prev_opcodes[prev_opcode_pos].opcode = OP_PREVIOUS;
 
@@ -1575,6 +1957,10 @@ bool ScriptCompiler::Compile(GameScript *gameScript, unsigned char *progBuffer,
         EmitEof(-1);
 
         if (compileSuccess) {
+            if (m_bOptimize) {
+                OptimizeJumps(code_ptr, code_pos);
+            }
+
             stateScript->AddLabel("", code_ptr);
 
             outLength = code_pos - code_ptr;
@@ -62,6 +62,11 @@ public:
     int m_iMaxExternalVarStackOffset;
     int m_iMaxCallStackOffset;
     int m_iHasExternal;
+    // Number of field and method sites, each one has an inline cache
+    int m_iNumInlineCaches;
+
+    // Whether g_scriptoptimize was set when compiling started
+    bool m_bOptimize;
 
     unsigned char *apucBreakJumpLocations[BREAK_JUMP_LOCATION_COUNT];
     int            iBreakJumpLocCount;
@@ -94,6 +99,7 @@ public:
     void EmitAssignmentStatement(sval_t lhs, unsigned int sourcePos);
 
     void EmitBoolJumpFalse(unsigned int sourcePos);
+    bool EmitLocalCompareJumpFalse(int compareOpcode, unsigned int sourcePos);
     void EmitBoolJumpTrue(unsigned int sourcePos);
     void EmitBoolNot(unsigned int sourcePos);
     void EmitBoolToVar(unsigned int sourcePos);
@@ -108,9 +114,11 @@ public:
     void EmitField(sval_t listener_val, sval_t field_val, unsigned int sourcePos);
     void EmitFloat(float value, unsigned int sourcePos);
     void EmitFunc1(int opcode, unsigned int sourcePos);
+    void EmitFunc2(int opcode, unsigned int sourcePos);
     //void EmitFunction(int iParamCount, sval_t val, unsigned int sourcePos);
     void EmitIfElseJump(sval_t if_stmt, sval_t else_stmt, unsigned int sourcePos);
     void EmitIfJump(sval_t if_stmt, unsigned int sourcePos);
+    void EmitInlineCacheIndex();
     void EmitInteger(unsigned int value, unsigned int sourcePos);
     void EmitJump(unsigned char *pos, unsigned int sourcePos);
     void EmitJumpBack(unsigned char *pos, unsigned int sourcePos);
@@ -137,7 +145,14 @@ public:
     void EmitVarToBool(unsigned int sourcePos);
     void EmitWhileJump(sval_t while_expr, sval_t while_stmt, sval_t inc_stmt, unsigned int sourcePos);
 
+    unsigned char *EmitNotJump(unsigned int sourcePos, int& label);
+
     bool EvalPrevValue(ScriptVariable& var);
+    bool EvalPrevConstant(ScriptVariable& var);
+    bool EvalPrevConstants(ScriptVariable& lhs, ScriptVariable& rhs);
+
+    void           OptimizeJumps(unsigned char *start, unsigned char *end);
+    unsigned char *FollowJumps(unsigned char *pos, unsigned char *start, unsigned char *end);
 
     void ProcessBreakJumpLocations(int iStartBreakJumpLocCount);
     void ProcessContinueJumpLocations(int iStartContinueJumpLocCount);
@@ -0,0 +1,95 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// scriptinlinecache.h: Per call site caches of field and method lookups
+
+#pragma once
+
+#include "../corepp/class.h"
+
+#define MAX_INLINE_CACHE_ENTRIES 4
+
+/**
+ * @brief Lookup result of a call site for one class.
+ */
+struct ScriptInlineCacheEntry {
+    ClassDef *classDef;
+    // Response of the field getter, or of the method.
+    // NULL if the class doesn't handle it
+    ResponseDef<Class> *response;
+    // Response of the field setter
+    ResponseDef<Class> *setResponse;
+};
+
+/**
+ * @brief Cache of a field access or a method call in the bytecode.
+ * The compiler gives an index to each site, and the VM keeps
+ * the lookup results for the last classes seen at that site.
+ */
+struct ScriptInlineCache {
+    // Getter and setter events of the field, resolved on first use
+    unsigned int getterNum;
+    unsigned int setterNum;
+    bool         resolved;
+
+    unsigned char          numEntries;
+    unsigned char          nextEntry;
+    ScriptInlineCacheEntry entries[MAX_INLINE_CACHE_ENTRIES];
+
+    ScriptInlineCache()
+        : getterNum(0)
+        , setterNum(0)
+        , resolved(false)
+        , numEntries(0)
+        , nextEntry(0)
+    {}
+
+    ScriptInlineCacheEntry *Find(ClassDef *classDef)
+    {
+        for (unsigned int i = 0; i < numEntries; i++) {
+            if (entries[i].classDef == classDef) {
+                return &entries[i];
+            }
+        }
+
+        return NULL;
+    }
+
+    ScriptInlineCacheEntry *Add(ClassDef *classDef)
+    {
+        ScriptInlineCacheEntry *entry;
+
+        if (numEntries < MAX_INLINE_CACHE_ENTRIES) {
+            entry = &entries[numEntries++];
+        } else {
+            // Megamorphic site, replace the oldest entry
+            entry     = &entries[nextEntry];
+            nextEntry = (nextEntry + 1) % MAX_INLINE_CACHE_ENTRIES;
+        }
+
+        entry->classDef    = classDef;
+        entry->response    = NULL;
+        entry->setResponse = NULL;
+
+        return entry;
+    }
+};
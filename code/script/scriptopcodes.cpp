@@ -26,6 +26,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../corepp/short3.h"
 #include "../corepp/vector.h"
 
+class StateScript;
+
 static opcode_t OpcodeInfo[] = {
     {"OPCODE_EOF",                       0,                        0,    0},
     {"OPCODE_BOOL_JUMP_FALSE4",          5,                        -1,   0},
@@ -67,34 +69,34 @@ static opcode_t OpcodeInfo[] = {
     {"OPCODE_EXEC_CMD5",                 5,                        -5,   1},
     {"OPCODE_EXEC_CMD_COUNT1",           6,                        -128, 1},
 
-    {"OPCODE_EXEC_CMD_METHOD0",          5,                        -1,   1},
-    {"OPCODE_EXEC_CMD_METHOD1",          5,                        -2,   1},
-    {"OPCODE_EXEC_CMD_METHOD2",          5,                        -3,   1},
-    {"OPCODE_EXEC_CMD_METHOD3",          5,                        -4,   1},
-    {"OPCODE_EXEC_CMD_METHOD4",          5,                        -5,   1},
-    {"OPCODE_EXEC_CMD_METHOD5",          5,                        -6,   1},
-    {"OPCODE_EXEC_CMD_METHOD_COUNT1",    6,                        -128, 1},
-
-    {"OPCODE_EXEC_METHOD0",              5,                        0,    1},
-    {"OPCODE_EXEC_METHOD1",              5,                        -1,   1},
-    {"OPCODE_EXEC_METHOD2",              5,                        -2,   1},
-    {"OPCODE_EXEC_METHOD3",              5,                        -3,   1},
-    {"OPCODE_EXEC_METHOD4",              5,                        -4,   1},
-    {"OPCODE_EXEC_METHOD5",              5,                        -5,   1},
-    {"OPCODE_EXEC_METHOD_COUNT1",        6,                        -128, 1},
-
-    {"OPCODE_LOAD_GAME_VAR",             5,                        -1,   0},
-    {"OPCODE_LOAD_LEVEL_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_LOCAL_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_PARM_VAR",             5,                        -1,   0},
-    {"OPCODE_LOAD_SELF_VAR",             5,                        -1,   0},
-    {"OPCODE_LOAD_GROUP_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_OWNER_VAR",            5,                        -1,   0},
-    {"OPCODE_LOAD_FIELD_VAR",            5,                        -2,   0},
+    {"OPCODE_EXEC_CMD_METHOD0",          9,                        -1,   1},
+    {"OPCODE_EXEC_CMD_METHOD1",          9,                        -2,   1},
+    {"OPCODE_EXEC_CMD_METHOD2",          9,                        -3,   1},
+    {"OPCODE_EXEC_CMD_METHOD3",          9,                        -4,   1},
+    {"OPCODE_EXEC_CMD_METHOD4",          9,                        -5,   1},
+    {"OPCODE_EXEC_CMD_METHOD5",          9,                        -6,   1},
+    {"OPCODE_EXEC_CMD_METHOD_COUNT1",    10,                       -128, 1},
+
+    {"OPCODE_EXEC_METHOD0",              9,                        0,    1},
+    {"OPCODE_EXEC_METHOD1",              9,                        -1,   1},
+    {"OPCODE_EXEC_METHOD2",              9,                        -2,   1},
+    {"OPCODE_EXEC_METHOD3",              9,                        -3,   1},
+    {"OPCODE_EXEC_METHOD4",              9,                        -4,   1},
+    {"OPCODE_EXEC_METHOD5",              9,                        -5,   1},
+    {"OPCODE_EXEC_METHOD_COUNT1",        10,                       -128, 1},
+
+    {"OPCODE_LOAD_GAME_VAR",             9,                        -1,   0},
+    {"OPCODE_LOAD_LEVEL_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_LOCAL_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_PARM_VAR",             9,                        -1,   0},
+    {"OPCODE_LOAD_SELF_VAR",             9,                        -1,   0},
+    {"OPCODE_LOAD_GROUP_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_OWNER_VAR",            9,                        -1,   0},
+    {"OPCODE_LOAD_FIELD_VAR",            9,                        -2,   0},
     {"OPCODE_LOAD_ARRAY_VAR",            1,                        -3,   0},
-    {"OPCODE_LOAD_CONST_ARRAY1",         2,                        -128, 0},
+    {"OPCODE_LOAD_CONST_ARRAY1",         1 + sizeof(op_arrayParmNum_t), -128, 0},
 
-    {"OPCODE_STORE_FIELD_REF",           5,                        0,    0},
+    {"OPCODE_STORE_FIELD_REF",           9,                        0,    0},
     {"OPCODE_STORE_ARRAY_REF",           1,                        -1,   0},
 
     {"OPCODE_MARK_STACK_POS",            1,                        0,    0},
@@ -103,22 +105,22 @@ static opcode_t OpcodeInfo[] = {
 
     {"OPCODE_RESTORE_STACK_POS",         1,                        0,    0},
 
-    {"OPCODE_LOAD_STORE_GAME_VAR",       5,                        0,    0},
-    {"OPCODE_LOAD_STORE_LEVEL_VAR",      5,                        0,    0},
-    {"OPCODE_LOAD_STORE_LOCAL_VAR",      5,                        0,    0},
-    {"OPCODE_LOAD_STORE_PARM_VAR",       5,                        0,    0},
-    {"OPCODE_LOAD_STORE_SELF_VAR",       5,                        0,    0},
-    {"OPCODE_LOAD_STORE_GROUP_VAR",      5,                        0,    0},
-    {"OPCODE_LOAD_STORE_OWNER_VAR",      5,                        0,    0},
-
-    {"OPCODE_STORE_GAME_VAR",            5,                        1,    0},
-    {"OPCODE_STORE_LEVEL_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_LOCAL_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_PARM_VAR",            5,                        1,    0},
-    {"OPCODE_STORE_SELF_VAR",            5,                        1,    0},
-    {"OPCODE_STORE_GROUP_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_OWNER_VAR",           5,                        1,    0},
-    {"OPCODE_STORE_FIELD",               5,                        0,    1},
+    {"OPCODE_LOAD_STORE_GAME_VAR",       9,                        0,    0},
+    {"OPCODE_LOAD_STORE_LEVEL_VAR",      9,                        0,    0},
+    {"OPCODE_LOAD_STORE_LOCAL_VAR",      9,                        0,    0},
+    {"OPCODE_LOAD_STORE_PARM_VAR",       9,                        0,    0},
+    {"OPCODE_LOAD_STORE_SELF_VAR",       9,                        0,    0},
+    {"OPCODE_LOAD_STORE_GROUP_VAR",      9,                        0,    0},
+    {"OPCODE_LOAD_STORE_OWNER_VAR",      9,                        0,    0},
+
+    {"OPCODE_STORE_GAME_VAR",            9,                        1,    0},
+    {"OPCODE_STORE_LEVEL_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_LOCAL_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_PARM_VAR",            9,                        1,    0},
+    {"OPCODE_STORE_SELF_VAR",            9,                        1,    0},
+    {"OPCODE_STORE_GROUP_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_OWNER_VAR",           9,                        1,    0},
+    {"OPCODE_STORE_FIELD",               9,                        0,    1},
     {"OPCODE_STORE_ARRAY",               1,                        -1,   0},
     {"OPCODE_STORE_GAME",                1,                        1,    0},
     {"OPCODE_STORE_LEVEL",               1,                        1,    0},
@@ -153,7 +155,7 @@ static opcode_t OpcodeInfo[] = {
     {"OPCODE_UN_DEC",                    1,                        0,    0},
     {"OPCODE_UN_SIZE",                   1,                        0,    0},
 
-    {"OPCODE_SWITCH",                    5,                        -1,   0},
+    {"OPCODE_SWITCH",                    1 + sizeof(StateScript *), -1,   0},
 
     {"OPCODE_FUNC",                      11,                       -128, 1},
 
@@ -164,6 +166,10 @@ static opcode_t OpcodeInfo[] = {
 
     {"OPCODE_END",                       1,                        -1,   0},
     {"OPCODE_RETURN",                    1,                        -1,   0},
+
+    {"OPCODE_BIN_COMPARE_JUMP_FALSE4",   2 + sizeof(unsigned int), -2,   0},
+    {"OPCODE_EXEC_CMD_SELF_METHOD_COUNT1", 10,                     -128, 1},
+    {"OPCODE_LOCAL_COMPARE_JUMP_FALSE4", 2 + sizeof(op_name_t) + sizeof(op_cacheIndex_t) + sizeof(unsigned int), -1, 0},
 };
 
 static const char *aszVarGroupNames[] = {"game", "level", "local", "parm", "self"};
@@ -36,6 +36,8 @@ using op_ev_t = uint32_t;
 using op_evName_t = uint32_t;
 /** Jump offset. */
 using op_offset_t = uint32_t;
+/** Index in the inline cache table of the script. */
+using op_cacheIndex_t = uint32_t;
 /** Parameter count. */
 using op_parmNum_t = uint8_t;
 /** Parameter count of const array. */
@@ -192,6 +194,11 @@ typedef enum {
     OP_END,
     OP_RETURN,
 
+    // Superinstructions emitted by the optimizer
+    OP_BIN_COMPARE_JUMP_FALSE4, // comparison opcode, then the jump offset
+    OP_EXEC_CMD_SELF_METHOD_COUNT1, // exec from self
+    OP_LOCAL_COMPARE_JUMP_FALSE4, // local variable, comparison opcode, then the jump offset
+
     OP_PREVIOUS,
     OP_MAX = OP_PREVIOUS
 } opcode_e;
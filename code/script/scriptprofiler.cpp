@@ -0,0 +1,497 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// scriptprofiler.cpp: Sampling profiler of the script VM
+
+#include "../fgame/g_local.h"
+#include "../fgame/scriptmaster.h"
+#include "scriptprofiler.h"
+#include "scriptclass.h"
+#include "scriptvm.h"
+
+#include <chrono>
+
+ScriptProfiler ScriptProfile;
+
+static int64_t ProfileTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static int ProfileLineCompare(const void *elem1, const void *elem2)
+{
+    const scriptProfileLine_t *line1 = *(const scriptProfileLine_t *const *)elem1;
+    const scriptProfileLine_t *line2 = *(const scriptProfileLine_t *const *)elem2;
+
+    if (line1->time != line2->time) {
+        return line1->time < line2->time ? 1 : -1;
+    }
+
+    return line1->opcodes < line2->opcodes ? 1 : (line1->opcodes > line2->opcodes ? -1 : 0);
+}
+
+ScriptProfiler::ScriptProfiler()
+    : numOpcodes(0)
+    , lastSampleTime(0)
+{}
+
+/*
+============
+ScriptProfiler::Clear
+
+Drops the collected samples
+============
+*/
+void ScriptProfiler::Clear()
+{
+    con_map_enum<unsigned int, scriptProfileStack_t *> en;
+    scriptProfileStack_t                             **stack;
+    scriptProfileStack_t                              *next;
+    int                                                i;
+
+    en = stacks;
+    for (stack = en.NextValue(); stack; stack = en.NextValue()) {
+        while (*stack) {
+            next = (*stack)->next;
+            delete *stack;
+            *stack = next;
+        }
+    }
+
+    for (i = 1; i <= lines.NumObjects(); i++) {
+        delete lines.ObjectAt(i);
+    }
+
+    stacks.clear();
+    frames.FreeObjectList();
+    lines.FreeObjectList();
+    lineIndexes.clear();
+    codePosLines.clear();
+    numOpcodes = 0;
+}
+
+/*
+============
+ScriptProfiler::ClearCodePositions
+
+The lines are kept, but the code positions
+will be reused by the next programs
+============
+*/
+void ScriptProfiler::ClearCodePositions()
+{
+    codePosLines.clear();
+    activeVMs.FreeObjectList();
+    activeDepths.FreeObjectList();
+    numOpcodes = 0;
+}
+
+/*
+============
+ScriptProfiler::EnterVM
+
+Called when a VM starts running, depth is the number of running VMs including it
+============
+*/
+void ScriptProfiler::EnterVM(ScriptVM *vm, int depth)
+{
+    // Forget about VMs that were left while the profiler was off
+    while (activeDepths.NumObjects() && activeDepths.ObjectAt(activeDepths.NumObjects()) >= depth) {
+        activeVMs.RemoveObjectAt(activeVMs.NumObjects());
+        activeDepths.RemoveObjectAt(activeDepths.NumObjects());
+    }
+
+    if (activeVMs.NumObjects()) {
+        // The time so far belongs to the calling VM
+        Sample(activeVMs.ObjectAt(activeVMs.NumObjects()));
+    } else {
+        lastSampleTime = ProfileTime();
+        numOpcodes     = 0;
+    }
+
+    activeVMs.AddObject(vm);
+    activeDepths.AddObject(depth);
+}
+
+/*
+============
+ScriptProfiler::LeaveVM
+============
+*/
+void ScriptProfiler::LeaveVM(ScriptVM *vm)
+{
+    if (!activeVMs.NumObjects() || activeVMs.ObjectAt(activeVMs.NumObjects()) != vm) {
+        return;
+    }
+
+    Sample(vm);
+
+    activeVMs.RemoveObjectAt(activeVMs.NumObjects());
+    activeDepths.RemoveObjectAt(activeDepths.NumObjects());
+}
+
+/*
+============
+ScriptProfiler::Sample
+
+Gives the time and the opcodes since the last sample to the last opcode of the VM
+============
+*/
+void ScriptProfiler::Sample(ScriptVM *vm)
+{
+    const unsigned char  *codePos;
+    scriptProfileLine_t  *line;
+    scriptProfileStack_t *stack;
+    int64_t               currentTime;
+    int64_t               elapsed;
+    int                   opcodes;
+    int                   i, j;
+
+    currentTime    = ProfileTime();
+    elapsed        = currentTime - lastSampleTime;
+    opcodes        = numOpcodes;
+    lastSampleTime = currentTime;
+    numOpcodes     = 0;
+
+    codePos = vm->m_PrevCodePos ? vm->m_PrevCodePos : vm->m_CodePos;
+    if (!codePos || !vm->m_ScriptClass) {
+        return;
+    }
+
+    frames.ClearObjectList();
+
+    //
+    // Callers first. The sampled VM is the last one running,
+    // unless the profiler was turned on while it was running
+    //
+    if (activeVMs.NumObjects() && activeVMs.ObjectAt(activeVMs.NumObjects()) == vm) {
+        for (i = 1; i <= activeVMs.NumObjects(); i++) {
+            ScriptVM *caller = activeVMs.ObjectAt(i);
+
+            for (j = 1; j <= caller->callStack.NumObjects(); j++) {
+                frames.AddObject(LineIndex(caller, caller->callStack.ObjectAt(j)->codePos));
+            }
+
+            if (caller != vm && caller->m_PrevCodePos) {
+                frames.AddObject(LineIndex(caller, caller->m_PrevCodePos));
+            }
+        }
+    } else {
+        for (j = 1; j <= vm->callStack.NumObjects(); j++) {
+            frames.AddObject(LineIndex(vm, vm->callStack.ObjectAt(j)->codePos));
+        }
+    }
+
+    frames.AddObject(LineIndex(vm, codePos));
+
+    line = lines.ObjectAt(frames.ObjectAt(frames.NumObjects()));
+    line->samples++;
+    line->opcodes += opcodes;
+    line->time += elapsed;
+
+    stack = FindStack(frames);
+    stack->samples++;
+    stack->opcodes += opcodes;
+    stack->time += elapsed;
+}
+
+/*
+============
+ScriptProfiler::FindStack
+
+Returns the stack with these lines, it's created if it doesn't exist
+============
+*/
+scriptProfileStack_t *ScriptProfiler::FindStack(const Container<int>& stackLines)
+{
+    scriptProfileStack_t **first;
+    scriptProfileStack_t  *stack;
+    unsigned int           hash;
+    int                    i;
+
+    // FNV-1a of the line indexes
+    hash = 2166136261u;
+    for (i = 1; i <= stackLines.NumObjects(); i++) {
+        hash ^= (unsigned int)stackLines.ObjectAt(i);
+        hash *= 16777619u;
+    }
+
+    first = &stacks[hash];
+    for (stack = *first; stack; stack = stack->next) {
+        if (stack->lines.NumObjects() != stackLines.NumObjects()) {
+            continue;
+        }
+
+        for (i = 1; i <= stackLines.NumObjects(); i++) {
+            if (stack->lines.ObjectAt(i) != stackLines.ObjectAt(i)) {
+                break;
+            }
+        }
+
+        if (i > stackLines.NumObjects()) {
+            return stack;
+        }
+    }
+
+    stack          = new scriptProfileStack_t;
+    stack->lines   = stackLines;
+    stack->samples = 0;
+    stack->opcodes = 0;
+    stack->time    = 0;
+    stack->next    = *first;
+    *first         = stack;
+
+    return stack;
+}
+
+/*
+============
+ScriptProfiler::LineIndex
+
+Returns the line of the code position.
+Looking up the source is slow, so it's only done for new positions
+============
+*/
+int ScriptProfiler::LineIndex(ScriptVM *vm, const unsigned char *codePos)
+{
+    GameScript          *script;
+    scriptProfileLine_t *line;
+    const_str            label;
+    str                  labelName;
+    str                  key;
+    int                 *index;
+    int                  lineNum;
+    int                  column;
+
+    index = codePosLines.find(codePos);
+    if (index) {
+        return *index;
+    }
+
+    script  = vm->GetScript();
+    lineNum = 0;
+    column  = 0;
+
+    if (!script->m_ProgToSource || !script->GetSourceAt(codePos, NULL, column, lineNum)) {
+        lineNum = 0;
+    }
+
+    label = script->m_State.NearestLabel((unsigned char *)codePos);
+    if (label) {
+        labelName = Director.GetString(label);
+    }
+
+    key = script->Filename() + "::" + labelName + ":" + str(lineNum);
+
+    index = lineIndexes.find(key);
+    if (!index) {
+        line           = new scriptProfileLine_t;
+        line->filename = script->Filename();
+        line->label    = labelName;
+        line->line     = lineNum;
+        line->samples  = 0;
+        line->opcodes  = 0;
+        line->time     = 0;
+
+        index  = &lineIndexes[key];
+        *index = lines.AddObject(line);
+    }
+
+    codePosLines[codePos] = *index;
+
+    return *index;
+}
+
+/*
+============
+ScriptProfiler::FrameName
+============
+*/
+str ScriptProfiler::FrameName(int lineIndex) const
+{
+    const scriptProfileLine_t *line = lines.ObjectAt(lineIndex);
+
+    return line->filename + "::" + line->label + ":" + str(line->line);
+}
+
+/*
+============
+ScriptProfiler::PrintReport
+
+Prints the lines and the labels taking the most time
+============
+*/
+void ScriptProfiler::PrintReport(int maxLines)
+{
+    con_map<str, scriptProfileLine_t>      labels;
+    con_map_enum<str, scriptProfileLine_t> en;
+    Container<scriptProfileLine_t *>       sorted;
+    scriptProfileLine_t                   *line;
+    scriptProfileLine_t                   *labelLine;
+    uint64_t                               totalTime;
+    uint64_t                               totalOpcodes;
+    unsigned int                           totalSamples;
+    double                                 percentScale;
+    int                                    i;
+
+    totalTime    = 0;
+    totalOpcodes = 0;
+    totalSamples = 0;
+
+    for (i = 1; i <= lines.NumObjects(); i++) {
+        line = lines.ObjectAt(i);
+
+        totalTime += line->time;
+        totalOpcodes += line->opcodes;
+        totalSamples += line->samples;
+    }
+
+    if (!totalSamples) {
+        gi.Printf("No script profile, set g_scriptprofile to the number of opcodes between samples\n");
+        return;
+    }
+
+    gi.Printf(
+        "Script profile: %u samples, %.2f ms, %llu opcodes\n",
+        totalSamples,
+        totalTime / 1000000.0,
+        (unsigned long long)totalOpcodes
+    );
+
+    percentScale = totalTime ? 100.0 / totalTime : 0;
+
+    //
+    // By line
+    //
+    sorted.Resize(lines.NumObjects());
+    for (i = 1; i <= lines.NumObjects(); i++) {
+        sorted.AddObject(lines.ObjectAt(i));
+    }
+    sorted.Sort(ProfileLineCompare);
+
+    gi.Printf("      ms      %%  samples    opcodes  line\n");
+    for (i = 1; i <= sorted.NumObjects() && i <= maxLines; i++) {
+        line = sorted.ObjectAt(i);
+
+        gi.Printf(
+            "%8.2f %6.2f %8u %10llu  %s::%s:%d\n",
+            line->time / 1000000.0,
+            line->time * percentScale,
+            line->samples,
+            (unsigned long long)line->opcodes,
+            line->filename.c_str(),
+            line->label.c_str(),
+            line->line
+        );
+    }
+
+    //
+    // By label
+    //
+    for (i = 1; i <= lines.NumObjects(); i++) {
+        line = lines.ObjectAt(i);
+
+        labelLine = labels.find(line->filename + "::" + line->label);
+        if (!labelLine) {
+            labelLine           = &labels[line->filename + "::" + line->label];
+            labelLine->filename = line->filename;
+            labelLine->label    = line->label;
+            labelLine->line     = 0;
+            labelLine->samples  = 0;
+            labelLine->opcodes  = 0;
+            labelLine->time     = 0;
+        }
+
+        labelLine->samples += line->samples;
+        labelLine->opcodes += line->opcodes;
+        labelLine->time += line->time;
+    }
+
+    sorted.ClearObjectList();
+
+    en = labels;
+    for (line = en.NextValue(); line; line = en.NextValue()) {
+        sorted.AddObject(line);
+    }
+    sorted.Sort(ProfileLineCompare);
+
+    gi.Printf("      ms      %%  samples    opcodes  label\n");
+    for (i = 1; i <= sorted.NumObjects() && i <= maxLines; i++) {
+        line = sorted.ObjectAt(i);
+
+        gi.Printf(
+            "%8.2f %6.2f %8u %10llu  %s::%s\n",
+            line->time / 1000000.0,
+            line->time * percentScale,
+            line->samples,
+            (unsigned long long)line->opcodes,
+            line->filename.c_str(),
+            line->label.c_str()
+        );
+    }
+}
+
+/*
+============
+ScriptProfiler::WriteCollapsedStacks
+
+Writes one line per call stack with the time in microseconds,
+in the format read by flame graph tools
+============
+*/
+bool ScriptProfiler::WriteCollapsedStacks(const char *filename)
+{
+    con_map_enum<unsigned int, scriptProfileStack_t *> en;
+    scriptProfileStack_t                             **first;
+    scriptProfileStack_t                              *stack;
+    str                                                buffer;
+    char                                               value[32];
+    int                                                i;
+
+    en = stacks;
+    for (first = en.NextValue(); first; first = en.NextValue()) {
+        for (stack = *first; stack; stack = stack->next) {
+            if (stack->time < 1000) {
+                continue;
+            }
+
+            for (i = 1; i <= stack->lines.NumObjects(); i++) {
+                if (i > 1) {
+                    buffer += ";";
+                }
+
+                buffer += FrameName(stack->lines.ObjectAt(i));
+            }
+
+            Com_sprintf(value, sizeof(value), " %llu\n", (unsigned long long)(stack->time / 1000));
+            buffer += value;
+        }
+    }
+
+    if (!buffer.length()) {
+        return false;
+    }
+
+    gi.FS_WriteFile(filename, buffer.c_str(), buffer.length());
+    return true;
+}
@@ -0,0 +1,110 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// scriptprofiler.h: Sampling profiler of the script VM
+
+#pragma once
+
+#include "../corepp/con_set.h"
+#include "../corepp/container.h"
+#include "../corepp/str.h"
+
+#include <cstdint>
+
+class ScriptVM;
+
+/**
+ * @brief Time spent on one line of a script.
+ */
+struct scriptProfileLine_t {
+    str          filename;
+    str          label;
+    int          line;
+    unsigned int samples;
+    uint64_t     opcodes;
+    uint64_t     time; // in nanoseconds
+};
+
+/**
+ * @brief Time spent with the same chain of callers.
+ */
+struct scriptProfileStack_t {
+    Container<int>        lines; // indexes in the line list, outermost caller first
+    unsigned int          samples;
+    uint64_t              opcodes;
+    uint64_t              time;
+    scriptProfileStack_t *next; // next stack with the same hash
+};
+
+/**
+ * @brief Collects where the script VM spends its time.
+ * When g_scriptprofile is set, the VM reports every opcode it runs and a sample
+ * is taken each g_scriptprofile opcodes, as well as when a VM starts or stops running.
+ * A sample gives the elapsed time and the opcodes since the last sample
+ * to the line of the last opcode, and to the call stack that led to it.
+ * Results are kept by file, label and source line, so they add up across frames and maps.
+ */
+class ScriptProfiler
+{
+public:
+    ScriptProfiler();
+
+    void Clear();
+    // Forget the code positions, must be called before freeing programs
+    void ClearCodePositions();
+
+    void EnterVM(ScriptVM *vm, int depth);
+    void LeaveVM(ScriptVM *vm);
+    void CountOpcode(ScriptVM *vm, int interval);
+
+    void PrintReport(int maxLines);
+    bool WriteCollapsedStacks(const char *filename);
+
+private:
+    void                  Sample(ScriptVM *vm);
+    int                   LineIndex(ScriptVM *vm, const unsigned char *codePos);
+    str                   FrameName(int lineIndex) const;
+    scriptProfileStack_t *FindStack(const Container<int>& stackLines);
+
+private:
+    Container<scriptProfileLine_t *>    lines;
+    con_map<str, int>                   lineIndexes;
+    con_map<const unsigned char *, int> codePosLines;
+    // Stacks by hash of their lines, stacks with the same hash are chained
+    con_map<unsigned int, scriptProfileStack_t *> stacks;
+    // Lines of the sampled stack, kept to not allocate on each sample
+    Container<int> frames;
+    // Running VMs, outermost first, and their depth
+    Container<ScriptVM *> activeVMs;
+    Container<int>        activeDepths;
+    int                   numOpcodes;
+    int64_t               lastSampleTime;
+};
+
+inline void ScriptProfiler::CountOpcode(ScriptVM *vm, int interval)
+{
+    if (++numOpcodes >= interval) {
+        Sample(vm);
+    }
+}
+
+extern ScriptProfiler ScriptProfile;
@@ -80,8 +80,63 @@ void con_set<ScriptVariable, ScriptVariable>::Entry::Archive(Archiver& arc)
 
 void ScriptArrayHolder::Archive(Archiver& arc)
 {
+    ScriptVariable index;
+    int            i;
+
     arc.ArchiveUnsigned(&refCount);
+
+    if (arc.Saving() && isDense) {
+        for (i = 1; i <= denseValue.NumObjects(); i++) {
+            if (denseValue.ObjectAt(i).GetType() == VARIABLE_POINTER) {
+                break;
+            }
+        }
+
+        if (i <= denseValue.NumObjects()) {
+            // Pointers are archived by the address of the variables,
+            // they must be saved from where they are stored
+            MakeSparse();
+        } else {
+            // Saved as a hash map, so saves don't depend on the representation
+            con_map<ScriptVariable, ScriptVariable> sparseValue;
+
+            for (i = 1; i <= denseValue.NumObjects(); i++) {
+                index.setIntValue(i);
+                sparseValue[index] = denseValue.ObjectAt(i);
+            }
+
+            sparseValue.Archive(arc);
+            return;
+        }
+    }
+
     arrayValue.Archive(arc);
+
+    if (arc.Loading()) {
+        isDense = false;
+
+        for (i = 1; i <= (int)arrayValue.size(); i++) {
+            ScriptVariable *value;
+
+            index.setIntValue(i);
+            value = arrayValue.find(index);
+            if (!value || value->GetType() == VARIABLE_POINTER) {
+                return;
+            }
+        }
+
+        // All the keys are 1..n, use the dense array again
+        denseValue.Resize(arrayValue.size());
+
+        for (i = 1; i <= (int)arrayValue.size(); i++) {
+            index.setIntValue(i);
+            GrowDenseTable();
+            denseValue.AddObject(*arrayValue.find(index));
+        }
+
+        arrayValue.clear();
+        isDense = true;
+    }
 }
 
 void ScriptArrayHolder::Archive(Archiver& arc, ScriptArrayHolder *& arrayValue)
@@ -270,10 +325,6 @@ void ScriptVariable::ArchiveInternal(Archiver& arc)
         break;
 
     case VARIABLE_VECTOR:
-        if (arc.Loading()) {
-            m_data.vectorValue = new float[3];
-        }
-
         arc.ArchiveVec3(m_data.vectorValue);
         break;
 
@@ -300,8 +351,215 @@ void ScriptVariable::MakePrimitive()
 
 ScriptArrayHolder::ScriptArrayHolder()
     : refCount(0)
+    , isDense(true)
+    , denseTableLength(1)
+    , denseThreshold(1)
 {}
 
+/*
+============
+ScriptArrayHolder::DenseIndex
+
+Returns the position of the key in the dense array, 0 if it's not an integer
+============
+*/
+int ScriptArrayHolder::DenseIndex(const ScriptVariable& key) const
+{
+    if (key.GetType() != VARIABLE_INTEGER) {
+        return 0;
+    }
+
+    return key.m_data.intValue;
+}
+
+/*
+============
+ScriptArrayHolder::GrowDenseTable
+
+Grows the table length like con_set does before a value is appended,
+removing values doesn't shrink it
+============
+*/
+void ScriptArrayHolder::GrowDenseTable()
+{
+    if ((unsigned int)denseValue.NumObjects() < denseThreshold) {
+        return;
+    }
+
+    denseThreshold = (unsigned int)((float)denseTableLength * 0.75);
+    if (denseThreshold < 1) {
+        denseThreshold = 1;
+    }
+
+    denseTableLength += denseThreshold;
+}
+
+/*
+============
+ScriptArrayHolder::MakeSparse
+
+Moves the values to the hash map
+============
+*/
+void ScriptArrayHolder::MakeSparse()
+{
+    ScriptVariable index;
+    int            i;
+
+    if (!isDense) {
+        return;
+    }
+
+    isDense = false;
+
+    for (i = 1; i <= denseValue.NumObjects(); i++) {
+        index.setIntValue(i);
+        arrayValue[index] = std::move(denseValue.ObjectAt(i));
+    }
+
+    denseValue.FreeObjectList();
+}
+
+ScriptVariable *ScriptArrayHolder::Find(const ScriptVariable& key)
+{
+    int i;
+
+    if (!isDense) {
+        return arrayValue.find(key);
+    }
+
+    if (key.GetType() != VARIABLE_INTEGER) {
+        // the map is empty, but it handles keys that can't be hashed
+        return arrayValue.find(key);
+    }
+
+    i = DenseIndex(key);
+    if (i < 1 || i > denseValue.NumObjects()) {
+        return NULL;
+    }
+
+    return &denseValue.ObjectAt(i);
+}
+
+ScriptVariable& ScriptArrayHolder::At(const ScriptVariable& key)
+{
+    int i;
+
+    if (isDense) {
+        i = DenseIndex(key);
+
+        if (i >= 1 && i <= denseValue.NumObjects()) {
+            return denseValue.ObjectAt(i);
+        }
+
+        if (i >= 1 && i == denseValue.NumObjects() + 1) {
+            GrowDenseTable();
+            return denseValue.ObjectAt(denseValue.AddObject());
+        }
+
+        MakeSparse();
+    }
+
+    return arrayValue[key];
+}
+
+/*
+============
+ScriptArrayHolder::StableAt
+
+Same as At(), but the value doesn't move when other values are added.
+The values of the dense array are moved when it grows
+============
+*/
+ScriptVariable& ScriptArrayHolder::StableAt(const ScriptVariable& key)
+{
+    MakeSparse();
+
+    return arrayValue[key];
+}
+
+void ScriptArrayHolder::Remove(const ScriptVariable& key)
+{
+    int i;
+
+    if (isDense) {
+        if (key.GetType() != VARIABLE_INTEGER) {
+            arrayValue.remove(key);
+            return;
+        }
+
+        i = DenseIndex(key);
+        if (i < 1 || i > denseValue.NumObjects()) {
+            return;
+        }
+
+        if (i == denseValue.NumObjects()) {
+            denseValue.RemoveObjectAt(i);
+            return;
+        }
+
+        // removing a value in the middle leaves a hole
+        MakeSparse();
+    }
+
+    arrayValue.remove(key);
+}
+
+unsigned int ScriptArrayHolder::Size() const
+{
+    if (isDense) {
+        return denseValue.NumObjects();
+    }
+
+    return arrayValue.size();
+}
+
+/*
+============
+ScriptArrayHolder::GetValues
+
+Copies the values in the order of the hash map enumeration.
+The order of a dense array is the one of a hash map filled with the keys 1..n
+============
+*/
+void ScriptArrayHolder::GetValues(ScriptVariable *values)
+{
+    con_map_enum<ScriptVariable, ScriptVariable> en;
+    ScriptVariable                              *value;
+    int                                          i;
+    int                                          n;
+
+    if (isDense) {
+        // Integer keys hash to their value and the table is never smaller than
+        // the number of values, so every bucket holds at most one key.
+        // Buckets are enumerated from the last one, the key n is in the
+        // bucket 0 when the table is exactly full
+        n = denseValue.NumObjects();
+
+        if ((unsigned int)n == denseTableLength) {
+            for (i = n - 1; i > 0; i--) {
+                *values++ = denseValue.ObjectAt(i);
+            }
+
+            if (n > 0) {
+                *values++ = denseValue.ObjectAt(n);
+            }
+            return;
+        }
+
+        for (i = n; i > 0; i--) {
+            *values++ = denseValue.ObjectAt(i);
+        }
+        return;
+    }
+
+    en = arrayValue;
+
+    for (value = en.NextValue(); value != NULL; value = en.NextValue()) {
+        *values++ = *value;
+    }
+}
+
 ScriptConstArrayHolder::ScriptConstArrayHolder(ScriptVariable *pVar, unsigned int size)
 {
     refCount   = 0;
@@ -411,6 +669,12 @@ ScriptVariable::ScriptVariable(ScriptVariable&& variable)
     type          = variable.GetType();
     m_data        = variable.m_data;
     variable.type = VARIABLE_NONE;
+
+    if (type == VARIABLE_POINTER) {
+        // containers move their objects when growing
+        m_data.pointerValue->add(this);
+        m_data.pointerValue->remove(&variable);
+    }
 }
 
 ScriptVariable::~ScriptVariable()
@@ -430,11 +694,8 @@ void ScriptVariable::CastBoolean(void)
 
 void ScriptVariable::CastConstArrayValue(void)
 {
-    con_map_enum<ScriptVariable, ScriptVariable> en;
-    ScriptConstArrayHolder                      *constArrayValue;
-    ScriptVariable                              *value;
-    int                                          i;
-    ConList                                     *listeners;
+    ScriptConstArrayHolder *constArrayValue;
+    ConList                *listeners;
 
     switch (GetType()) {
     case VARIABLE_POINTER:
@@ -446,16 +707,8 @@ void ScriptVariable::CastConstArrayValue(void)
         return;
 
     case VARIABLE_ARRAY:
-        constArrayValue = new ScriptConstArrayHolder(m_data.arrayValue->arrayValue.size());
-
-        en = m_data.arrayValue->arrayValue;
-
-        i = 1;
-
-        for (value = en.NextValue(); value != NULL; value = en.NextValue(), i++) {
-            constArrayValue->constArrayValue[i - 1] = *value;
-        }
-
+        constArrayValue = new ScriptConstArrayHolder(m_data.arrayValue->Size());
+        m_data.arrayValue->GetValues(constArrayValue->constArrayValue);
         break;
 
     case VARIABLE_CONTAINER:
@@ -570,11 +823,6 @@ void ScriptVariable::ClearInternal()
         m_data.pointerValue = NULL;
         break;
 
-    case VARIABLE_VECTOR:
-        delete[] m_data.vectorValue;
-        m_data.vectorValue = NULL;
-        break;
-
     default:
         break;
     }
@@ -749,7 +997,7 @@ int ScriptVariable::arraysize(void) const
         return -1;
 
     case VARIABLE_ARRAY:
-        return m_data.arrayValue->arrayValue.size();
+        return m_data.arrayValue->Size();
 
     case VARIABLE_CONSTARRAY:
         return m_data.constArrayValue->size;
@@ -789,7 +1037,7 @@ size_t ScriptVariable::size(void) const
         return *m_data.listenerValue != NULL;
 
     case VARIABLE_ARRAY:
-        return m_data.arrayValue->arrayValue.size();
+        return m_data.arrayValue->Size();
 
     case VARIABLE_CONSTARRAY:
         return m_data.constArrayValue->size;
@@ -930,7 +1178,7 @@ Entity *ScriptVariable::entityValue(void)
 
     switch (type) {
     case VARIABLE_CONSTSTRING:
-        ent = static_cast<Entity *>(world->GetScriptTarget(Director.GetString(m_data.intValue)));
+        ent = static_cast<Entity *>(world->GetScriptTarget((const_str)m_data.intValue));
         break;
     case VARIABLE_STRING:
         ent = static_cast<Entity *>(world->GetScriptTarget(stringValue()));
@@ -999,7 +1247,7 @@ void ScriptVariable::evalArrayAt(ScriptVariable& var)
     {
         ScriptVariable result;
 
-        array = m_data.arrayValue->arrayValue.find(var);
+        array = m_data.arrayValue->Find(var);
 
         if (array) {
             result = *array;
@@ -1106,24 +1354,37 @@ int ScriptVariable::intValue(void) const
 }
 
 Listener *ScriptVariable::listenerValue(void) const
+{
+    Listener *listener;
+
+    if (!tryListenerValue(listener)) {
+        throw ScriptException("Cannot cast '%s' to listener", GetTypeName());
+    }
+
+    return listener;
+}
+
+bool ScriptVariable::tryListenerValue(Listener *& listener) const
 {
     switch (type) {
 #ifdef WITH_SCRIPT_ENGINE
     case VARIABLE_CONSTSTRING:
-        return world->GetScriptTarget(Director.GetString(m_data.intValue));
+        listener = world->GetScriptTarget((const_str)m_data.intValue);
+        return true;
 
     case VARIABLE_STRING:
-        return world->GetScriptTarget(stringValue());
+        listener = world->GetScriptTarget(stringValue());
+        return true;
 #endif
 
     case VARIABLE_LISTENER:
-        return (Listener *)m_data.listenerValue->Pointer();
+        listener = (Listener *)m_data.listenerValue->Pointer();
+        return true;
 
     default:
-        throw ScriptException("Cannot cast '%s' to listener", GetTypeName());
+        listener = NULL;
+        return false;
     }
-
-    return NULL;
 }
 
 Listener *ScriptVariable::listenerAt(uintptr_t index) const
@@ -1335,16 +1596,16 @@ void ScriptVariable::setArrayAtRef(ScriptVariable& index, ScriptVariable& value)
         m_data.arrayValue = new ScriptArrayHolder;
 
         if (value.GetType() != VARIABLE_NONE) {
-            m_data.arrayValue->arrayValue[index] = value;
+            m_data.arrayValue->At(index) = value;
         }
 
         break;
 
     case VARIABLE_ARRAY:
         if (value.GetType() == VARIABLE_NONE) {
-            m_data.arrayValue->arrayValue.remove(index);
+            m_data.arrayValue->Remove(index);
         } else {
-            m_data.arrayValue->arrayValue[index] = value;
+            m_data.arrayValue->At(index) = value;
         }
         break;
 
@@ -1386,7 +1647,25 @@ void ScriptVariable::setArrayAtRef(ScriptVariable& index, ScriptVariable& value)
 
 void ScriptVariable::setArrayRefValue(ScriptVariable& var)
 {
-    setRefValue(&(*m_data.refValue)[var]);
+    ScriptVariable *array = m_data.refValue;
+
+    // The reference stays on the stack while the rest of the statement runs,
+    // which can add values to the array
+    switch (array->GetType()) {
+    case VARIABLE_NONE:
+        array->type              = VARIABLE_ARRAY;
+        array->m_data.arrayValue = new ScriptArrayHolder;
+        setRefValue(&array->m_data.arrayValue->StableAt(var));
+        break;
+
+    case VARIABLE_ARRAY:
+        setRefValue(&array->m_data.arrayValue->StableAt(var));
+        break;
+
+    default:
+        setRefValue(&(*array)[var]);
+        break;
+    }
 }
 
 void ScriptVariable::setCharValue(char newvalue)
@@ -1501,8 +1780,7 @@ void ScriptVariable::setVectorValue(const Vector& newvector)
 {
     ClearInternal();
 
-    type               = VARIABLE_VECTOR;
-    m_data.vectorValue = new float[3];
+    type = VARIABLE_VECTOR;
     newvector.copyTo(m_data.vectorValue);
 }
 
@@ -1689,7 +1967,9 @@ void ScriptVariable::operator/=(const ScriptVariable& value)
             throw ScriptException("Division by zero error\n");
         }
 
-        (Vector) m_data.vectorValue = (Vector)m_data.vectorValue / (float)value.m_data.intValue;
+        m_data.vectorValue[0] = m_data.vectorValue[0] / value.m_data.intValue;
+        m_data.vectorValue[1] = m_data.vectorValue[1] / value.m_data.intValue;
+        m_data.vectorValue[2] = m_data.vectorValue[2] / value.m_data.intValue;
         break;
 
     case VARIABLE_VECTOR + VARIABLE_FLOAT *VARIABLE_MAX: // ( vector ) / ( float )
@@ -1743,18 +2023,13 @@ void ScriptVariable::operator/=(const ScriptVariable& value)
         break;
 
     case VARIABLE_VECTOR + VARIABLE_VECTOR *VARIABLE_MAX: // ( vector ) / ( vector )
-        m_data.vectorValue = vec_zero;
-
-        if (value.m_data.vectorValue[0] != 0) {
-            m_data.vectorValue[0] = m_data.vectorValue[0] / value.m_data.vectorValue[0];
-        }
-
-        if (value.m_data.vectorValue[1] != 0) {
-            m_data.vectorValue[1] = m_data.vectorValue[1] / value.m_data.vectorValue[1];
-        }
-
-        if (value.m_data.vectorValue[2] != 0) {
-            m_data.vectorValue[2] = m_data.vectorValue[2] / value.m_data.vectorValue[2];
+        // components divided by zero are set to zero
+        for (int i = 0; i < 3; i++) {
+            if (value.m_data.vectorValue[i] != 0) {
+                m_data.vectorValue[i] = m_data.vectorValue[i] / value.m_data.vectorValue[i];
+            } else {
+                m_data.vectorValue[i] = 0;
+            }
         }
         break;
     }
@@ -1848,24 +2123,19 @@ void ScriptVariable::operator%=(const ScriptVariable& value)
 
         setVectorValue(vec_zero);
 
-        m_data.vectorValue[0] = fmod(m_data.vectorValue[0], mult);
-        m_data.vectorValue[1] = fmod(m_data.vectorValue[1], mult);
-        m_data.vectorValue[2] = fmod(m_data.vectorValue[2], mult);
+        m_data.vectorValue[0] = fmod(value.m_data.vectorValue[0], mult);
+        m_data.vectorValue[1] = fmod(value.m_data.vectorValue[1], mult);
+        m_data.vectorValue[2] = fmod(value.m_data.vectorValue[2], mult);
         break;
 
     case VARIABLE_VECTOR + VARIABLE_VECTOR *VARIABLE_MAX: // ( vector ) % ( vector )
-        m_data.vectorValue = vec_zero;
-
-        if (value.m_data.vectorValue[0] != 0) {
-            m_data.vectorValue[0] = fmod(m_data.vectorValue[0], value.m_data.vectorValue[0]);
-        }
-
-        if (value.m_data.vectorValue[1] != 0) {
-            m_data.vectorValue[1] = fmod(m_data.vectorValue[1], value.m_data.vectorValue[1]);
-        }
-
-        if (value.m_data.vectorValue[2] != 0) {
-            m_data.vectorValue[2] = fmod(m_data.vectorValue[2], value.m_data.vectorValue[2]);
+        // components divided by zero are set to zero
+        for (int i = 0; i < 3; i++) {
+            if (value.m_data.vectorValue[i] != 0) {
+                m_data.vectorValue[i] = fmod(m_data.vectorValue[i], value.m_data.vectorValue[i]);
+            } else {
+                m_data.vectorValue[i] = 0;
+            }
         }
 
         break;
@@ -2062,7 +2332,9 @@ bool ScriptVariable::operator==(const ScriptVariable& value)
 
 ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
 {
-    if (type == variable.GetType() && m_data.anyValue == variable.m_data.anyValue) {
+    if (type == variable.GetType() && type != VARIABLE_VECTOR && m_data.anyValue == variable.m_data.anyValue) {
+        // Same value or same shared holder.
+        // Vectors are excluded as anyValue only covers two components
         return *this;
     }
 
@@ -2123,7 +2395,6 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_VECTOR:
-            m_data.vectorValue = (float *)new float[3];
             VectorCopy(variable.m_data.vectorValue, m_data.vectorValue);
             break;
         }
@@ -2226,10 +2497,10 @@ ScriptVariable& ScriptVariable::operator[](ScriptVariable& index)
         type = VARIABLE_ARRAY;
 
         m_data.arrayValue = new ScriptArrayHolder;
-        return m_data.arrayValue->arrayValue[index];
+        return m_data.arrayValue->At(index);
 
     case VARIABLE_ARRAY:
-        return m_data.arrayValue->arrayValue[index];
+        return m_data.arrayValue->At(index);
 
     case VARIABLE_CONSTARRAY:
         i = index.intValue();
@@ -86,7 +86,7 @@ public:
         int                intValue;
         SafePtr<Listener> *listenerValue;
         str               *stringValue;
-        float             *vectorValue;
+        float              vectorValue[3]; // stored inline, vectors are common temporaries
         void              *anyValue;
 
         ScriptVariable *refValue;
@@ -183,6 +183,8 @@ public:
     void setIntValue(int newvalue);
 
     Listener *listenerValue(void) const;
+    // Same as listenerValue, but returns false instead of throwing if the type can't be cast
+    bool      tryListenerValue(Listener *& listener) const;
     Listener *listenerAt(uintptr_t index) const;
     void      setListenerValue(Listener *newvalue);
 
@@ -244,12 +246,33 @@ public:
 class ScriptArrayHolder : public LightClass
 {
 public:
+    unsigned int refCount;
+
+private:
+    // While the keys are the integers 1..n, the values are kept in denseValue.
+    // The hash map is used from the first key that doesn't fit
+    Container<ScriptVariable>               denseValue;
     con_map<ScriptVariable, ScriptVariable> arrayValue;
-    unsigned int                            refCount;
+    bool                                    isDense;
+    // Size of the hash table the dense values would have, for the value order
+    unsigned int denseTableLength;
+    unsigned int denseThreshold;
+
+private:
+    int  DenseIndex(const ScriptVariable& key) const;
+    void MakeSparse();
+    void GrowDenseTable();
 
 public:
     ScriptArrayHolder();
 
+    ScriptVariable *Find(const ScriptVariable& key);
+    ScriptVariable& At(const ScriptVariable& key);
+    ScriptVariable& StableAt(const ScriptVariable& key);
+    void            Remove(const ScriptVariable& key);
+    unsigned int    Size() const;
+    void            GetValues(ScriptVariable *values);
+
     void        Archive(Archiver& arc);
     static void Archive(Archiver& arc, ScriptArrayHolder *& arrayValue);
 };
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "scriptvm.h"
 #include "scriptcompiler.h"
 #include "scriptexception.h"
+#include "scriptprofiler.h"
 #include "../fgame/game.h"
 #include "../fgame/level.h"
 #include "../fgame/parm.h"
@@ -53,6 +54,55 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #endif
 
+//
+// Opcode dispatch of the interpreter loop.
+// With GCC and Clang, opcodes that cannot change the thread state end in VM_NEXT,
+// which fetches the next opcode and jumps straight to its handler through a table
+// of label addresses. Opcodes that run events, call functions or end the thread
+// break back to the loop instead, where the state is checked.
+// VM_NEXT also goes back to the loop when tracing or when the command count
+// must be checked for loop protection
+//
+#if !defined(SCRIPTVM_COMPUTED_GOTO)
+#    if defined(__GNUC__) || defined(__clang__)
+#        define SCRIPTVM_COMPUTED_GOTO 1
+#    else
+#        define SCRIPTVM_COMPUTED_GOTO 0
+#    endif
+#endif
+
+// Number of opcodes executed before checking the execution time of the thread
+#define SCRIPTVM_MAX_CMD_COUNT 15000
+
+#if SCRIPTVM_COMPUTED_GOTO
+
+#    define VM_LABEL(op)     &&label_##op
+#    define VM_LABEL_DEFAULT &&label_default
+#    define VM_CASE(op)      case op: label_##op
+#    define VM_DEFAULT       default: label_default
+#    define VM_DISPATCH(op)            \
+        if ((op) >= OP_MAX) {          \
+            goto label_default;        \
+        }                              \
+        goto *dispatchTable[(op)]
+#    define VM_NEXT()                                                  \
+        if (!bTrace && Director.cmdCount < SCRIPTVM_MAX_CMD_COUNT - 1) { \
+            Director.cmdCount++;                                       \
+            m_PrevCodePos = m_CodePos;                                 \
+            opcode        = m_CodePos++;                               \
+            VM_DISPATCH(*opcode);                                      \
+        }                                                              \
+        break
+
+#else
+
+#    define VM_CASE(op)     case op
+#    define VM_DEFAULT      default
+#    define VM_DISPATCH(op)
+#    define VM_NEXT()       break
+
+#endif
+
 static const ScriptVM *currentScriptFile;
 static unsigned int    currentScriptLine;
 
@@ -424,6 +474,39 @@ void ScriptVM::error(const char *format, ...)
     m_ReturnValue.setStringValue("$.INTERRUPTED");
 }
 
+/*
+====================
+raiseError
+
+Reports a script error without throwing, for faults that are common
+in scripts, like commands applied to NULL listeners.
+The caller must have cleaned up the stack and skipped the opcode,
+just like it would before throwing a ScriptException.
+It still throws when the error would abort the VM
+====================
+*/
+void ScriptVM::raiseError(const char *format, ...)
+{
+    char    buffer[4100];
+    va_list va;
+
+    va_start(va, format);
+    Q_vsnprintf(buffer, sizeof(buffer), format, va);
+    va_end(va);
+
+    if (ScriptException::next_abort || ScriptException::next_bIsForAnim || !m_ScriptClass
+        || m_ScriptClass->GetScript()->ScriptCheck()) {
+        // let HandleScriptException abort the VM
+        throw ScriptException(str(buffer));
+    }
+
+    // same output as HandleScriptException
+    m_ScriptClass->GetScript()->PrintSourcePos(m_PrevCodePos, true);
+    gi.DPrintf2("^~^~^ Script Error : %s\n\n", buffer);
+
+    Director.cmdCount += 100;
+}
+
 void ScriptVM::jump(unsigned int offset)
 {
     m_CodePos += offset;
@@ -464,11 +547,76 @@ bool ScriptVM::doJumpVarIf(bool booleanValue)
     return jumpVar(offset, booleanValue);
 }
 
+void ScriptVM::doCompareJumpFalse()
+{
+    ScriptVariable& a = m_VMStack.Pop();
+    ScriptVariable& b = m_VMStack.Pop();
+
+    compareJumpFalse(b, a);
+}
+
+void ScriptVM::doLocalCompareJumpFalse()
+{
+    // The constant is already on the stack, load the variable above it
+    m_VMStack.Push();
+
+    try {
+        storeTopInternal(m_Thread);
+    } catch (...) {
+        // Skip the comparison and jump like a NIL condition would
+        m_VMStack.Pop(2);
+        fetchOpcodeValue<unsigned char>();
+        jump(fetchOpcodeValue<unsigned int>());
+        throw;
+    }
+
+    ScriptVariable& b = m_VMStack.Pop();
+    ScriptVariable& a = m_VMStack.Pop();
+
+    compareJumpFalse(b, a);
+}
+
+void ScriptVM::compareJumpFalse(ScriptVariable& b, ScriptVariable& a)
+{
+    const unsigned char compareOpcode = fetchOpcodeValue<unsigned char>();
+    const unsigned int  offset        = fetchOpcodeValue<unsigned int>();
+
+    try {
+        switch (compareOpcode) {
+        case OP_BIN_EQUALITY:
+            b.setIntValue(b == a);
+            break;
+        case OP_BIN_INEQUALITY:
+            b.setIntValue(b != a);
+            break;
+        case OP_BIN_LESS_THAN:
+            b.lessthan(a);
+            break;
+        case OP_BIN_GREATER_THAN:
+            b.greaterthan(a);
+            break;
+        case OP_BIN_LESS_THAN_OR_EQUAL:
+            b.lessthanorequal(a);
+            break;
+        case OP_BIN_GREATER_THAN_OR_EQUAL:
+            b.greaterthanorequal(a);
+            break;
+        }
+    } catch (...) {
+        // The comparison cleared the value, jump like a NIL condition would
+        jump(offset);
+        throw;
+    }
+
+    jumpBool(offset, !b.m_data.intValue);
+}
+
 void ScriptVM::loadTopInternal(Listener *listener)
 {
-    const const_str variable = fetchOpcodeValue<op_name_t>();
+    const const_str       variable   = fetchOpcodeValue<op_name_t>();
+    const op_cacheIndex_t cacheIndex = fetchOpcodeValue<op_cacheIndex_t>();
 
-    if (!executeSetter(listener, variable)) {
+    if (!executeSetter(listener, variable, cacheIndex)) {
         // just set the variable
         ScriptVariable& pTop = m_VMStack.GetTop();
         listener->Vars()->SetVariable(variable, std::move(pTop));
@@ -477,10 +625,11 @@ void ScriptVM::loadTopInternal(Listener *listener)
 
 ScriptVariable *ScriptVM::storeTopInternal(Listener *listener)
 {
-    const const_str variable = fetchOpcodeValue<op_name_t>();
-    ScriptVariable *listenerVar;
+    const const_str       variable   = fetchOpcodeValue<op_name_t>();
+    const op_cacheIndex_t cacheIndex = fetchOpcodeValue<op_cacheIndex_t>();
+    ScriptVariable       *listenerVar;
 
-    if (!executeGetter(listener, variable)) {
+    if (!executeGetter(listener, variable, cacheIndex)) {
         ScriptVariable& pTop = m_VMStack.GetTop();
         listenerVar          = listener->Vars()->GetOrCreateVariable(variable);
 
@@ -494,9 +643,10 @@ ScriptVariable *ScriptVM::storeTopInternal(Listener *listener)
 
 void ScriptVM::loadStoreTop(Listener *listener)
 {
-    const const_str variable = fetchOpcodeValue<op_name_t>();
+    const const_str       variable   = fetchOpcodeValue<op_name_t>();
+    const op_cacheIndex_t cacheIndex = fetchOpcodeValue<op_cacheIndex_t>();
 
-    if (!executeSetter(listener, variable)) {
+    if (!executeSetter(listener, variable, cacheIndex)) {
         // just set the variable
         ScriptVariable& pTop = m_VMStack.GetTop();
         listener->Vars()->SetVariable(variable, pTop);
@@ -505,7 +655,7 @@ void ScriptVM::loadStoreTop(Listener *listener)
 
 void ScriptVM::skipField()
 {
-    m_CodePos += sizeof(unsigned int);
+    m_CodePos += sizeof(op_name_t) + sizeof(op_cacheIndex_t);
 }
 
 template<>
@@ -593,6 +743,97 @@ void ScriptVM::executeCommand<true, true>(Listener *listener, op_parmNum_t iPara
     return executeCommandInternal<true>(ev, listener, m_VMStack.GetTopArray(), iParamCount);
 }
 
+template<bool bReturn>
+void ScriptVM::executeMethod(
+    Listener *listener, op_parmNum_t iParamCount, op_ev_t eventnum, op_cacheIndex_t cacheIndex
+)
+{
+    ScriptCommandEvent ev = iParamCount ? ScriptCommandEvent(eventnum, iParamCount) : ScriptCommandEvent(eventnum);
+    ScriptInlineCacheEntry *entry;
+    ScriptVariable         *fromVar;
+
+    if (bReturn) {
+        fromVar = m_VMStack.GetTopArray();
+    } else {
+        fromVar = m_VMStack.GetTopArray(1);
+    }
+
+    transferVarsToEvent(ev, fromVar, iParamCount);
+
+    try {
+        entry = fetchMethodCache(listener, eventnum, cacheIndex);
+
+        if (!entry->response) {
+            // The class doesn't handle the event, throws the error
+            checkValidEvent(ev, listener);
+        }
+
+        if (entry->response->response) {
+            (listener->*entry->response->response)(&ev);
+        }
+    } catch (...) {
+        if (bReturn) {
+            m_VMStack.GetTop().Clear();
+        }
+        throw;
+    }
+
+    if (bReturn) {
+        ScriptVariable& pTop = m_VMStack.GetTop();
+        pTop                 = std::move(ev.GetValue());
+    }
+}
+
+ScriptInlineCacheEntry *ScriptVM::fetchFieldCache(Listener *listener, op_name_t eventName, op_cacheIndex_t cacheIndex)
+{
+    ScriptInlineCache&      cache    = GetScript()->m_InlineCaches[cacheIndex];
+    ClassDef *const         classDef = listener->classinfo();
+    ScriptInlineCacheEntry *entry;
+
+    entry = cache.Find(classDef);
+    if (entry) {
+        return entry;
+    }
+
+    if (!cache.resolved) {
+        cache.getterNum = Event::FindGetterEventNum(eventName);
+        cache.setterNum = Event::FindSetterEventNum(eventName);
+        cache.resolved  = true;
+    }
+
+    entry = cache.Add(classDef);
+
+    if (cache.getterNum && classDef->GetDef(cache.getterNum)) {
+        entry->response = classDef->responseLookup[cache.getterNum];
+    }
+
+    if (cache.setterNum && classDef->GetDef(cache.setterNum)) {
+        entry->setResponse = classDef->responseLookup[cache.setterNum];
+    }
+
+    return entry;
+}
+
+ScriptInlineCacheEntry *ScriptVM::fetchMethodCache(Listener *listener, op_ev_t eventnum, op_cacheIndex_t cacheIndex)
+{
+    ScriptInlineCache&      cache    = GetScript()->m_InlineCaches[cacheIndex];
+    ClassDef *const         classDef = listener->classinfo();
+    ScriptInlineCacheEntry *entry;
+
+    entry = cache.Find(classDef);
+    if (entry) {
+        return entry;
+    }
+
+    entry = cache.Add(classDef);
+
+    if (classDef->GetDef(eventnum)) {
+        entry->response = classDef->responseLookup[eventnum];
+    }
+
+    return entry;
+}
+
 void ScriptVM::transferVarsToEvent(Event& ev, ScriptVariable *fromVar, op_parmNum_t count)
 {
     ev.CopyValues(fromVar, count);
@@ -618,49 +859,43 @@ void ScriptVM::checkValidEvent(Event& ev, Listener *listener)
     }
 }
 
-bool ScriptVM::executeGetter(Listener *listener, op_evName_t eventName)
+bool ScriptVM::executeGetter(Listener *listener, op_evName_t eventName, op_cacheIndex_t cacheIndex)
 {
-    int eventNum = Event::FindGetterEventNum(eventName);
+    const ScriptInlineCacheEntry *entry = fetchFieldCache(listener, eventName, cacheIndex);
 
-    if (eventNum && listener->classinfo()->GetDef(eventNum)) {
-        ScriptCommandEvent ev(eventNum);
+    if (entry->response) {
+        ScriptCommandEvent ev(GetScript()->m_InlineCaches[cacheIndex].getterNum);
 
-        listener->ProcessScriptEvent(ev);
+        if (entry->response->response) {
+            (listener->*entry->response->response)(&ev);
+        }
 
         ScriptVariable& pTop = m_VMStack.GetTop();
         pTop                 = std::move(ev.GetValue());
 
         return true;
-    } else {
-        eventNum = Event::FindSetterEventNum(eventName);
-        assert(!eventNum || !listener->classinfo()->GetDef(eventNum));
-        if (eventNum && listener->classinfo()->GetDef(eventNum)) {
-            ScriptError("Cannot set a read-only variable");
-        }
+    } else if (entry->setResponse) {
+        ScriptError("Cannot set a read-only variable");
     }
 
     return false;
 }
 
-bool ScriptVM::executeSetter(Listener *listener, op_evName_t eventName)
+bool ScriptVM::executeSetter(Listener *listener, op_evName_t eventName, op_cacheIndex_t cacheIndex)
 {
-    int eventNum = Event::FindSetterEventNum(eventName);
+    const ScriptInlineCacheEntry *entry = fetchFieldCache(listener, eventName, cacheIndex);
 
-    if (eventNum && listener->classinfo()->GetDef(eventNum)) {
-        ScriptCommandEvent ev(eventNum, 1);
+    if (entry->setResponse) {
+        ScriptCommandEvent ev(GetScript()->m_InlineCaches[cacheIndex].setterNum, 1);
 
         ScriptVariable& pTop = m_VMStack.GetTop();
         ev.CopyValues(&pTop, 1);
 
-        listener->ProcessScriptEvent(ev);
+        if (entry->setResponse->response) {
+            (listener->*entry->setResponse->response)(&ev);
+        }
 
         return true;
-    } else {
-        eventNum = Event::FindSetterEventNum(eventName);
-        assert(!eventNum || !listener->classinfo()->GetDef(eventNum));
-        if (eventNum && listener->classinfo()->GetDef(eventNum)) {
-            ScriptError("Cannot get a write-only variable");
-        }
     }
 
     return false;
@@ -677,14 +912,16 @@ void ScriptVM::execCmdCommon(op_parmNum_t param)
 
 void ScriptVM::execCmdMethodCommon(op_parmNum_t param)
 {
-    const ScriptVariable& a        = m_VMStack.Pop();
-    const op_ev_t         eventNum = fetchOpcodeValue<op_ev_t>();
+    const ScriptVariable& a          = m_VMStack.Pop();
+    const op_ev_t         eventNum   = fetchOpcodeValue<op_ev_t>();
+    const op_cacheIndex_t cacheIndex = fetchOpcodeValue<op_cacheIndex_t>();
 
     m_VMStack.Pop(param);
 
     const size_t arraysize = a.arraysize();
     if (arraysize == (size_t)-1) {
-        throw ScriptException("command '%s' applied to NIL", Event::GetEventName(eventNum));
+        raiseError("command '%s' applied to NIL", Event::GetEventName(eventNum));
+        return;
     }
 
     if (arraysize > 1) {
@@ -701,7 +938,7 @@ void ScriptVM::execCmdMethodCommon(op_parmNum_t param)
                 // if the listener is NULL, don't throw an exception
                 // it would be unfair if the other listeners executed the command
                 if (listener) {
-                    executeCommand<true>(listener, param, eventNum);
+                    executeMethod<false>(listener, param, eventNum, cacheIndex);
                 }
             }
         } else {
@@ -712,37 +949,69 @@ void ScriptVM::execCmdMethodCommon(op_parmNum_t param)
             for (uintptr_t i = array.arraysize(); i > 0; i--) {
                 Listener *const listener = array.listenerAt(i);
                 if (listener) {
-                    executeCommand<true>(listener, param, eventNum);
+                    executeMethod<false>(listener, param, eventNum, cacheIndex);
                 }
             }
         }
     } else {
         // avoid useless allocations of const array
-        Listener *const listener = a.listenerValue();
+        Listener *listener;
+        if (!a.tryListenerValue(listener)) {
+            raiseError("Cannot cast '%s' to listener", a.GetTypeName());
+            return;
+        }
+
         if (!listener) {
-            throw ScriptException("command '%s' applied to NULL listener", Event::GetEventName(eventNum));
+            raiseError("command '%s' applied to NULL listener", Event::GetEventName(eventNum));
+            return;
         }
 
-        executeCommand<true>(listener, param, eventNum);
+        executeMethod<false>(listener, param, eventNum, cacheIndex);
+    }
+}
+
+void ScriptVM::execCmdSelfMethod(op_parmNum_t param)
+{
+    Listener *const       listener   = m_ScriptClass->m_Self;
+    const op_ev_t         eventNum   = fetchOpcodeValue<op_ev_t>();
+    const op_cacheIndex_t cacheIndex = fetchOpcodeValue<op_cacheIndex_t>();
+
+    m_VMStack.Pop(param);
+
+    if (!listener) {
+        raiseError("command '%s' applied to NULL listener", Event::GetEventName(eventNum));
+        return;
     }
+
+    executeMethod<false>(listener, param, eventNum, cacheIndex);
 }
 
 void ScriptVM::execMethodCommon(op_parmNum_t param)
 {
-    const ScriptVariable& a        = m_VMStack.Pop();
-    const op_ev_t         eventNum = fetchOpcodeValue<op_ev_t>();
+    const ScriptVariable& a          = m_VMStack.Pop();
+    const op_ev_t         eventNum   = fetchOpcodeValue<op_ev_t>();
+    const op_cacheIndex_t cacheIndex = fetchOpcodeValue<op_cacheIndex_t>();
 
     m_VMStack.Pop(param);
     // push the return value
     m_VMStack.Push();
 
-    Listener *const listener = a.listenerValue();
+    Listener *listener;
+    if (!a.tryListenerValue(listener)) {
+        // the return value is in the same slot as a when there are no parameters
+        const char *typeName = a.GetTypeName();
+        m_VMStack.GetTop().Clear();
+        raiseError("Cannot cast '%s' to listener", typeName);
+        return;
+    }
+
     if (!listener) {
         m_VMStack.GetTop().Clear();
-        throw ScriptException("command '%s' applied to NULL listener", Event::GetEventName(eventNum));
+        raiseError("command '%s' applied to NULL listener", Event::GetEventName(eventNum));
+        return;
     }
 
-    executeCommand<true, true>(listener, param, eventNum);
+    executeMethod<true>(listener, param, eventNum, cacheIndex);
 }
 
 void ScriptVM::execFunction(ScriptMaster& Director)
@@ -753,16 +1022,17 @@ void ScriptVM::execFunction(ScriptMaster& Director)
 
         Listener *listener;
 
-        try {
-            listener = m_VMStack.GetTop().listenerValue();
+        if (!m_VMStack.GetTop().tryListenerValue(listener)) {
+            const char *typeName = m_VMStack.GetTop().GetTypeName();
+            m_VMStack.Pop(params);
+            raiseError("Cannot cast '%s' to listener", typeName);
+            return;
+        }
 
-            if (!listener) {
-                const str& labelName = Director.GetString(label);
-                throw ScriptException("function '" + labelName + "' applied to NULL listener");
-            }
-        } catch (...) {
+        if (!listener) {
             m_VMStack.Pop(params);
-            throw;
+            raiseError("function '%s' applied to NULL listener", Director.GetString(label).c_str());
+            return;
         }
 
         m_VMStack.Pop();
@@ -789,17 +1059,22 @@ void ScriptVM::execFunction(ScriptMaster& Director)
         const op_parmNum_t params   = fetchOpcodeValue<op_parmNum_t>();
 
         Listener *listener;
-        try {
-            listener = m_VMStack.GetTop().listenerValue();
 
-            if (!listener) {
-                const str& labelStr = Director.GetString(label);
-                const str& fileStr  = Director.GetString(filename);
-                throw ScriptException("function '" + labelStr + "' in '" + fileStr + "' applied to NULL listener");
-            }
-        } catch (...) {
+        if (!m_VMStack.GetTop().tryListenerValue(listener)) {
+            const char *typeName = m_VMStack.GetTop().GetTypeName();
             m_VMStack.Pop(params);
-            throw;
+            raiseError("Cannot cast '%s' to listener", typeName);
+            return;
+        }
+
+        if (!listener) {
+            m_VMStack.Pop(params);
+            raiseError(
+                "function '%s' in '%s' applied to NULL listener",
+                Director.GetString(label).c_str(),
+                Director.GetString(filename).c_str()
+            );
+            return;
         }
 
         m_VMStack.Pop();
@@ -1010,12 +1285,14 @@ void ScriptVM::End()
 
 /*
 ====================
-Execute
+ExecuteLoop
 
-Executes a program
+Runs opcodes until the state changes.
+The traced variant checks script tracing before each opcode
 ====================
 */
-void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
+template<bool bTrace>
+void ScriptVM::ExecuteLoop()
 {
     unsigned char *opcode;
 
@@ -1027,44 +1304,138 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
     Listener *listener;
 
-    Event           ev;
-    ScriptVariable *var = NULL;
-
     TargetList *targetList;
 
-    if (Director.stackCount >= MAX_STACK_DEPTH) {
-        state = STATE_EXECUTION;
-
-        ScriptException::next_abort = -1;
-        throw ScriptException("stack overflow");
-    }
+#if SCRIPTVM_COMPUTED_GOTO
+    // Indexed by opcode, must follow the order of the opcode enum
+    static void *const dispatchTable[] = {
+        VM_LABEL(OP_DONE),
+        VM_LABEL(OP_BOOL_JUMP_FALSE4),
+        VM_LABEL(OP_BOOL_JUMP_TRUE4),
+        VM_LABEL(OP_VAR_JUMP_FALSE4),
+        VM_LABEL(OP_VAR_JUMP_TRUE4),
+        VM_LABEL(OP_BOOL_LOGICAL_AND),
+        VM_LABEL(OP_BOOL_LOGICAL_OR),
+        VM_LABEL(OP_VAR_LOGICAL_AND),
+        VM_LABEL(OP_VAR_LOGICAL_OR),
+        VM_LABEL_DEFAULT,
+        VM_LABEL(OP_JUMP4),
+        VM_LABEL(OP_JUMP_BACK4),
+        VM_LABEL(OP_STORE_INT0),
+        VM_LABEL(OP_STORE_INT1),
+        VM_LABEL(OP_STORE_INT2),
+        VM_LABEL(OP_STORE_INT3),
+        VM_LABEL(OP_STORE_INT4),
+        VM_LABEL(OP_BOOL_STORE_FALSE),
+        VM_LABEL(OP_BOOL_STORE_TRUE),
+        VM_LABEL(OP_STORE_STRING),
+        VM_LABEL(OP_STORE_FLOAT),
+        VM_LABEL(OP_STORE_VECTOR),
+        VM_LABEL(OP_CALC_VECTOR),
+        VM_LABEL(OP_STORE_NULL),
+        VM_LABEL(OP_STORE_NIL),
+        VM_LABEL(OP_EXEC_CMD0),
+        VM_LABEL(OP_EXEC_CMD1),
+        VM_LABEL(OP_EXEC_CMD2),
+        VM_LABEL(OP_EXEC_CMD3),
+        VM_LABEL(OP_EXEC_CMD4),
+        VM_LABEL(OP_EXEC_CMD5),
+        VM_LABEL(OP_EXEC_CMD_COUNT1),
+        VM_LABEL(OP_EXEC_CMD_METHOD0),
+        VM_LABEL(OP_EXEC_CMD_METHOD1),
+        VM_LABEL(OP_EXEC_CMD_METHOD2),
+        VM_LABEL(OP_EXEC_CMD_METHOD3),
+        VM_LABEL(OP_EXEC_CMD_METHOD4),
+        VM_LABEL(OP_EXEC_CMD_METHOD5),
+        VM_LABEL(OP_EXEC_CMD_METHOD_COUNT1),
+        VM_LABEL(OP_EXEC_METHOD0),
+        VM_LABEL(OP_EXEC_METHOD1),
+        VM_LABEL(OP_EXEC_METHOD2),
+        VM_LABEL(OP_EXEC_METHOD3),
+        VM_LABEL(OP_EXEC_METHOD4),
+        VM_LABEL(OP_EXEC_METHOD5),
+        VM_LABEL(OP_EXEC_METHOD_COUNT1),
+        VM_LABEL(OP_LOAD_GAME_VAR),
+        VM_LABEL(OP_LOAD_LEVEL_VAR),
+        VM_LABEL(OP_LOAD_LOCAL_VAR),
+        VM_LABEL(OP_LOAD_PARM_VAR),
+        VM_LABEL(OP_LOAD_SELF_VAR),
+        VM_LABEL(OP_LOAD_GROUP_VAR),
+        VM_LABEL(OP_LOAD_OWNER_VAR),
+        VM_LABEL(OP_LOAD_FIELD_VAR),
+        VM_LABEL(OP_LOAD_ARRAY_VAR),
+        VM_LABEL(OP_LOAD_CONST_ARRAY1),
+        VM_LABEL(OP_STORE_FIELD_REF),
+        VM_LABEL(OP_STORE_ARRAY_REF),
+        VM_LABEL(OP_MARK_STACK_POS),
+        VM_LABEL(OP_STORE_PARAM),
+        VM_LABEL(OP_RESTORE_STACK_POS),
+        VM_LABEL(OP_LOAD_STORE_GAME_VAR),
+        VM_LABEL(OP_LOAD_STORE_LEVEL_VAR),
+        VM_LABEL(OP_LOAD_STORE_LOCAL_VAR),
+        VM_LABEL(OP_LOAD_STORE_PARM_VAR),
+        VM_LABEL(OP_LOAD_STORE_SELF_VAR),
+        VM_LABEL(OP_LOAD_STORE_GROUP_VAR),
+        VM_LABEL(OP_LOAD_STORE_OWNER_VAR),
+        VM_LABEL(OP_STORE_GAME_VAR),
+        VM_LABEL(OP_STORE_LEVEL_VAR),
+        VM_LABEL(OP_STORE_LOCAL_VAR),
+        VM_LABEL(OP_STORE_PARM_VAR),
+        VM_LABEL(OP_STORE_SELF_VAR),
+        VM_LABEL(OP_STORE_GROUP_VAR),
+        VM_LABEL(OP_STORE_OWNER_VAR),
+        VM_LABEL(OP_STORE_FIELD),
+        VM_LABEL(OP_STORE_ARRAY),
+        VM_LABEL(OP_STORE_GAME),
+        VM_LABEL(OP_STORE_LEVEL),
+        VM_LABEL(OP_STORE_LOCAL),
+        VM_LABEL(OP_STORE_PARM),
+        VM_LABEL(OP_STORE_SELF),
+        VM_LABEL(OP_STORE_GROUP),
+        VM_LABEL(OP_STORE_OWNER),
+        VM_LABEL(OP_BIN_BITWISE_AND),
+        VM_LABEL(OP_BIN_BITWISE_OR),
+        VM_LABEL(OP_BIN_BITWISE_EXCL_OR),
+        VM_LABEL(OP_BIN_EQUALITY),
+        VM_LABEL(OP_BIN_INEQUALITY),
+        VM_LABEL(OP_BIN_LESS_THAN),
+        VM_LABEL(OP_BIN_GREATER_THAN),
+        VM_LABEL(OP_BIN_LESS_THAN_OR_EQUAL),
+        VM_LABEL(OP_BIN_GREATER_THAN_OR_EQUAL),
+        VM_LABEL(OP_BIN_PLUS),
+        VM_LABEL(OP_BIN_MINUS),
+        VM_LABEL(OP_BIN_MULTIPLY),
+        VM_LABEL(OP_BIN_DIVIDE),
+        VM_LABEL(OP_BIN_PERCENTAGE),
+        VM_LABEL(OP_UN_MINUS),
+        VM_LABEL(OP_UN_COMPLEMENT),
+        VM_LABEL(OP_UN_TARGETNAME),
+        VM_LABEL(OP_BOOL_UN_NOT),
+        VM_LABEL(OP_VAR_UN_NOT),
+        VM_LABEL(OP_UN_CAST_BOOLEAN),
+        VM_LABEL(OP_UN_INC),
+        VM_LABEL(OP_UN_DEC),
+        VM_LABEL(OP_UN_SIZE),
+        VM_LABEL(OP_SWITCH),
+        VM_LABEL(OP_FUNC),
+        VM_LABEL(OP_NOP),
+        VM_LABEL(OP_BIN_SHIFT_LEFT),
+        VM_LABEL(OP_BIN_SHIFT_RIGHT),
+        VM_LABEL_DEFAULT,
+        VM_LABEL_DEFAULT,
+        VM_LABEL(OP_BIN_COMPARE_JUMP_FALSE4),
+        VM_LABEL(OP_EXEC_CMD_SELF_METHOD_COUNT1),
+        VM_LABEL(OP_LOCAL_COMPARE_JUMP_FALSE4)
+    };
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == OP_MAX, "Missing opcodes in the dispatch table");
+#endif
 
-    if (label.length()) {
-        // Throw if label is not found
-        m_CodePos = m_ScriptClass->FindLabel(label);
-        if (!m_CodePos) {
-            ScriptError("ScriptVM::Execute: label '%s' does not exist in '%s'.", label.c_str(), Filename().c_str());
+    while (state == STATE_RUNNING) {
+        if (bTrace && g_scriptprofile->integer > 0 && m_PrevCodePos) {
+            ScriptProfile.CountOpcode(this, g_scriptprofile->integer);
         }
-    }
-
-    if (g_scripttrace->integer && CanScriptTracePrint()) {
-        gi.DPrintf2(
-            "+++FRAME: %i (%p) +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n",
-            Director.stackCount,
-            this
-        );
-    }
 
-    Director.stackCount++;
-
-    if (dataSize) {
-        SetFastData(data, dataSize);
-    }
-
-    state = STATE_RUNNING;
-
-    while (state == STATE_RUNNING) {
-        if (g_scripttrace->integer && CanScriptTracePrint()) {
+        if (bTrace && g_scripttrace->integer && CanScriptTracePrint()) {
             switch (g_scripttrace->integer) {
             case 1:
             case 3:
@@ -1079,9 +1450,8 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
         m_PrevCodePos = m_CodePos;
 
-        try {
-            if (!m_VMStack.m_bMarkStack) {
-                /*
+        if (!m_VMStack.m_bMarkStack) {
+            /*
 				assert(pTop >= localStack && pTop < localStack + localStackSize);
 				if (pTop < localStack)
 				{
@@ -1100,790 +1470,888 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 					break;
 				}
 				*/
-            }
+        }
 
-            opcode = m_CodePos++;
-            switch (*opcode) {
-            case OP_BIN_BITWISE_AND:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        opcode = m_CodePos++;
+        VM_DISPATCH(*opcode);
+        switch (*opcode) {
+        VM_CASE(OP_BIN_BITWISE_AND):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b &= *a;
-                break;
+            *b &= *a;
+            VM_NEXT();
 
-            case OP_BIN_BITWISE_OR:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_BITWISE_OR):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b |= *a;
-                break;
+            *b |= *a;
+            VM_NEXT();
 
-            case OP_BIN_BITWISE_EXCL_OR:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_BITWISE_EXCL_OR):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b ^= *a;
-                break;
+            *b ^= *a;
+            VM_NEXT();
 
-            case OP_BIN_EQUALITY:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_EQUALITY):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                b->setIntValue(*b == *a);
-                break;
+            b->setIntValue(*b == *a);
+            VM_NEXT();
 
-            case OP_BIN_INEQUALITY:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_INEQUALITY):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                b->setIntValue(*b != *a);
-                break;
+            b->setIntValue(*b != *a);
+            VM_NEXT();
 
-            case OP_BIN_GREATER_THAN:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_GREATER_THAN):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                b->greaterthan(*a);
-                break;
+            b->greaterthan(*a);
+            VM_NEXT();
 
-            case OP_BIN_GREATER_THAN_OR_EQUAL:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_GREATER_THAN_OR_EQUAL):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                b->greaterthanorequal(*a);
-                break;
+            b->greaterthanorequal(*a);
+            VM_NEXT();
 
-            case OP_BIN_LESS_THAN:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_LESS_THAN):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                b->lessthan(*a);
-                break;
+            b->lessthan(*a);
+            VM_NEXT();
 
-            case OP_BIN_LESS_THAN_OR_EQUAL:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_LESS_THAN_OR_EQUAL):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                b->lessthanorequal(*a);
-                break;
+            b->lessthanorequal(*a);
+            VM_NEXT();
 
-            case OP_BIN_PLUS:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_PLUS):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b += *a;
-                break;
+            *b += *a;
+            VM_NEXT();
 
-            case OP_BIN_MINUS:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_MINUS):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b -= *a;
-                break;
+            *b -= *a;
+            VM_NEXT();
 
-            case OP_BIN_MULTIPLY:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_MULTIPLY):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b *= *a;
-                break;
+            *b *= *a;
+            VM_NEXT();
 
-            case OP_BIN_DIVIDE:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_DIVIDE):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b /= *a;
-                break;
+            *b /= *a;
+            VM_NEXT();
 
-            case OP_BIN_PERCENTAGE:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_PERCENTAGE):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b %= *a;
-                break;
+            *b %= *a;
+            VM_NEXT();
 
-            case OP_BIN_SHIFT_LEFT:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_SHIFT_LEFT):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b <<= *a;
-                break;
+            *b <<= *a;
+            VM_NEXT();
 
-            case OP_BIN_SHIFT_RIGHT:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.GetTop();
+        VM_CASE(OP_BIN_SHIFT_RIGHT):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.GetTop();
 
-                *b >>= *a;
-                break;
+            *b >>= *a;
+            VM_NEXT();
 
-            case OP_BOOL_JUMP_FALSE4:
-                doJumpIf(!m_VMStack.Pop().m_data.intValue);
-                break;
+        VM_CASE(OP_BOOL_JUMP_FALSE4):
+            doJumpIf(!m_VMStack.Pop().m_data.intValue);
+            VM_NEXT();
 
-            case OP_BOOL_JUMP_TRUE4:
-                doJumpIf(m_VMStack.Pop().m_data.intValue);
-                break;
+        VM_CASE(OP_BOOL_JUMP_TRUE4):
+            doJumpIf(m_VMStack.Pop().m_data.intValue);
+            VM_NEXT();
+
+        VM_CASE(OP_VAR_JUMP_FALSE4):
+            doJumpIf(!m_VMStack.Pop().booleanValue());
+            VM_NEXT();
+
+        VM_CASE(OP_VAR_JUMP_TRUE4):
+            doJumpIf(m_VMStack.Pop().booleanValue());
+            VM_NEXT();
+
+        VM_CASE(OP_BOOL_LOGICAL_AND):
+            doJumpVarIf(!m_VMStack.GetTop().m_data.intValue);
+            VM_NEXT();
+
+        VM_CASE(OP_BOOL_LOGICAL_OR):
+            doJumpVarIf(m_VMStack.GetTop().m_data.intValue);
+            VM_NEXT();
+
+        VM_CASE(OP_BIN_COMPARE_JUMP_FALSE4):
+            doCompareJumpFalse();
+            VM_NEXT();
+
+        VM_CASE(OP_LOCAL_COMPARE_JUMP_FALSE4):
+            // may run a getter, like OP_STORE_LOCAL_VAR
+            doLocalCompareJumpFalse();
+            break;
+
+        VM_CASE(OP_VAR_LOGICAL_AND):
+            if (!doJumpVarIf(m_VMStack.GetTop().booleanValue())) {
+                m_VMStack.GetTop().SetFalse();
+            }
+            VM_NEXT();
+
+        VM_CASE(OP_VAR_LOGICAL_OR):
+            if (!doJumpVarIf(!m_VMStack.GetTop().booleanValue())) {
+                m_VMStack.GetTop().SetTrue();
+            }
+            VM_NEXT();
+
+        VM_CASE(OP_BOOL_STORE_FALSE):
+            m_VMStack.PushAndGet().SetFalse();
+            VM_NEXT();
+
+        VM_CASE(OP_BOOL_STORE_TRUE):
+            m_VMStack.PushAndGet().SetTrue();
+            VM_NEXT();
+
+        VM_CASE(OP_BOOL_UN_NOT):
+            m_VMStack.GetTop().m_data.intValue = (m_VMStack.GetTop().m_data.intValue == 0);
+            VM_NEXT();
+
+        VM_CASE(OP_CALC_VECTOR):
+            c = &m_VMStack.Pop();
+            b = &m_VMStack.Pop();
+            a = &m_VMStack.GetTop();
+
+            m_VMStack.GetTop().setVectorValue(Vector(a->floatValue(), b->floatValue(), c->floatValue()));
+            VM_NEXT();
 
-            case OP_VAR_JUMP_FALSE4:
-                doJumpIf(!m_VMStack.Pop().booleanValue());
+        VM_CASE(OP_EXEC_CMD0):
+            {
+                execCmdCommon(0);
                 break;
+            }
 
-            case OP_VAR_JUMP_TRUE4:
-                doJumpIf(m_VMStack.Pop().booleanValue());
+        VM_CASE(OP_EXEC_CMD1):
+            {
+                execCmdCommon(1);
                 break;
+            }
 
-            case OP_BOOL_LOGICAL_AND:
-                doJumpVarIf(!m_VMStack.GetTop().m_data.intValue);
+        VM_CASE(OP_EXEC_CMD2):
+            {
+                execCmdCommon(2);
                 break;
+            }
 
-            case OP_BOOL_LOGICAL_OR:
-                doJumpVarIf(m_VMStack.GetTop().m_data.intValue);
+        VM_CASE(OP_EXEC_CMD3):
+            {
+                execCmdCommon(3);
                 break;
+            }
 
-            case OP_VAR_LOGICAL_AND:
-                if (!doJumpVarIf(m_VMStack.GetTop().booleanValue())) {
-                    m_VMStack.GetTop().SetFalse();
-                }
+        VM_CASE(OP_EXEC_CMD4):
+            {
+                execCmdCommon(4);
                 break;
+            }
 
-            case OP_VAR_LOGICAL_OR:
-                if (!doJumpVarIf(!m_VMStack.GetTop().booleanValue())) {
-                    m_VMStack.GetTop().SetTrue();
-                }
+        VM_CASE(OP_EXEC_CMD5):
+            {
+                execCmdCommon(5);
                 break;
+            }
 
-            case OP_BOOL_STORE_FALSE:
-                m_VMStack.PushAndGet().SetFalse();
+        VM_CASE(OP_EXEC_CMD_COUNT1):
+            {
+                const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
+                execCmdCommon(numParms);
                 break;
+            }
 
-            case OP_BOOL_STORE_TRUE:
-                m_VMStack.PushAndGet().SetTrue();
+        VM_CASE(OP_EXEC_CMD_METHOD0):
+            {
+                execCmdMethodCommon(0);
                 break;
+            }
 
-            case OP_BOOL_UN_NOT:
-                m_VMStack.GetTop().m_data.intValue = (m_VMStack.GetTop().m_data.intValue == 0);
+        VM_CASE(OP_EXEC_CMD_METHOD1):
+            {
+                execCmdMethodCommon(1);
                 break;
+            }
 
-            case OP_CALC_VECTOR:
-                c = &m_VMStack.Pop();
-                b = &m_VMStack.Pop();
-                a = &m_VMStack.GetTop();
+        VM_CASE(OP_EXEC_CMD_METHOD2):
+            {
+                execCmdMethodCommon(2);
+                break;
+            }
 
-                m_VMStack.GetTop().setVectorValue(Vector(a->floatValue(), b->floatValue(), c->floatValue()));
+        VM_CASE(OP_EXEC_CMD_METHOD3):
+            {
+                execCmdMethodCommon(3);
                 break;
+            }
 
-            case OP_EXEC_CMD0:
-                {
-                    execCmdCommon(0);
-                    break;
-                }
+        VM_CASE(OP_EXEC_CMD_METHOD4):
+            {
+                execCmdMethodCommon(4);
+                break;
+            }
 
-            case OP_EXEC_CMD1:
-                {
-                    execCmdCommon(1);
-                    break;
-                }
+        VM_CASE(OP_EXEC_CMD_METHOD5):
+            {
+                execCmdMethodCommon(5);
+                break;
+            }
 
-            case OP_EXEC_CMD2:
-                {
-                    execCmdCommon(2);
-                    break;
-                }
+        VM_CASE(OP_EXEC_CMD_METHOD_COUNT1):
+            {
+                const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
+                execCmdMethodCommon(numParms);
+                break;
+            }
 
-            case OP_EXEC_CMD3:
-                {
-                    execCmdCommon(3);
-                    break;
-                }
+        VM_CASE(OP_EXEC_CMD_SELF_METHOD_COUNT1):
+            {
+                const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
+                execCmdSelfMethod(numParms);
+                break;
+            }
 
-            case OP_EXEC_CMD4:
-                {
-                    execCmdCommon(4);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD0):
+            {
+                execMethodCommon(0);
+                break;
+            }
 
-            case OP_EXEC_CMD5:
-                {
-                    execCmdCommon(5);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD1):
+            {
+                execMethodCommon(1);
+                break;
+            }
 
-            case OP_EXEC_CMD_COUNT1:
-                {
-                    const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
-                    execCmdCommon(numParms);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD2):
+            {
+                execMethodCommon(2);
+                break;
+            }
 
-            case OP_EXEC_CMD_METHOD0:
-                {
-                    execCmdMethodCommon(0);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD3):
+            {
+                execMethodCommon(3);
+                break;
+            }
 
-            case OP_EXEC_CMD_METHOD1:
-                {
-                    execCmdMethodCommon(1);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD4):
+            {
+                execMethodCommon(4);
+                break;
+            }
 
-            case OP_EXEC_CMD_METHOD2:
-                {
-                    execCmdMethodCommon(2);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD5):
+            {
+                execMethodCommon(5);
+                break;
+            }
 
-            case OP_EXEC_CMD_METHOD3:
-                {
-                    execCmdMethodCommon(3);
-                    break;
-                }
+        VM_CASE(OP_EXEC_METHOD_COUNT1):
+            {
+                const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
+                execMethodCommon(numParms);
+                break;
+            }
 
-            case OP_EXEC_CMD_METHOD4:
-                {
-                    execCmdMethodCommon(4);
-                    break;
-                }
+        VM_CASE(OP_FUNC):
+            {
+                execFunction(Director);
+                break;
+            }
 
-            case OP_EXEC_CMD_METHOD5:
-                {
-                    execCmdMethodCommon(5);
-                    break;
-                }
+        VM_CASE(OP_JUMP4):
+            jump(fetchOpcodeValue<unsigned int>());
+            VM_NEXT();
 
-            case OP_EXEC_CMD_METHOD_COUNT1:
-                {
-                    const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
-                    execCmdMethodCommon(numParms);
-                    break;
-                }
+        VM_CASE(OP_JUMP_BACK4):
+            jumpBack(fetchActualOpcodeValue<unsigned int>());
+            VM_NEXT();
 
-            case OP_EXEC_METHOD0:
-                {
-                    execMethodCommon(0);
-                    break;
-                }
+        VM_CASE(OP_LOAD_ARRAY_VAR):
+            a = &m_VMStack.Pop();
+            b = &m_VMStack.Pop();
+            c = &m_VMStack.Pop();
 
-            case OP_EXEC_METHOD1:
-                {
-                    execMethodCommon(1);
-                    break;
-                }
+            b->setArrayAt(*a, *c);
+            VM_NEXT();
 
-            case OP_EXEC_METHOD2:
-                {
-                    execMethodCommon(2);
-                    break;
-                }
+        VM_CASE(OP_LOAD_FIELD_VAR):
+            a = &m_VMStack.Pop();
 
-            case OP_EXEC_METHOD3:
-                {
-                    execMethodCommon(3);
-                    break;
-                }
+            if (!a->tryListenerValue(listener)) {
+                skipField();
+                m_VMStack.Pop();
+                raiseError("Cannot cast '%s' to listener", a->GetTypeName());
+                continue;
+            }
 
-            case OP_EXEC_METHOD4:
-                {
-                    execMethodCommon(4);
-                    break;
-                }
+            if (listener == NULL) {
+                fieldNameIndex = fetchActualOpcodeValue<op_name_t>();
+                skipField();
+                m_VMStack.Pop();
+                raiseError("Field '%s' applied to NULL listener", Director.GetString(fieldNameIndex).c_str());
+                continue;
+            }
 
-            case OP_EXEC_METHOD5:
-                {
-                    execMethodCommon(5);
-                    break;
-                }
+            try {
+                loadTop(listener);
+            } catch (...) {
+                m_VMStack.Pop();
+                throw;
+            }
 
-            case OP_EXEC_METHOD_COUNT1:
-                {
-                    const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
-                    execMethodCommon(numParms);
-                    break;
-                }
+            break;
 
-            case OP_FUNC:
-                {
-                    execFunction(Director);
-                    break;
-                }
+        VM_CASE(OP_LOAD_CONST_ARRAY1):
+            {
+                op_arrayParmNum_t numParms = fetchOpcodeValue<op_arrayParmNum_t>();
 
-            case OP_JUMP4:
-                jump(fetchOpcodeValue<unsigned int>());
-                break;
+                ScriptVariable& pTop = m_VMStack.PopAndGet(numParms - 1);
+                pTop.setConstArrayValue(&pTop, numParms);
+                VM_NEXT();
+            }
 
-            case OP_JUMP_BACK4:
-                jumpBack(fetchActualOpcodeValue<unsigned int>());
-                break;
+        VM_CASE(OP_LOAD_GAME_VAR):
+            loadTop(&game);
+            break;
 
-            case OP_LOAD_ARRAY_VAR:
-                a = &m_VMStack.Pop();
-                b = &m_VMStack.Pop();
-                c = &m_VMStack.Pop();
+        VM_CASE(OP_LOAD_GROUP_VAR):
+            loadTop(m_ScriptClass);
+            break;
 
-                b->setArrayAt(*a, *c);
-                break;
+        VM_CASE(OP_LOAD_LEVEL_VAR):
+            loadTop(&level);
+            break;
 
-            case OP_LOAD_FIELD_VAR:
-                a = &m_VMStack.Pop();
-
-                try {
-                    try {
-                        listener = a->listenerValue();
-
-                        if (listener == NULL) {
-                            fieldNameIndex = fetchActualOpcodeValue<op_name_t>();
-                            ScriptError(
-                                "Field '%s' applied to NULL listener", Director.GetString(fieldNameIndex).c_str()
-                            );
-                        }
-                    } catch (...) {
-                        skipField();
-                        throw;
-                    }
-
-                    loadTop(listener);
-                } catch (...) {
-                    m_VMStack.Pop();
-                    throw;
-                }
+        VM_CASE(OP_LOAD_LOCAL_VAR):
+            loadTop(m_Thread);
+            break;
 
-                break;
+        VM_CASE(OP_LOAD_OWNER_VAR):
+            if (!m_ScriptClass->m_Self) {
+                m_VMStack.Pop();
+                skipField();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_LOAD_CONST_ARRAY1:
-                {
-                    op_arrayParmNum_t numParms = fetchOpcodeValue<op_arrayParmNum_t>();
+            if (!m_ScriptClass->m_Self->GetScriptOwner()) {
+                m_VMStack.Pop();
+                skipField();
+                raiseError("self.owner is NULL");
+                continue;
+            }
 
-                    ScriptVariable& pTop = m_VMStack.PopAndGet(numParms - 1);
-                    pTop.setConstArrayValue(&pTop, numParms);
-                    break;
-                }
+            loadTop(m_ScriptClass->m_Self->GetScriptOwner());
+            break;
 
-            case OP_LOAD_GAME_VAR:
-                loadTop(&game);
-                break;
+        VM_CASE(OP_LOAD_PARM_VAR):
+            loadTop(&parm);
+            break;
 
-            case OP_LOAD_GROUP_VAR:
-                loadTop(m_ScriptClass);
-                break;
+        VM_CASE(OP_LOAD_SELF_VAR):
+            if (!m_ScriptClass->m_Self) {
+                m_VMStack.Pop();
+                skipField();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_LOAD_LEVEL_VAR:
-                loadTop(&level);
-                break;
+            loadTop(m_ScriptClass->m_Self);
+            break;
 
-            case OP_LOAD_LOCAL_VAR:
-                loadTop(m_Thread);
-                break;
+        VM_CASE(OP_LOAD_STORE_GAME_VAR):
+            loadStoreTop(&game);
+            break;
 
-            case OP_LOAD_OWNER_VAR:
-                if (!m_ScriptClass->m_Self) {
-                    m_VMStack.Pop();
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self is NULL");
-                }
+        VM_CASE(OP_LOAD_STORE_GROUP_VAR):
+            loadStoreTop(m_ScriptClass);
+            break;
 
-                if (!m_ScriptClass->m_Self->GetScriptOwner()) {
-                    m_VMStack.Pop();
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self.owner is NULL");
-                }
+        VM_CASE(OP_LOAD_STORE_LEVEL_VAR):
+            loadStoreTop(&level);
+            break;
 
-                loadTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+        VM_CASE(OP_LOAD_STORE_LOCAL_VAR):
+            loadStoreTop(m_Thread);
+            break;
 
-            case OP_LOAD_PARM_VAR:
-                loadTop(&parm);
-                break;
+        VM_CASE(OP_LOAD_STORE_OWNER_VAR):
+            if (!m_ScriptClass->m_Self) {
+                skipField();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_LOAD_SELF_VAR:
-                if (!m_ScriptClass->m_Self) {
-                    m_VMStack.Pop();
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self is NULL");
-                }
+            if (!m_ScriptClass->m_Self->GetScriptOwner()) {
+                skipField();
+                raiseError("self.owner is NULL");
+                continue;
+            }
 
-                loadTop(m_ScriptClass->m_Self);
-                break;
+            loadStoreTop(m_ScriptClass->m_Self->GetScriptOwner());
+            break;
 
-            case OP_LOAD_STORE_GAME_VAR:
-                loadStoreTop(&game);
-                break;
+        VM_CASE(OP_LOAD_STORE_PARM_VAR):
+            loadStoreTop(&parm);
+            break;
 
-            case OP_LOAD_STORE_GROUP_VAR:
-                loadStoreTop(m_ScriptClass);
-                break;
+        VM_CASE(OP_LOAD_STORE_SELF_VAR):
+            if (!m_ScriptClass->m_Self) {
+                skipField();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_LOAD_STORE_LEVEL_VAR:
-                loadStoreTop(&level);
-                break;
+            loadStoreTop(m_ScriptClass->m_Self);
+            break;
 
-            case OP_LOAD_STORE_LOCAL_VAR:
-                loadStoreTop(m_Thread);
-                break;
+        VM_CASE(OP_MARK_STACK_POS):
+            m_StackPos             = &m_VMStack.GetTop();
+            m_VMStack.m_bMarkStack = true;
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_PARAM):
+            if (fastEvent.dataSize) {
+                m_VMStack.SetTop(*(fastEvent.data++));
+                fastEvent.dataSize--;
+            } else {
+                m_VMStack.SetTop(*(m_StackPos + 1));
+                m_VMStack.GetTop().Clear();
+            }
+            VM_NEXT();
 
-            case OP_LOAD_STORE_OWNER_VAR:
-                if (!m_ScriptClass->m_Self) {
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self is NULL");
-                }
+        VM_CASE(OP_RESTORE_STACK_POS):
+            m_VMStack.SetTop(*m_StackPos);
+            m_VMStack.m_bMarkStack = false;
+            VM_NEXT();
 
-                if (!m_ScriptClass->m_Self->GetScriptOwner()) {
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self.owner is NULL");
-                }
+        VM_CASE(OP_STORE_ARRAY):
+            m_VMStack.Pop();
+            m_VMStack.GetTop().evalArrayAt(*(m_VMStack.GetTopPtr() + 1));
+            VM_NEXT();
 
-                loadStoreTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+        VM_CASE(OP_STORE_ARRAY_REF):
+            m_VMStack.Pop();
+            m_VMStack.GetTop().setArrayRefValue(*(m_VMStack.GetTopPtr() + 1));
+            VM_NEXT();
 
-            case OP_LOAD_STORE_PARM_VAR:
-                loadStoreTop(&parm);
-                break;
+        VM_CASE(OP_STORE_FIELD_REF):
+            if (!m_VMStack.GetTop().tryListenerValue(listener)) {
+                const char *typeName = m_VMStack.GetTop().GetTypeName();
 
-            case OP_LOAD_STORE_SELF_VAR:
-                if (!m_ScriptClass->m_Self) {
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self is NULL");
-                }
+                skipField();
+                m_VMStack.GetTop().Clear();
+                m_VMStack.GetTop().setRefValue(m_VMStack.GetTopPtr());
+                raiseError("Cannot cast '%s' to listener", typeName);
+                continue;
+            }
 
-                loadStoreTop(m_ScriptClass->m_Self);
-                break;
+            if (listener == nullptr) {
+                fieldNameIndex = fetchActualOpcodeValue<op_name_t>();
+                skipField();
+                m_VMStack.GetTop().Clear();
+                m_VMStack.GetTop().setRefValue(m_VMStack.GetTopPtr());
+                raiseError("Field '%s' applied to NULL listener", Director.GetString(fieldNameIndex).c_str());
+                continue;
+            }
 
-            case OP_MARK_STACK_POS:
-                m_StackPos             = &m_VMStack.GetTop();
-                m_VMStack.m_bMarkStack = true;
-                break;
+            try {
+                ScriptVariable *const listenerVar = storeTop<true>(listener);
 
-            case OP_STORE_PARAM:
-                if (fastEvent.dataSize) {
-                    m_VMStack.SetTop(*(fastEvent.data++));
-                    fastEvent.dataSize--;
-                } else {
-                    m_VMStack.SetTop(*(m_StackPos + 1));
-                    m_VMStack.GetTop().Clear();
+                if (listenerVar) {
+                    // having a listener variable means the variable was just created
+                    m_VMStack.GetTop().setRefValue(listenerVar);
                 }
                 break;
+            } catch (...) {
+                ScriptVariable *const pTop = m_VMStack.GetTopPtr();
+                pTop->setRefValue(pTop);
+                throw;
+            }
 
-            case OP_RESTORE_STACK_POS:
-                m_VMStack.SetTop(*m_StackPos);
-                m_VMStack.m_bMarkStack = false;
-                break;
+        VM_CASE(OP_STORE_FIELD):
+            if (!m_VMStack.GetTop().tryListenerValue(listener)) {
+                const char *typeName = m_VMStack.GetTop().GetTypeName();
 
-            case OP_STORE_ARRAY:
-                m_VMStack.Pop();
-                m_VMStack.GetTop().evalArrayAt(*(m_VMStack.GetTopPtr() + 1));
-                break;
+                skipField();
+                m_VMStack.GetTop().Clear();
+                raiseError("Cannot cast '%s' to listener", typeName);
+                continue;
+            }
 
-            case OP_STORE_ARRAY_REF:
-                m_VMStack.Pop();
-                m_VMStack.GetTop().setArrayRefValue(*(m_VMStack.GetTopPtr() + 1));
-                break;
+            if (listener == nullptr) {
+                fieldNameIndex = fetchActualOpcodeValue<op_name_t>();
+                skipField();
+                m_VMStack.GetTop().Clear();
+                raiseError("Field '%s' applied to NULL listener", Director.GetString(fieldNameIndex).c_str());
+                continue;
+            }
 
-            case OP_STORE_FIELD_REF:
-                try {
-                    try {
-                        listener = m_VMStack.GetTop().listenerValue();
-
-                        if (listener == nullptr) {
-                            fieldNameIndex = fetchActualOpcodeValue<op_name_t>();
-                            ScriptError(
-                                "Field '%s' applied to NULL listener", Director.GetString(fieldNameIndex).c_str()
-                            );
-                        }
-                    } catch (...) {
-                        skipField();
-                        m_VMStack.GetTop().Clear();
-                        throw;
-                    }
-
-                    ScriptVariable *const listenerVar = storeTop<true>(listener);
-
-                    if (listenerVar) {
-                        // having a listener variable means the variable was just created
-                        m_VMStack.GetTop().setRefValue(listenerVar);
-                    }
-                    break;
-                } catch (...) {
-                    ScriptVariable *const pTop = m_VMStack.GetTopPtr();
-                    pTop->setRefValue(pTop);
-                    throw;
-                }
+            storeTop<true>(listener);
+            break;
 
-            case OP_STORE_FIELD:
-                try {
-                    listener = m_VMStack.GetTop().listenerValue();
-
-                    if (listener == nullptr) {
-                        fieldNameIndex = fetchActualOpcodeValue<op_name_t>();
-                        ScriptError("Field '%s' applied to NULL listener", Director.GetString(fieldNameIndex).c_str());
-                    }
-                } catch (...) {
-                    skipField();
-                    m_VMStack.GetTop().Clear();
-                    throw;
-                }
+        VM_CASE(OP_STORE_FLOAT):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setFloatValue(fetchOpcodeValue<float>());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_INT0):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setIntValue(0);
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_INT1):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setIntValue(fetchOpcodeValue<byte>());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_INT2):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short>());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_INT3):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short3>());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_INT4):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setIntValue(fetchOpcodeValue<int>());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_GAME_VAR):
+            storeTop(&game);
+            break;
 
-                storeTop<true>(listener);
-                break;
+        VM_CASE(OP_STORE_GROUP_VAR):
+            storeTop(m_ScriptClass);
+            break;
 
-            case OP_STORE_FLOAT:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setFloatValue(fetchOpcodeValue<float>());
-                break;
+        VM_CASE(OP_STORE_LEVEL_VAR):
+            storeTop(&level);
+            break;
 
-            case OP_STORE_INT0:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setIntValue(0);
-                break;
+        VM_CASE(OP_STORE_LOCAL_VAR):
+            storeTop(m_Thread);
+            break;
 
-            case OP_STORE_INT1:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setIntValue(fetchOpcodeValue<byte>());
-                break;
+        VM_CASE(OP_STORE_OWNER_VAR):
+            if (!m_ScriptClass->m_Self) {
+                m_VMStack.PushAndGet().Clear();
+                skipField();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_STORE_INT2:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short>());
-                break;
+            if (!m_ScriptClass->m_Self->GetScriptOwner()) {
+                m_VMStack.PushAndGet().Clear();
+                skipField();
+                raiseError("self.owner is NULL");
+                continue;
+            }
 
-            case OP_STORE_INT3:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short3>());
-                break;
+            storeTop(m_ScriptClass->m_Self->GetScriptOwner());
+            break;
 
-            case OP_STORE_INT4:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setIntValue(fetchOpcodeValue<int>());
-                break;
+        VM_CASE(OP_STORE_PARM_VAR):
+            storeTop(&parm);
+            break;
 
-            case OP_STORE_GAME_VAR:
-                storeTop(&game);
-                break;
+        VM_CASE(OP_STORE_SELF_VAR):
+            if (!m_ScriptClass->m_Self) {
+                m_VMStack.PushAndGet().Clear();
+                skipField();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_STORE_GROUP_VAR:
-                storeTop(m_ScriptClass);
-                break;
+            storeTop(m_ScriptClass->m_Self);
+            break;
 
-            case OP_STORE_LEVEL_VAR:
-                storeTop(&level);
-                break;
+        VM_CASE(OP_STORE_GAME):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(&game);
+            VM_NEXT();
 
-            case OP_STORE_LOCAL_VAR:
-                storeTop(m_Thread);
-                break;
+        VM_CASE(OP_STORE_GROUP):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(m_ScriptClass);
+            VM_NEXT();
 
-            case OP_STORE_OWNER_VAR:
-                if (!m_ScriptClass->m_Self) {
-                    m_VMStack.PushAndGet().Clear();
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self is NULL");
-                }
+        VM_CASE(OP_STORE_LEVEL):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(&level);
+            VM_NEXT();
 
-                if (!m_ScriptClass->m_Self->GetScriptOwner()) {
-                    m_VMStack.PushAndGet().Clear();
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self.owner is NULL");
-                }
+        VM_CASE(OP_STORE_LOCAL):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(m_Thread);
+            VM_NEXT();
 
-                storeTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+        VM_CASE(OP_STORE_OWNER):
+            if (m_ScriptClass->m_Self) {
+                m_VMStack.Push();
+            } else {
+                m_VMStack.PushAndGet().Clear();
+                raiseError("self is NULL");
+                continue;
+            }
 
-            case OP_STORE_PARM_VAR:
-                storeTop(&parm);
-                break;
+            m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self->GetScriptOwner());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_PARM):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(&parm);
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_SELF):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self);
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_NIL):
+            m_VMStack.Push();
+            m_VMStack.GetTop().Clear();
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_NULL):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setListenerValue(NULL);
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_STRING):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setConstStringValue(fetchOpcodeValue<unsigned int>());
+            VM_NEXT();
+
+        VM_CASE(OP_STORE_VECTOR):
+            m_VMStack.Push();
+            m_VMStack.GetTop().setVectorValue(fetchOpcodeValue<Vector>());
+            VM_NEXT();
+
+        VM_CASE(OP_SWITCH):
+            if (!Switch(fetchActualOpcodeValue<StateScript *>(), m_VMStack.Pop())) {
+                m_CodePos += sizeof(StateScript *);
+            }
+            VM_NEXT();
 
-            case OP_STORE_SELF_VAR:
-                if (!m_ScriptClass->m_Self) {
-                    m_VMStack.PushAndGet().Clear();
-                    m_CodePos += sizeof(unsigned int);
-                    ScriptError("self is NULL");
-                }
+        VM_CASE(OP_UN_CAST_BOOLEAN):
+            m_VMStack.GetTop().CastBoolean();
+            VM_NEXT();
 
-                storeTop(m_ScriptClass->m_Self);
-                break;
+        VM_CASE(OP_UN_COMPLEMENT):
+            m_VMStack.GetTop().complement();
+            VM_NEXT();
 
-            case OP_STORE_GAME:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(&game);
-                break;
+        VM_CASE(OP_UN_MINUS):
+            m_VMStack.GetTop().minus();
+            VM_NEXT();
 
-            case OP_STORE_GROUP:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(m_ScriptClass);
-                break;
+        VM_CASE(OP_UN_DEC):
+            m_VMStack.GetTop()--;
+            VM_NEXT();
 
-            case OP_STORE_LEVEL:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(&level);
-                break;
+        VM_CASE(OP_UN_INC):
+            m_VMStack.GetTop()++;
+            VM_NEXT();
 
-            case OP_STORE_LOCAL:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(m_Thread);
-                break;
+        VM_CASE(OP_UN_SIZE):
+            m_VMStack.GetTop().setIntValue((int)m_VMStack.GetTop().size());
+            VM_NEXT();
 
-            case OP_STORE_OWNER:
-                if (m_ScriptClass->m_Self) {
-                    m_VMStack.Push();
+        VM_CASE(OP_UN_TARGETNAME):
+            // retrieve the target name
+            if (world) {
+                if (m_VMStack.GetTop().GetType() == VARIABLE_CONSTSTRING) {
+                    targetList = world->GetExistingTargetList(m_VMStack.GetTop().constStringValue());
                 } else {
-                    m_VMStack.PushAndGet().Clear();
-                    ScriptError("self is NULL");
+                    targetList = world->GetExistingTargetList(m_VMStack.GetTop().stringValue());
                 }
+            } else {
+                // Added in OPM
+                //  don't use the target list if the world is NULL
+                targetList = NULL;
+            }
 
-                m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
-
-            case OP_STORE_PARM:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(&parm);
-                break;
-
-            case OP_STORE_SELF:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self);
-                break;
+            if (!targetList || !targetList->list.NumObjects()) {
+                // the target name was not found
 
-            case OP_STORE_NIL:
-                m_VMStack.Push();
-                m_VMStack.GetTop().Clear();
-                break;
-
-            case OP_STORE_NULL:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setListenerValue(NULL);
-                break;
+                if (g_scriptdebug->integer) {
+                    const str targetname = m_VMStack.GetTop().stringValue();
+                    m_VMStack.GetTop().setListenerValue(NULL);
+                    ScriptError("Targetname '%s' does not exist.", targetname.c_str());
+                } else {
+                    m_VMStack.GetTop().setListenerValue(NULL);
+                }
+            } else if (targetList->list.NumObjects() == 1) {
+                // single listener
+                m_VMStack.GetTop().setListenerValue(targetList->list.ObjectAt(1));
+            } else if (targetList->list.NumObjects() > 1) {
+                // multiple listeners
+                m_VMStack.GetTop().setContainerValue((Container<SafePtr<Listener>> *)&targetList->list);
+            }
+            VM_NEXT();
 
-            case OP_STORE_STRING:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setConstStringValue(fetchOpcodeValue<unsigned int>());
-                break;
+        VM_CASE(OP_VAR_UN_NOT):
+            m_VMStack.GetTop().setIntValue(m_VMStack.GetTop().booleanValue());
+            VM_NEXT();
 
-            case OP_STORE_VECTOR:
-                m_VMStack.Push();
-                m_VMStack.GetTop().setVectorValue(fetchOpcodeValue<Vector>());
-                break;
+        VM_CASE(OP_DONE):
+            End();
+            break;
 
-            case OP_SWITCH:
-                if (!Switch(fetchActualOpcodeValue<StateScript *>(), m_VMStack.Pop())) {
-                    m_CodePos += sizeof(StateScript *);
-                }
-                break;
+        VM_CASE(OP_NOP):
+            VM_NEXT();
 
-            case OP_UN_CAST_BOOLEAN:
-                m_VMStack.GetTop().CastBoolean();
-                break;
+        VM_DEFAULT:
+            assert(!"Invalid opcode");
+            if (*opcode < OP_MAX) {
+                gi.DPrintf("unknown opcode %d ('%s')\n", *opcode, OpcodeName(*opcode));
+            } else {
+                gi.DPrintf("unknown opcode %d\n", *opcode);
+            }
+            break;
+        }
 
-            case OP_UN_COMPLEMENT:
-                m_VMStack.GetTop().complement();
-                break;
+        Director.cmdCount++;
 
-            case OP_UN_MINUS:
-                m_VMStack.GetTop().minus();
-                break;
+        if (Director.cmdCount >= SCRIPTVM_MAX_CMD_COUNT) {
+            if (!Director.cmdTime) {
+                Director.cmdTime  = gi.Milliseconds();
+                Director.cmdCount = 0;
+                continue;
+            }
 
-            case OP_UN_DEC:
-                m_VMStack.GetTop()--;
-                break;
+            if (gi.Milliseconds() - Director.cmdTime < Director.maxTime) {
+                Director.cmdCount = 0;
+                continue;
+            }
 
-            case OP_UN_INC:
-                m_VMStack.GetTop()++;
-                break;
+            // The maximum execution time was reached
+            if (level.m_LoopProtection) {
+                Director.cmdTime = gi.Milliseconds();
 
-            case OP_UN_SIZE:
-                m_VMStack.GetTop().setIntValue((int)m_VMStack.GetTop().size());
-                break;
+                GetScript()->PrintSourcePos(m_CodePos, true);
+                gi.DPrintf2("\n");
 
-            case OP_UN_TARGETNAME:
-                // retrieve the target name
-                if (world) {
-                    targetList = world->GetExistingTargetList(m_VMStack.GetTop().stringValue());
-                } else {
-                    // Added in OPM
-                    //  don't use the target list if the world is NULL
-                    targetList = NULL;
-                }
+                state = STATE_EXECUTION;
 
-                if (!targetList || !targetList->list.NumObjects()) {
-                    // the target name was not found
-
-                    if (g_scriptdebug->integer) {
-                        const str targetname = m_VMStack.GetTop().stringValue();
-                        m_VMStack.GetTop().setListenerValue(NULL);
-                        ScriptError("Targetname '%s' does not exist.", targetname.c_str());
-                    } else {
-                        m_VMStack.GetTop().setListenerValue(NULL);
-                    }
-                } else if (targetList->list.NumObjects() == 1) {
-                    // single listener
-                    m_VMStack.GetTop().setListenerValue(targetList->list.ObjectAt(1));
-                } else if (targetList->list.NumObjects() > 1) {
-                    // multiple listeners
-                    m_VMStack.GetTop().setContainerValue((Container<SafePtr<Listener>> *)&targetList->list);
+                if (level.m_LoopDrop) {
+                    ScriptException::next_abort = -1;
                 }
-                break;
-
-            case OP_VAR_UN_NOT:
-                m_VMStack.GetTop().setIntValue(m_VMStack.GetTop().booleanValue());
-                break;
 
-            case OP_DONE:
-                End();
+                ScriptError("Command overflow. Possible infinite loop in thread.\n");
                 break;
+            }
 
-            case OP_NOP:
-                break;
+            VM_DPrintf("Update of script position - This is not an error.\n");
+            VM_DPrintf("=================================================\n");
+            m_ScriptClass->GetScript()->PrintSourcePos(opcode, true);
+            VM_DPrintf("=================================================\n");
 
-            default:
-                assert(!"Invalid opcode");
-                if (*opcode < OP_MAX) {
-                    gi.DPrintf("unknown opcode %d ('%s')\n", *opcode, OpcodeName(*opcode));
-                } else {
-                    gi.DPrintf("unknown opcode %d\n", *opcode);
-                }
-                break;
-            }
+            Director.cmdCount = 0;
+        }
+    }
+}
 
-            Director.cmdCount++;
+/*
+====================
+Execute
 
-            if (Director.cmdCount >= 15000) {
-                if (!Director.cmdTime) {
-                    Director.cmdTime  = gi.Milliseconds();
-                    Director.cmdCount = 0;
-                    continue;
-                }
+Executes a program
+====================
+*/
+void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
+{
+    if (Director.stackCount >= MAX_STACK_DEPTH) {
+        state = STATE_EXECUTION;
 
-                if (gi.Milliseconds() - Director.cmdTime < Director.maxTime) {
-                    Director.cmdCount = 0;
-                    continue;
-                }
+        ScriptException::next_abort = -1;
+        throw ScriptException("stack overflow");
+    }
 
-                // The maximum execution time was reached
-                if (level.m_LoopProtection) {
-                    Director.cmdTime = gi.Milliseconds();
+    if (label.length()) {
+        // Throw if label is not found
+        m_CodePos = m_ScriptClass->FindLabel(label);
+        if (!m_CodePos) {
+            ScriptError("ScriptVM::Execute: label '%s' does not exist in '%s'.", label.c_str(), Filename().c_str());
+        }
+    }
 
-                    GetScript()->PrintSourcePos(m_CodePos, true);
-                    gi.DPrintf2("\n");
+    if (g_scripttrace->integer && CanScriptTracePrint()) {
+        gi.DPrintf2(
+            "+++FRAME: %i (%p) +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n",
+            Director.stackCount,
+            this
+        );
+    }
 
-                    state = STATE_EXECUTION;
+    Director.stackCount++;
 
-                    if (level.m_LoopDrop) {
-                        ScriptException::next_abort = -1;
-                    }
+    if (g_scriptprofile->integer > 0) {
+        ScriptProfile.EnterVM(this, Director.stackCount);
+    }
 
-                    ScriptError("Command overflow. Possible infinite loop in thread.\n");
-                    break;
-                }
+    if (dataSize) {
+        SetFastData(data, dataSize);
+    }
 
-                VM_DPrintf("Update of script position - This is not an error.\n");
-                VM_DPrintf("=================================================\n");
-                m_ScriptClass->GetScript()->PrintSourcePos(opcode, true);
-                VM_DPrintf("=================================================\n");
+    state = STATE_RUNNING;
 
-                Director.cmdCount = 0;
+    while (state == STATE_RUNNING) {
+        try {
+            // Tracing and profiling are only checked in the traced variant, to keep them out of the main loop
+            if (g_scripttrace->integer || g_scriptprofile->integer > 0) {
+                ExecuteLoop<true>();
+            } else {
+                ExecuteLoop<false>();
             }
         } catch (ScriptException& exc) {
             HandleScriptException(exc);
         }
     }
 
+    // Always called, the profiler may have been turned off while running
+    ScriptProfile.LeaveVM(this);
+
     Director.stackCount--;
 
     if (g_scripttrace->integer && CanScriptTracePrint()) {
@@ -1967,7 +2435,8 @@ void ScriptVM::SetFastData(ScriptVariable *data, int dataSize)
     }
 
     if (dataSize) {
-        fastEvent.data     = new ScriptVariable[dataSize];
+        // the values come from the argument pool of the events
+        fastEvent          = Event(0, dataSize);
         fastEvent.dataSize = dataSize;
 
         for (int i = 0; i < dataSize; i++) {
@@ -169,13 +169,18 @@ public:
 
 private:
     void error(const char *format, ...);
+    void raiseError(const char *format, ...);
 
     template<bool bMethod = false, bool bReturn = false>
     void executeCommand(Listener *listener, op_parmNum_t iParamCount, op_evName_t eventnum);
     template<bool bReturn>
     void executeCommandInternal(Event& ev, Listener *listener, ScriptVariable *fromVar, op_parmNum_t iParamCount);
-    bool executeGetter(Listener *listener, op_evName_t eventName);
-    bool executeSetter(Listener *listener, op_evName_t eventName);
+    template<bool bReturn>
+    void executeMethod(Listener *listener, op_parmNum_t iParamCount, op_ev_t eventnum, op_cacheIndex_t cacheIndex);
+    bool executeGetter(Listener *listener, op_evName_t eventName, op_cacheIndex_t cacheIndex);
+    bool executeSetter(Listener *listener, op_evName_t eventName, op_cacheIndex_t cacheIndex);
+    ScriptInlineCacheEntry *fetchFieldCache(Listener *listener, op_name_t eventName, op_cacheIndex_t cacheIndex);
+    ScriptInlineCacheEntry *fetchMethodCache(Listener *listener, op_ev_t eventnum, op_cacheIndex_t cacheIndex);
     void transferVarsToEvent(Event& ev, ScriptVariable *fromVar, op_parmNum_t count);
     void checkValidEvent(Event& ev, Listener *listener);
 
@@ -195,6 +200,9 @@ private:
     unsigned char *ProgBuffer();
     void           HandleScriptException(ScriptException& exc);
 
+    template<bool bTrace>
+    void ExecuteLoop();
+
 public:
     void *operator new(size_t size);
     void  operator delete(void *ptr);
@@ -240,6 +248,9 @@ private:
     bool jumpVar(unsigned int offset, bool booleanValue);
     void doJumpIf(bool booleanValue);
     bool doJumpVarIf(bool booleanValue);
+    void doCompareJumpFalse();
+    void doLocalCompareJumpFalse();
+    void compareJumpFalse(ScriptVariable& b, ScriptVariable& a);
 
     void fetchOpcodeValue(void *outValue, size_t size);
     void fetchActualOpcodeValue(void *outValue, size_t size);
@@ -270,6 +281,7 @@ private:
 
     void execCmdCommon(op_parmNum_t param);
     void execCmdMethodCommon(op_parmNum_t param);
+    void execCmdSelfMethod(op_parmNum_t param);
     void execMethodCommon(op_parmNum_t param);
     void execFunction(ScriptMaster& Director);
 };
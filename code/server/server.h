@@ -66,7 +66,6 @@ typedef struct svEntity_s {
 	int			clusternums[MAX_ENT_CLUSTERS];
 	int			lastCluster;		// if all the clusters don't fit in clusternums
 	int			areanum, areanum2;
-	int			snapshotCounter;	// used to prevent double adding from portal views
 } svEntity_t;
 
 typedef enum {
@@ -85,7 +84,6 @@ typedef struct {
 	// https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=475
 	// the serverId associated with the current checksumFeed (always <= serverId)
 	int       checksumFeedServerId;	
-	int				snapshotCounter;	// incremented for each snapshot built
 	int				timeResidual;		// <= 1000 / sv_frame->value
 	int				nextFrameTime;		// when time > nextFrameTime, process world
 	float			frameTime;
@@ -357,6 +355,7 @@ extern	cvar_t	*sv_master[MAX_MASTER_SERVERS];
 extern	cvar_t	*sv_reconnectlimit;
 extern	cvar_t	*sv_showloss;
 extern	cvar_t	*sv_padPackets;
+extern	cvar_t	*sv_snapshotThreads;
 extern	cvar_t	*sv_killserver;
 extern	cvar_t	*sv_mapname;
 extern	cvar_t	*sv_mapChecksum;
@@ -378,6 +377,7 @@ extern	cvar_t	*sv_netprofile;
 extern	cvar_t	*sv_netprofileoverlay;
 extern	cvar_t	*sv_netoptimize;
 extern	cvar_t	*sv_netoptimize_vistime;
+extern	cvar_t	*sv_netoptimize_visdist;
 extern	cvar_t	*g_netoptimize;
 extern	cvar_t	*sv_chatter;
 extern	cvar_t	*sv_gamename;
@@ -545,6 +545,7 @@ void SV_SendMessageToClient( msg_t *msg, client_t *client );
 void SV_SendClientMessages( void );
 void SV_SendClientSnapshot( client_t *client );
 qboolean SV_IsValidSnapshotClient(client_t* client);
+void SV_FreeSnapshotEntities(void);
 
 //
 // sv_game.c
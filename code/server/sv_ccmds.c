@@ -1731,6 +1731,7 @@ void SV_NetProfileDump_f(void)
 	int i;
 	char buffer[2048];
 	netprofclient_t netproftotal;
+	int deltaLookups, deltaHits;
 
 	if (!hFile) {
 		hFile = FS_FOpenTextFileWrite_HomeData("netprofile.log");
@@ -1787,6 +1788,20 @@ void SV_NetProfileDump_f(void)
 			FS_Write(buffer, strlen(buffer), hFile);
 			SV_NetProfileDump_PrintProf(hFile, &client->netprofile);
 		}
+
+		// Added in OPM
+		//  Shared entity delta hits since the last dump
+		MSG_GetDeltaCacheStats(&deltaLookups, &deltaHits);
+		MSG_ResetDeltaCacheStats();
+		Com_sprintf(
+			buffer,
+			sizeof(buffer),
+			"Delta cache:  %i/%i hits (%.1f%%)\n",
+			deltaHits,
+			deltaLookups,
+			deltaLookups ? deltaHits * 100.f / deltaLookups : 0.f
+		);
+		FS_Write(buffer, strlen(buffer), hFile);
 	}
 #ifndef DEDICATED
 	else if (com_cl_running->integer && cl_netprofile->integer) {
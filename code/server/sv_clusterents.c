@@ -0,0 +1,227 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// sv_clusterents.c -- linked entities bucketed by PVS cluster
+//
+// The clusters of each entity are stored by SV_LinkEntity. Once per frame
+// they are sorted by cluster, so a client only has to go through the entities
+// that are in the clusters it can see, instead of testing every entity.
+
+#include "sv_clusterents.h"
+#include "../qcommon/qcommon.h"
+
+/*
+===============
+SV_ClearClusterEntities
+
+Removes all entities, for a map with the specified number of clusters
+===============
+*/
+void SV_ClearClusterEntities( clusterEntities_t *ce, int numClusters ) {
+	if ( numClusters > ce->maxClusters ) {
+		if ( ce->firstRef ) {
+			Z_Free( ce->firstRef );
+		}
+		ce->firstRef = Z_Malloc( ( numClusters + 1 ) * sizeof( *ce->firstRef ) );
+		ce->maxClusters = numClusters;
+	}
+
+	ce->numClusters = numClusters;
+	ce->numRefs = 0;
+	Com_Memset( ce->alwaysBits, 0, sizeof( ce->alwaysBits ) );
+}
+
+/*
+===============
+SV_FreeClusterEntities
+===============
+*/
+void SV_FreeClusterEntities( clusterEntities_t *ce ) {
+	if ( ce->firstRef ) {
+		Z_Free( ce->firstRef );
+	}
+
+	ce->firstRef = NULL;
+	ce->maxClusters = 0;
+	ce->numClusters = 0;
+	ce->numRefs = 0;
+}
+
+/*
+===============
+SV_AddClusterEntity
+
+Adds an entity to each of its clusters, clusters can be repeated
+===============
+*/
+void SV_AddClusterEntity( clusterEntities_t *ce, int entnum, const int *clusters, int numClusters ) {
+	int i;
+
+	for ( i = 0 ; i < numClusters ; i++ ) {
+		if ( clusters[i] < 0 || clusters[i] >= ce->numClusters ) {
+			continue;
+		}
+
+		if ( ce->numRefs == MAX_CLUSTER_ENTITY_REFS ) {
+			// can't happen with MAX_ENT_CLUSTERS clusters per entity,
+			// but it would still be checked by everyone
+			SV_AddAlwaysCheckedEntity( ce, entnum );
+			return;
+		}
+
+		ce->refClusters[ce->numRefs] = clusters[i];
+		ce->refEntities[ce->numRefs] = entnum;
+		ce->numRefs++;
+	}
+}
+
+/*
+===============
+SV_AddAlwaysCheckedEntity
+
+Adds an entity that is returned for any PVS
+===============
+*/
+void SV_AddAlwaysCheckedEntity( clusterEntities_t *ce, int entnum ) {
+	ce->alwaysBits[entnum >> 5] |= 1u << ( entnum & 31 );
+}
+
+/*
+===============
+SV_SortClusterEntities
+
+Groups the added entities by cluster, must be called before gathering
+===============
+*/
+void SV_SortClusterEntities( clusterEntities_t *ce ) {
+	int i;
+	int cluster;
+	int total, count;
+
+	if ( !ce->firstRef ) {
+		return;
+	}
+
+	Com_Memset( ce->firstRef, 0, ( ce->numClusters + 1 ) * sizeof( *ce->firstRef ) );
+
+	for ( i = 0 ; i < ce->numRefs ; i++ ) {
+		ce->firstRef[ce->refClusters[i]]++;
+	}
+
+	// turn counts into offsets, firstRef[cluster] is the end of the
+	// previous cluster until the entities are placed
+	total = 0;
+	for ( i = 0 ; i < ce->numClusters ; i++ ) {
+		count = ce->firstRef[i];
+		ce->firstRef[i] = total;
+		total += count;
+	}
+	ce->firstRef[ce->numClusters] = total;
+
+	for ( i = 0 ; i < ce->numRefs ; i++ ) {
+		cluster = ce->refClusters[i];
+		ce->entityNums[ce->firstRef[cluster]++] = ce->refEntities[i];
+	}
+
+	// each offset now points to the start of the next cluster
+	for ( i = ce->numClusters ; i > 0 ; i-- ) {
+		ce->firstRef[i] = ce->firstRef[i - 1];
+	}
+	ce->firstRef[0] = 0;
+}
+
+/*
+===============
+SV_GatherClusterEntities
+
+Sets the bit of each entity that is in a cluster of the PVS,
+and the bit of entities that are always checked
+===============
+*/
+void SV_GatherClusterEntities( const clusterEntities_t *ce, const byte *pvs, unsigned int *bits ) {
+	int		i, j;
+	int		cluster;
+	int		entnum;
+	int		numBytes;
+
+	Com_Memcpy( bits, ce->alwaysBits, sizeof( ce->alwaysBits ) );
+
+	if ( !ce->firstRef ) {
+		return;
+	}
+
+	numBytes = ( ce->numClusters + 7 ) >> 3;
+	for ( i = 0 ; i < numBytes ; i++ ) {
+		if ( !pvs[i] ) {
+			continue;
+		}
+
+		for ( cluster = i << 3 ; cluster < ( i << 3 ) + 8 && cluster < ce->numClusters ; cluster++ ) {
+			if ( !( pvs[i] & ( 1 << ( cluster & 7 ) ) ) ) {
+				continue;
+			}
+
+			for ( j = ce->firstRef[cluster] ; j < ce->firstRef[cluster + 1] ; j++ ) {
+				entnum = ce->entityNums[j];
+				bits[entnum >> 5] |= 1u << ( entnum & 31 );
+			}
+		}
+	}
+}
+
+/*
+===============
+SV_NextClusterEntity
+
+Returns the next entity number after entnum that has its bit set, or -1
+===============
+*/
+int SV_NextClusterEntity( const unsigned int *bits, int entnum ) {
+	unsigned int word;
+	int index;
+
+	entnum++;
+	if ( entnum >= MAX_GENTITIES ) {
+		return -1;
+	}
+
+	index = entnum >> 5;
+	word = bits[index] >> ( entnum & 31 );
+
+	for ( ;; ) {
+		if ( word ) {
+			while ( !( word & 1 ) ) {
+				word >>= 1;
+				entnum++;
+			}
+			return entnum;
+		}
+
+		index++;
+		if ( index == CLUSTER_ENTITY_WORDS ) {
+			return -1;
+		}
+
+		word = bits[index];
+		entnum = index << 5;
+	}
+}
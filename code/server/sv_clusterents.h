@@ -0,0 +1,62 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// sv_clusterents.h -- linked entities bucketed by PVS cluster
+
+#pragma once
+
+#include "../qcommon/q_shared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// an entity can be stored in up to MAX_ENT_CLUSTERS clusters
+#define MAX_CLUSTER_ENTITY_REFS		(MAX_GENTITIES * 16)
+#define CLUSTER_ENTITY_WORDS		(MAX_GENTITIES / 32)
+
+typedef struct {
+	int				numClusters;
+	int				maxClusters;
+	// numClusters + 1 offsets in entityNums, one range per cluster
+	int				*firstRef;
+
+	int				numRefs;
+	int				refClusters[MAX_CLUSTER_ENTITY_REFS];
+	unsigned short	refEntities[MAX_CLUSTER_ENTITY_REFS];
+	unsigned short	entityNums[MAX_CLUSTER_ENTITY_REFS];
+
+	// entities that must be checked no matter which clusters are visible
+	unsigned int	alwaysBits[CLUSTER_ENTITY_WORDS];
+} clusterEntities_t;
+
+void	SV_ClearClusterEntities( clusterEntities_t *ce, int numClusters );
+void	SV_FreeClusterEntities( clusterEntities_t *ce );
+void	SV_AddClusterEntity( clusterEntities_t *ce, int entnum, const int *clusters, int numClusters );
+void	SV_AddAlwaysCheckedEntity( clusterEntities_t *ce, int entnum );
+void	SV_SortClusterEntities( clusterEntities_t *ce );
+void	SV_GatherClusterEntities( const clusterEntities_t *ce, const byte *pvs, unsigned int *bits );
+int		SV_NextClusterEntity( const unsigned int *bits, int entnum );
+
+#ifdef __cplusplus
+}
+#endif
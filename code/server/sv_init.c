@@ -1108,6 +1108,9 @@ void SV_Init (void)
 	sv_reconnectlimit = Cvar_Get ("sv_reconnectlimit", "3", 0);
 	sv_showloss = Cvar_Get ("sv_showloss", "0", 0);
 	sv_padPackets = Cvar_Get ("sv_padPackets", "0", 0);
+	// Added in OPM
+	//  Build and write snapshots from multiple threads, 0 or 1 does everything on the main thread
+	sv_snapshotThreads = Cvar_Get ("sv_snapshotThreads", "0", CVAR_ARCHIVE);
 	sv_killserver = Cvar_Get ("sv_killserver", "0", 0);
 	sv_mapChecksum = Cvar_Get ("sv_mapChecksum", "", CVAR_ROM | CVAR_SERVERINFO);
 	sv_drawentities = Cvar_Get( "sv_drawentities", "1", 0 );
@@ -1116,6 +1119,9 @@ void SV_Init (void)
     sv_netprofileoverlay = Cvar_Get("sv_netprofileoverlay", "0", 0);
     sv_netoptimize = Cvar_Get("sv_netoptimize", "0", 0);
 	sv_netoptimize_vistime = Cvar_Get("sv_netoptimize_vistime", "200", 0);
+	// Added in OPM
+	//  Clients that are not visible are not traced again until one of them moves by this distance, 0 to always trace
+	sv_netoptimize_visdist = Cvar_Get("sv_netoptimize_visdist", "16", 0);
     g_netoptimize = Cvar_Get("g_netoptimize", "1", 0);
 	sv_chatter = Cvar_Get( "sv_chatter", "0", 0 );
 	sv_lanForceRate = Cvar_Get ("sv_lanForceRate", "1", CVAR_ARCHIVE );
@@ -1211,6 +1217,7 @@ void SV_Shutdown( const char *finalmsg ) {
 
 	// free current level
 	SV_ClearServer();
+	SV_FreeSnapshotEntities();
 
 	// free server static data
 	if(svs.clients)
@@ -48,6 +48,7 @@ cvar_t	*sv_master[ MAX_MASTER_SERVERS ];		// master server ip address
 cvar_t	*sv_reconnectlimit;		// minimum seconds between connect messages
 cvar_t	*sv_showloss;			// report when usercmds are lost
 cvar_t	*sv_padPackets;			// add nop bytes to messages
+cvar_t	*sv_snapshotThreads;	// threads used to build and write snapshots
 cvar_t	*sv_killserver;			// menu system can set to 1 to shut server down
 cvar_t	*sv_mapname;
 cvar_t	*sv_mapChecksum;
@@ -66,6 +67,7 @@ cvar_t	*sv_netprofile;
 cvar_t	*sv_netprofileoverlay;
 cvar_t	*sv_netoptimize;
 cvar_t	*sv_netoptimize_vistime;
+cvar_t	*sv_netoptimize_visdist;
 cvar_t	*g_netoptimize;
 cvar_t	*g_gametype;
 cvar_t	*g_gametypestring;
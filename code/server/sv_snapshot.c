@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "server.h"
+#include "sv_clusterents.h"
 #include "../qcommon/bg_compat.h"
 
 #define	CULL_IN		0		// completely unclipped
@@ -92,7 +93,7 @@ static void SV_EmitPacketEntities( clientSnapshot_t *from, clientSnapshot_t *to,
 			// delta update from old position
 			// because the force parm is qfalse, this will not result
 			// in any bytes being emitted if the entity has not changed at all
-			MSG_WriteDeltaEntity (msg, oldent, newent, qfalse, sv.frameTime);
+			MSG_WriteDeltaEntityCached (msg, oldent, newent, qfalse, sv.frameTime);
 			oldindex++;
 			newindex++;
 			continue;
@@ -100,7 +101,7 @@ static void SV_EmitPacketEntities( clientSnapshot_t *from, clientSnapshot_t *to,
 
 		if ( newnum < oldnum ) {
 			// this is a new entity, send it from the baseline
-			MSG_WriteDeltaEntity (msg, &sv.svEntities[newnum].baseline, newent, qtrue, sv.frameTime);
+			MSG_WriteDeltaEntityCached (msg, &sv.svEntities[newnum].baseline, newent, qtrue, sv.frameTime);
 			newindex++;
 			continue;
 		}
@@ -120,42 +121,57 @@ static void SV_EmitPacketEntities( clientSnapshot_t *from, clientSnapshot_t *to,
 
 /*
 ==================
-SV_WriteSnapshotToClient
+SV_SelectDeltaFrame
+
+Chooses the previous frame used as the source for delta compressing the snapshot.
+Must be called right after the snapshot entities were allocated
 ==================
 */
-static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg ) {
-	clientSnapshot_t	*frame, *oldframe;
-	int					lastframe;
-	int					i;
-	int					snapFlags;
-
-	// this is the snapshot we are creating
-	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+static clientSnapshot_t *SV_SelectDeltaFrame( client_t *client, int *lastframe ) {
+	clientSnapshot_t	*oldframe;
 
 	// try to use a previous frame as the source for delta compressing the snapshot
 	if ( client->deltaMessage <= 0 || client->state != CS_ACTIVE ) {
 		// client is asking for a retransmit
 		oldframe = NULL;
-		lastframe = 0;
+		*lastframe = 0;
 	} else if ( client->netchan.outgoingSequence - client->deltaMessage 
 		>= (PACKET_BACKUP - 3) ) {
 		// client hasn't gotten a good message through in a long time
 		Com_DPrintf ("%s: Delta request from out of date packet.\n", client->name);
 		oldframe = NULL;
-		lastframe = 0;
+		*lastframe = 0;
 	} else {
 		// we have a valid snapshot to delta from
 		oldframe = &client->frames[ client->deltaMessage & PACKET_MASK ];
-		lastframe = client->netchan.outgoingSequence - client->deltaMessage;
+		*lastframe = client->netchan.outgoingSequence - client->deltaMessage;
 
 		// the snapshot's entities may still have rolled off the buffer, though
 		if ( oldframe->first_entity <= svs.nextSnapshotEntities - svs.numSnapshotEntities ) {
 			Com_DPrintf ("%s: Delta request from out of date entities.\n", client->name);
 			oldframe = NULL;
-			lastframe = 0;
+			*lastframe = 0;
 		}
 	}
 
+	return oldframe;
+}
+
+/*
+==================
+SV_WriteSnapshotToClient
+
+Doesn't print or change the server state, so it can run from jobs
+==================
+*/
+static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg, clientSnapshot_t *oldframe, int lastframe ) {
+	clientSnapshot_t	*frame;
+	int					i;
+	int					snapFlags;
+
+	// this is the snapshot we are creating
+	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+
 	MSG_WriteSVC(msg, svc_snapshot);
 
 	// NOTE, MRE: now sent at the start of every message from server to client
@@ -197,7 +213,7 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg ) {
 
 	// send over the areabits
 	if ( frame->areabytes > 255 ) {
-		Com_DPrintf( "WARNING: area bytes exceeds 255!  Bad!  Bad!" ); // 2015 actually had humour
+		// the warning is printed when committing the snapshot
 		MSG_WriteByte( msg, 0 );
 	} else {
 		MSG_WriteByte (msg, frame->areabytes);
@@ -278,8 +294,43 @@ Build a client snapshot structure
 typedef struct {
 	int		numSnapshotEntities;
 	int		snapshotEntities[MAX_SNAPSHOT_ENTITIES];	
+
+	// Added in OPM
+	//  Everything a snapshot changes is kept here until it's committed,
+	//  so snapshots can be built from jobs.
+
+	// entities already added, to prevent double adding from portal views
+	byte	addedEntities[MAX_GENTITIES / 8];
+	// renderfx of the entities as sent in this snapshot
+	byte	renderfxEntities[MAX_GENTITIES / 8];
+	int		numRenderfx;
+	int		renderfxNumbers[MAX_GENTITIES];
+	int		renderfx[MAX_GENTITIES];
+
+	qboolean	built;
+	int			errorCode;
+	char		errorMessage[MAX_STRING_CHARS];
 } snapshotEntityNumbers_t;
 
+typedef struct {
+	client_t				*client;
+	snapshotEntityNumbers_t	entityNumbers;
+	// bots only need their snapshot to be built
+	qboolean				send;
+	// whether the client can receive the snapshot, otherwise it gets a svc_nop
+	qboolean				writeSnapshot;
+	clientSnapshot_t		*oldframe;
+	int						lastframe;
+	msg_t					msg;
+	byte					msgBuffer[MAX_MSGLEN];
+} snapshotJob_t;
+
+static snapshotJob_t svSnapshotJobs[MAX_CLIENTS];
+
+// Added in OPM
+//  entities that can be sent, by cluster, rebuilt before sending snapshots
+static clusterEntities_t svClusterEntities;
+
 /*
 =======================
 SV_QsortEntityNumbers
@@ -291,15 +342,70 @@ static int QDECL SV_QsortEntityNumbers( const void *a, const void *b ) {
 	ea = (int *)a;
 	eb = (int *)b;
 
-	if ( *ea == *eb ) {
-		Com_Error( ERR_DROP, "SV_QsortEntityStates: duplicated entity" );
-	}
-
+	// duplicates are checked after sorting
 	if ( *ea < *eb ) {
 		return -1;
+	} else if ( *ea > *eb ) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+=======================
+SV_SnapshotError
+
+Errors can't be thrown from jobs, they are thrown when committing the snapshot
+=======================
+*/
+static void SV_SnapshotError( snapshotEntityNumbers_t *eNums, int code, const char *message ) {
+	if ( eNums->errorCode ) {
+		return;
 	}
 
-	return 1;
+	eNums->errorCode = code;
+	Q_strncpyz( eNums->errorMessage, message, sizeof( eNums->errorMessage ) );
+}
+
+/*
+=======================
+SV_IsEntityInSnapshot
+=======================
+*/
+static qboolean SV_IsEntityInSnapshot( const snapshotEntityNumbers_t *eNums, int num ) {
+	return ( eNums->addedEntities[num >> 3] & ( 1 << ( num & 7 ) ) ) != 0;
+}
+
+/*
+=======================
+SV_GetSnapshotRenderfx
+=======================
+*/
+static int SV_GetSnapshotRenderfx( const snapshotEntityNumbers_t *eNums, const gentity_t *ent ) {
+	int num = ent->s.number;
+
+	if ( eNums->renderfxEntities[num >> 3] & ( 1 << ( num & 7 ) ) ) {
+		return eNums->renderfx[num];
+	}
+
+	return ent->s.renderfx;
+}
+
+/*
+=======================
+SV_SetSnapshotRenderfx
+=======================
+*/
+static void SV_SetSnapshotRenderfx( snapshotEntityNumbers_t *eNums, const gentity_t *ent, int renderfx ) {
+	int num = ent->s.number;
+
+	if ( !( eNums->renderfxEntities[num >> 3] & ( 1 << ( num & 7 ) ) ) ) {
+		eNums->renderfxEntities[num >> 3] |= 1 << ( num & 7 );
+		eNums->renderfxNumbers[eNums->numRenderfx++] = num;
+	}
+
+	eNums->renderfx[num] = renderfx;
 }
 
 /*
@@ -402,30 +508,148 @@ qboolean SV_WorldTrace(const vec3_t start, const vec3_t end, int mask)
 	return SV_ClipMoveToBSPEntities(start, end, mask);
 }
 
+// Added in OPM
+//  Eye to eye traces between two clients, shared by both directions
+#define CLIENTLOS_EYES_TESTED			1
+#define CLIENTLOS_EYES_VISIBLE			2
+#define CLIENTLOS_PREDICTED_TESTED		4
+#define CLIENTLOS_PREDICTED_VISIBLE		8
+
+typedef struct {
+	int		frame;
+	int		flags;
+} clientLos_t;
+
+// Added in OPM
+//  Clients that were not visible, kept until one of them moves
+typedef struct {
+	int			hiddenUntil;
+	qboolean	facing;
+	vec3_t		fromOrigin;
+	vec3_t		toOrigin;
+} clientHidden_t;
+
+// indexed by the lowest client number first, reset by bumping the frame
+static clientLos_t		svClientLos[MAX_CLIENTS][MAX_CLIENTS];
+static int				svClientLosFrame;
+// indexed by viewer then target, only changed by the viewer's snapshot
+static clientHidden_t	svClientHidden[MAX_CLIENTS][MAX_CLIENTS];
+
 /*
 ===============
-SV_ClientIsVisibleTrace
+SV_ClientLineOfSight
+
+Traces between two clients once per frame,
+always from the lowest client number so both directions get the same result.
+Must be called with the job lock
 ===============
 */
-qboolean SV_ClientIsVisibleTrace(const vec3_t fromOrigin, const vec3_t toOrigin, float height, float dot) {
-	vec3_t dir;
+static qboolean SV_ClientLineOfSight(int fromNum, int toNum, const vec3_t fromOrigin, const vec3_t toOrigin, qboolean predicted) {
+	clientLos_t *los;
+	int tested, visible;
+
+	if (predicted) {
+		tested = CLIENTLOS_PREDICTED_TESTED;
+		visible = CLIENTLOS_PREDICTED_VISIBLE;
+	} else {
+		tested = CLIENTLOS_EYES_TESTED;
+		visible = CLIENTLOS_EYES_VISIBLE;
+	}
+
+	if (fromNum < toNum) {
+		los = &svClientLos[fromNum][toNum];
+	} else {
+		los = &svClientLos[toNum][fromNum];
+	}
+
+	if (los->frame != svClientLosFrame) {
+		los->frame = svClientLosFrame;
+		los->flags = 0;
+	}
+
+	if (!(los->flags & tested)) {
+		los->flags |= tested;
+
+		if (fromNum < toNum) {
+			if (SV_WorldTrace(fromOrigin, toOrigin, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID))) {
+				los->flags |= visible;
+			}
+		} else {
+			if (SV_WorldTrace(toOrigin, fromOrigin, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID))) {
+				los->flags |= visible;
+			}
+		}
+	}
+
+	return (los->flags & visible) ? qtrue : qfalse;
+}
+
+/*
+===============
+SV_ClientIsVisibleSharedTrace
+
+Traces from the eyes to the eyes of the target, then to its lowered origin if the target is in front.
+The eye to eye trace is shared between both clients
+===============
+*/
+static qboolean SV_ClientIsVisibleSharedTrace(int fromNum, int toNum, const vec3_t fromOrigin, const vec3_t toOrigin, float height, float dot, qboolean predicted) {
 	vec3_t end;
+	qboolean visible;
 
-	VectorSubtract(toOrigin, fromOrigin, dir);
-    VectorNormalize(dir);
-    //VectorMA(toOrigin, -height, dir, end);
-	VectorCopy(toOrigin, end);
+	// the collision model isn't thread-safe
+	Com_JobLock();
 
-	if (SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID))) {
-		return qtrue;
+	visible = SV_ClientLineOfSight(fromNum, toNum, fromOrigin, toOrigin, predicted);
+	if (!visible && dot >= 0) {
+		VectorCopy(toOrigin, end);
+		end[2] -= height;
+		visible = SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID));
 	}
 
-	if (dot < 0) {
+	Com_JobUnlock();
+
+	return visible;
+}
+
+/*
+===============
+SV_IsClientStillHidden
+
+Returns true if the target was hidden recently and none of the clients moved since
+===============
+*/
+static qboolean SV_IsClientStillHidden(const clientHidden_t *hidden, const vec3_t fromOrigin, const vec3_t toOrigin, qboolean facing) {
+	float maxDist;
+
+	maxDist = sv_netoptimize_visdist->value;
+	if (maxDist <= 0 || hidden->hiddenUntil <= svs.time) {
 		return qfalse;
-    }
+	}
 
-	end[2] -= height;
-	return SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID));
+	if (hidden->hiddenUntil > svs.time + sv_netoptimize_vistime->integer) {
+		// from before the server time was reset
+		return qfalse;
+	}
+
+	if (facing && !hidden->facing) {
+		// the lower trace is only done when facing the target
+		return qfalse;
+	}
+
+	return Distance(hidden->fromOrigin, fromOrigin) <= maxDist
+		&& Distance(hidden->toOrigin, toOrigin) <= maxDist;
+}
+
+/*
+===============
+SV_SetClientHidden
+===============
+*/
+static void SV_SetClientHidden(clientHidden_t *hidden, const vec3_t fromOrigin, const vec3_t toOrigin, qboolean facing) {
+	hidden->hiddenUntil = svs.time + sv_netoptimize_vistime->integer;
+	hidden->facing = facing;
+	VectorCopy(fromOrigin, hidden->fromOrigin);
+	VectorCopy(toOrigin, hidden->toOrigin);
 }
 
 /*
@@ -435,12 +659,15 @@ SV_ClientIsVisible
 */
 qboolean SV_ClientIsVisible(int toNum, int fromNum, int distCheck, const vec3_t forward, const vec3_t right) {
 	client_t* fromClient;
+	clientHidden_t *hidden;
 	playerState_t *fromPs, *toPs;
 	vec3_t dir;
 	vec3_t fromOrigin, toOrigin;
+	vec3_t eyeFromOrigin, eyeToOrigin;
 	vec3_t toRight;
 	float dot;
 	float speed;
+	qboolean visible;
 	
 	if (!g_netoptimize->integer || !sv_netoptimize->integer) {
 		return qtrue;
@@ -487,13 +714,26 @@ qboolean SV_ClientIsVisible(int toNum, int fromNum, int distCheck, const vec3_t
 	VectorNormalize(dir);
 
 	dot = DotProduct(forward, dir);
-	if (SV_ClientIsVisibleTrace(fromOrigin, toOrigin, toPs->viewheight / 2, dot)) {
+
+	hidden = &svClientHidden[fromNum][toNum];
+	if (SV_IsClientStillHidden(hidden, fromOrigin, toOrigin, dot >= 0)) {
+		return qfalse;
+	}
+
+	VectorCopy(fromOrigin, eyeFromOrigin);
+	VectorCopy(toOrigin, eyeToOrigin);
+
+	visible = SV_ClientIsVisibleSharedTrace(fromNum, toNum, fromOrigin, toOrigin, toPs->viewheight / 2, dot, qfalse);
+
+	if (visible) {
 		fromClient->lastVisCheckTime[toNum] = svs.time + sv_netoptimize_vistime->integer;
+		hidden->hiddenUntil = 0;
 		return qtrue;
 	}
 
 	speed = VectorLength(toPs->velocity);
 	if (speed <= 0) {
+		SV_SetClientHidden(hidden, eyeFromOrigin, eyeToOrigin, dot >= 0);
 		return qfalse;
 	}
 
@@ -503,12 +743,16 @@ qboolean SV_ClientIsVisible(int toNum, int fromNum, int distCheck, const vec3_t
 	VectorMA(fromOrigin, sv.frameTime * 3, fromPs->velocity, fromOrigin);
 	VectorMA(toOrigin, sv.frameTime * 3, toPs->velocity, toOrigin);
 
-	if (SV_ClientIsVisibleTrace(fromOrigin, toOrigin, toPs->viewheight / 2, dot)) {
+	visible = SV_ClientIsVisibleSharedTrace(fromNum, toNum, fromOrigin, toOrigin, toPs->viewheight / 2, dot, qtrue);
+
+	if (visible) {
         fromClient->lastVisCheckTime[toNum] = svs.time + sv_netoptimize_vistime->integer;
+        hidden->hiddenUntil = 0;
         return qtrue;
 	}
 
 	// not visible
+	SV_SetClientHidden(hidden, eyeFromOrigin, eyeToOrigin, dot >= 0);
 	return qfalse;
 }
 
@@ -518,28 +762,34 @@ SV_AddEntToSnapshot
 ===============
 */
 static void SV_AddEntToSnapshot( svEntity_t *svEnt, gentity_t *gEnt, snapshotEntityNumbers_t *eNums, svEntity_t* portalEnt, qboolean portalsky) {
+	int num;
+	int renderfx;
+
 	// if we have already added this entity to this snapshot, don't add again
-	if ( svEnt->snapshotCounter == sv.snapshotCounter ) {
-		gEnt->s.renderfx &= ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES);
-		gEnt->s.renderfx |= RF_WRAP_FRAMES;
+	num = svEnt - sv.svEntities;
+	if ( SV_IsEntityInSnapshot( eNums, num ) ) {
+		renderfx = SV_GetSnapshotRenderfx( eNums, gEnt ) & ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES);
+		SV_SetSnapshotRenderfx( eNums, gEnt, renderfx | RF_WRAP_FRAMES );
 		return;
 	}
-	svEnt->snapshotCounter = sv.snapshotCounter;
+	eNums->addedEntities[num >> 3] |= 1 << ( num & 7 );
 
 	// if we are full, silently discard entities
 	if ( eNums->numSnapshotEntities == MAX_SNAPSHOT_ENTITIES ) {
 		return;
 	}
 
-	gEnt->s.renderfx &= ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES | RF_SKYENTITY);
+	renderfx = SV_GetSnapshotRenderfx( eNums, gEnt ) & ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES | RF_SKYENTITY);
 
 	if ( portalEnt ) {
-		gEnt->s.renderfx |= RF_SHADOW_PLANE;
+		renderfx |= RF_SHADOW_PLANE;
 	} else if ( portalsky ) {
-		gEnt->s.renderfx |= RF_SKYENTITY;
+		renderfx |= RF_SKYENTITY;
 	}
 
-	gEnt->r.lastNetTime = svs.time - svs.startTime;
+	SV_SetSnapshotRenderfx( eNums, gEnt, renderfx );
+
+	// lastNetTime is set when the snapshot is committed
 	eNums->snapshotEntities[ eNums->numSnapshotEntities ] = gEnt->s.number;
 	eNums->numSnapshotEntities++;
 }
@@ -587,6 +837,105 @@ int EntityDistCheck(const vec3_t origin, const vec3_t forward, const gentity_t*
 	return CULL_CLIP;
 }
 
+/*
+===============
+SV_IsEntityAlwaysChecked
+
+Returns true if the entity can be sent without one of its own clusters being visible
+===============
+*/
+static qboolean SV_IsEntityAlwaysChecked(const gentity_t* ent, const svEntity_t* svEnt) {
+	if (ent->s.parent != ENTITYNUM_NONE) {
+		// checked against the parent
+		return qtrue;
+	}
+
+	if (ent->s.renderfx & (RF_SKYORIGIN | RF_ALWAYSDRAW)) {
+		return qtrue;
+	}
+
+	if (ent->r.svFlags & (SVF_BROADCAST | SVF_SENDONCE)) {
+		return qtrue;
+	}
+
+	if (ent->s.loopSound && ent->s.loopSoundMinDist == LEVEL_WIDE_MIN_DIST) {
+		return qtrue;
+	}
+
+	if (svEnt->lastCluster) {
+		// clusters that couldn't be stored are checked by range
+		return qtrue;
+	}
+
+	return qfalse;
+}
+
+/*
+===============
+SV_BuildClusterEntities
+
+Buckets entities by the clusters SV_LinkEntity found for them.
+The flags of entities can change without them being relinked,
+so this is done before each batch of snapshots
+===============
+*/
+static void SV_BuildClusterEntities(void) {
+	gentity_t	*ent;
+	svEntity_t	*svEnt;
+	int			e;
+
+	SV_ClearClusterEntities(&svClusterEntities, CM_NumClusters());
+
+	for (e = 0; e < sv.num_entities; e++) {
+		ent = SV_GentityNum(e);
+
+		// same as the first checks of SV_AddEntitiesVisibleFromPoint
+		if (!ent->inuse || !ent->r.linked || (ent->r.svFlags & SVF_NOCLIENT)) {
+			continue;
+		}
+
+		svEnt = SV_SvEntityForGentity(ent);
+
+		if (SV_IsEntityAlwaysChecked(ent, svEnt)) {
+			SV_AddAlwaysCheckedEntity(&svClusterEntities, e);
+			continue;
+		}
+
+		if (!(ent->r.svFlags & SVF_SENDPVS) && !ent->s.modelindex && !ent->s.loopSound) {
+			// nothing to draw
+			continue;
+		}
+
+		SV_AddClusterEntity(&svClusterEntities, e, svEnt->clusternums, svEnt->numClusters);
+	}
+
+	SV_SortClusterEntities(&svClusterEntities);
+}
+
+/*
+===============
+SV_PrepareSnapshots
+
+Updates what is shared by the snapshots of all clients,
+must be called on the main thread before building snapshots
+===============
+*/
+static void SV_PrepareSnapshots(void) {
+	SV_BuildClusterEntities();
+
+	// traces between clients are done again
+	svClientLosFrame++;
+}
+
+/*
+=================
+SV_FreeSnapshotEntities
+=================
+*/
+void SV_FreeSnapshotEntities(void) {
+	SV_FreeClusterEntities(&svClusterEntities);
+}
+
 /*
 ===============
 SV_AddEntitiesVisibleFromPoint
@@ -604,6 +953,7 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 	int		c_fullsend;
 	byte	*clientpvs;
 	byte	*bitvector;
+	unsigned int candidates[CLUSTER_ENTITY_WORDS];
 	gentity_t* skyorigin = NULL;
 	int		num;
 	int		check = 0;
@@ -632,11 +982,16 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 
 	clientpvs = CM_ClusterPVS (clientcluster);
 
+	// Added in OPM
+	//  only go through entities that are in a visible cluster
+	//  or that can be sent without being in the PVS
+	SV_GatherClusterEntities(&svClusterEntities, clientpvs, candidates);
+
 	AngleVectors(angles, forward, right, NULL);
 
 	c_fullsend = 0;
 
-	for ( e = 0 ; e < sv.num_entities ; e++ ) {
+	for ( e = SV_NextClusterEntity(candidates, -1) ; e != -1 && e < sv.num_entities ; e = SV_NextClusterEntity(candidates, e) ) {
 		ent = SV_GentityNum(e);
 
 		// never send unused entities
@@ -644,8 +999,7 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 			continue;
 		}
 
-		// mark the entity as sent
-		ent->r.svFlags |= SVF_SENT;
+		// the entity was marked as sent by SV_MarkEntitiesSent
 
 		// never send entities that aren't linked in
 		if ( !ent->r.linked ) {
@@ -691,14 +1045,15 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 		svEnt = SV_SvEntityForGentity( ent );
 
 		// don't double add an entity through portals
-		if ( svEnt->snapshotCounter == sv.snapshotCounter ) {
+		if ( SV_IsEntityInSnapshot( eNums, svEnt - sv.svEntities ) ) {
 			continue;
 		}
 
 		if (ent->s.renderfx & RF_SKYORIGIN) {
 			if (sv.skyportal && !portalsky && !portalEnt) {
 				if (skyorigin) {
-					Com_Error(ERR_DROP, "SV_AddEntitiesVisibleFromPoint: duplicate sky origin");
+					SV_SnapshotError(eNums, ERR_DROP, "SV_AddEntitiesVisibleFromPoint: duplicate sky origin");
+					return;
 				}
 				skyorigin = ent;
 				SV_AddEntToSnapshot(svEnt, ent, eNums, NULL, qfalse);
@@ -715,7 +1070,7 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 
 		if (parentEnt) {
 			svEntity_t* parentSvEnt = SV_SvEntityForGentity(parentEnt);
-			if (parentSvEnt->snapshotCounter == sv.snapshotCounter) {
+			if (SV_IsEntityInSnapshot(eNums, parentSvEnt - sv.svEntities)) {
 				SV_AddEntToSnapshot(svEnt, ent, eNums, portalEnt, portalsky);
 				continue;
 			} else if (g_gametype->integer != GT_SINGLE_PLAYER && ent->s.parent < svs.iNumClients) {
@@ -793,9 +1148,8 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 			}
 		}
 
-		if (svEnt->snapshotCounter == sv.snapshotCounter) {
-			ent->s.renderfx &= ~(RF_WRAP_FRAMES | RF_SHADOW_PLANE);
-			ent->s.renderfx |= RF_WRAP_FRAMES;
+		if (SV_IsEntityInSnapshot(eNums, svEnt - sv.svEntities)) {
+			SV_SetSnapshotRenderfx(eNums, ent, (SV_GetSnapshotRenderfx(eNums, ent) & ~(RF_WRAP_FRAMES | RF_SHADOW_PLANE)) | RF_WRAP_FRAMES);
 			continue;
 		}
 
@@ -1032,29 +1386,32 @@ This properly handles multiple recursive portals, but the render
 currently doesn't.
 
 For viewing through other player's eyes, clent can be something other than client->gentity
+
+Only changes the client, so it can run from jobs.
+The snapshot must be committed with SV_CommitClientSnapshot
 =============
 */
-static void SV_BuildClientSnapshot( client_t *client ) {
+static void SV_BuildClientSnapshot( client_t *client, snapshotEntityNumbers_t *entityNumbers ) {
 	vec3_t						org;
 	vec3_t						ang;
 	clientSnapshot_t			*frame;
-	snapshotEntityNumbers_t		entityNumbers;
 	int							i;
 	gentity_t					*ent;
-	entityState_t				*state;
 	svEntity_t					*svEnt;
 	gentity_t					*clent;
 	int							clientNum;
 	playerState_t				*ps;
 
-	// bump the counter used to prevent double adding
-	sv.snapshotCounter++;
-
 	// this is the frame we are creating
 	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 
 	// clear everything in this snapshot
-	entityNumbers.numSnapshotEntities = 0;
+	entityNumbers->numSnapshotEntities = 0;
+	entityNumbers->numRenderfx = 0;
+	entityNumbers->built = qfalse;
+	entityNumbers->errorCode = 0;
+	Com_Memset( entityNumbers->addedEntities, 0, sizeof( entityNumbers->addedEntities ) );
+	Com_Memset( entityNumbers->renderfxEntities, 0, sizeof( entityNumbers->renderfxEntities ) );
 	Com_Memset( frame->areabits, 0, sizeof( frame->areabits ) );
 
   // https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=62
@@ -1076,7 +1433,8 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 	// be regenerated from the playerstate
 	clientNum = frame->ps.clientNum;
 	if ( clientNum < 0 || clientNum >= MAX_GENTITIES ) {
-		Com_Error( ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
+		SV_SnapshotError( entityNumbers, ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
+		return;
 	}
 	svEnt = &sv.svEntities[ clientNum ];
 	
@@ -1095,18 +1453,25 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 		VectorCopy(ps->viewangles, ang);
 	}
 
-	SV_AddEntToSnapshot(svEnt, SV_GentityNum(client - svs.clients), &entityNumbers, NULL, qfalse);
+	SV_AddEntToSnapshot(svEnt, SV_GentityNum(client - svs.clients), entityNumbers, NULL, qfalse);
 
 	// add all the entities directly visible to the eye, which
 	// may include portal entities that merge other viewpoints
-	SV_AddEntitiesVisibleFromPoint( org, frame, &entityNumbers, NULL, qfalse, client, ang );
+	SV_AddEntitiesVisibleFromPoint( org, frame, entityNumbers, NULL, qfalse, client, ang );
 
 	// if there were portals visible, there may be out of order entities
 	// in the list which will need to be resorted for the delta compression
 	// to work correctly.  This also catches the error condition
 	// of an entity being included twice.
-	qsort( entityNumbers.snapshotEntities, entityNumbers.numSnapshotEntities, 
-		sizeof( entityNumbers.snapshotEntities[0] ), SV_QsortEntityNumbers );
+	qsort( entityNumbers->snapshotEntities, entityNumbers->numSnapshotEntities, 
+		sizeof( entityNumbers->snapshotEntities[0] ), SV_QsortEntityNumbers );
+
+	for ( i = 1 ; i < entityNumbers->numSnapshotEntities ; i++ ) {
+		if ( entityNumbers->snapshotEntities[i] == entityNumbers->snapshotEntities[i - 1] ) {
+			SV_SnapshotError( entityNumbers, ERR_DROP, "SV_QsortEntityStates: duplicated entity" );
+			return;
+		}
+	}
 
 	// now that all viewpoint's areabits have been OR'd together, invert
 	// all of them to make it a mask vector, which is what the renderer wants
@@ -1114,29 +1479,175 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 		((int *)frame->areabits)[i] = ((int *)frame->areabits)[i] ^ -1;
 	}
 
-	
-	// copy the entity states out
-	frame->num_entities = 0;
-	frame->first_entity = svs.nextSnapshotEntities;
-	for ( i = 0 ; i < entityNumbers.numSnapshotEntities ; i++ ) {
-		ent = SV_GentityNum(entityNumbers.snapshotEntities[i]);
+	// the entity states are copied out by SV_WriteClientSnapshot,
+	// once the snapshot got its entities in SV_CommitClientSnapshot
+	for ( i = 0 ; i < entityNumbers->numSnapshotEntities ; i++ ) {
+		ent = SV_GentityNum(entityNumbers->snapshotEntities[i]);
 		if (ent->client && ent->s.number < svs.iNumClients) {
 			assert(ent->s.number < MAX_CLIENTS);
 			client->lastRadarTime[ent->s.number] = svs.time;
 		}
+	}
+	frame->num_entities = entityNumbers->numSnapshotEntities;
+	entityNumbers->built = qtrue;
+
+	SV_UpdateRadar(client);
+    frame->ps.radarInfo = client->radarInfo;
+}
+
+/*
+=============
+SV_MarkEntitiesSent
 
-		state = &svs.snapshotEntities[svs.nextSnapshotEntities % svs.numSnapshotEntities];
-		*state = ent->s;
-		svs.nextSnapshotEntities++;
+Flags all entities that are considered for snapshots.
+Called before building snapshots, on the main thread
+=============
+*/
+static void SV_MarkEntitiesSent( void ) {
+	gentity_t	*ent;
+	int			e;
+
+	// during an error shutdown message we may need to transmit
+	// the shutdown message after the server has shutdown
+	if ( !sv.state ) {
+		return;
+	}
+
+	for ( e = 0 ; e < sv.num_entities ; e++ ) {
+		ent = SV_GentityNum(e);
+
+		if (ent->inuse) {
+			ent->r.svFlags |= SVF_SENT;
+		}
+	}
+}
+
+/*
+=============
+SV_CommitClientSnapshot
+
+Applies the changes of a snapshot to the server, gives it entities
+from svs.snapshotEntities and chooses what it will be delta'ed from.
+Snapshots must be committed in the order of clients, on the main thread
+=============
+*/
+static void SV_CommitClientSnapshot( snapshotJob_t *job ) {
+	client_t				*client;
+	clientSnapshot_t		*frame;
+	snapshotEntityNumbers_t	*entityNumbers;
+	gentity_t				*ent;
+	int						i;
+
+	client = job->client;
+	entityNumbers = &job->entityNumbers;
+	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+
+	if ( entityNumbers->errorCode ) {
+		Com_Error( entityNumbers->errorCode, "%s", entityNumbers->errorMessage );
+	}
+
+	for ( i = 0 ; i < entityNumbers->numRenderfx ; i++ ) {
+		ent = SV_GentityNum(entityNumbers->renderfxNumbers[i]);
+		ent->s.renderfx = entityNumbers->renderfx[ent->s.number];
+	}
+
+	if ( entityNumbers->built ) {
+		for ( i = 0 ; i < entityNumbers->numSnapshotEntities ; i++ ) {
+			ent = SV_GentityNum(entityNumbers->snapshotEntities[i]);
+			ent->r.lastNetTime = svs.time - svs.startTime;
+		}
+
+		frame->first_entity = svs.nextSnapshotEntities;
 		// this should never hit, map should always be restarted first in SV_Frame
-		if ( svs.nextSnapshotEntities >= 0x7FFFFFFE ) {
+		if ( entityNumbers->numSnapshotEntities && svs.nextSnapshotEntities >= 0x7FFFFFFE - entityNumbers->numSnapshotEntities ) {
 			Com_Error(ERR_FATAL, "svs.nextSnapshotEntities wrapped");
 		}
-		frame->num_entities++;
+		svs.nextSnapshotEntities += entityNumbers->numSnapshotEntities;
 	}
 
-	SV_UpdateRadar(client);
-    frame->ps.radarInfo = client->radarInfo;
+	// bots need to have their snapshots build, but
+	// the query them directly without needing to be sent
+	job->send = !client->gentity || !(client->gentity->r.svFlags & SVF_MONSTER);
+	if ( !job->send ) {
+		return;
+	}
+
+	job->writeSnapshot = g_gametype->integer <= GT_SINGLE_PLAYER || client->serverIdAcknowledge == sv.serverId || client->serverIdAcknowledge == sv.restartedServerId;
+	if ( job->writeSnapshot ) {
+		job->oldframe = SV_SelectDeltaFrame( client, &job->lastframe );
+
+		if ( frame->areabytes > 255 ) {
+			Com_DPrintf( "WARNING: area bytes exceeds 255!  Bad!  Bad!" ); // 2015 actually had humour
+		}
+	}
+
+	MSG_Init(&job->msg, job->msgBuffer, sizeof(job->msgBuffer));
+	job->msg.allowoverflow = qtrue;
+}
+
+/*
+=============
+SV_WriteClientSnapshot
+
+Copies the entity states of a committed snapshot and writes the message.
+Only changes the client and its own entities in svs.snapshotEntities,
+so it can run from jobs
+=============
+*/
+static void SV_WriteClientSnapshot( snapshotJob_t *job ) {
+	client_t				*client;
+	clientSnapshot_t		*frame;
+	snapshotEntityNumbers_t	*entityNumbers;
+	entityState_t			*state;
+	gentity_t				*ent;
+	int						i;
+
+	client = job->client;
+	entityNumbers = &job->entityNumbers;
+	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+
+	// copy the entity states out
+	if ( entityNumbers->built ) {
+		for ( i = 0 ; i < entityNumbers->numSnapshotEntities ; i++ ) {
+			ent = SV_GentityNum(entityNumbers->snapshotEntities[i]);
+
+			state = &svs.snapshotEntities[(frame->first_entity + i) % svs.numSnapshotEntities];
+			*state = ent->s;
+			// the entity holds the renderfx of the last committed snapshot
+			state->renderfx = entityNumbers->renderfx[ent->s.number];
+		}
+	}
+
+	if ( !job->send ) {
+		return;
+	}
+
+    // NOTE, MRE: all server->client messages now acknowledge
+    // let the client know which reliable clientCommands we have received
+    MSG_WriteLong(&job->msg, client->lastClientCommand);
+
+	if (job->writeSnapshot) {
+		// (re)send any reliable server commands
+		SV_UpdateServerCommandsToClient( client, &job->msg );
+
+		// send over all the relevant entityState_t
+		// and the playerState_t
+		SV_WriteSnapshotToClient( client, &job->msg, job->oldframe, job->lastframe );
+
+		// clear the sounds on the client, preventing them to be sent each at packet
+		SV_ClearSounds( client );
+
+		// clear center print, preventing it to be sent at each packet
+		client->stringToPrint[ 0 ] = 0;
+
+		// su44: write any pending MoHAA cg messages
+		SV_WriteCGMToClient( client, &job->msg );
+	} else {
+		// Fixed in 2.0
+		//  Don't send snapshots until the player has acknowledged the server id (which happens when the client enters the world).
+		//  This also prevent sending CG messages while the client connects, as the cgame module is loaded when parsing the gamestate
+		MSG_WriteSVC(&job->msg, svc_nop);
+	}
 }
 
 #ifdef USE_VOIP
@@ -1205,6 +1716,60 @@ void SV_SendMessageToClient(msg_t *msg, client_t *client)
 }
 
 
+/*
+=======================
+SV_TransmitClientSnapshot
+
+Sends a written snapshot, on the main thread
+=======================
+*/
+static void SV_TransmitClientSnapshot( snapshotJob_t *job ) {
+	client_t	*client;
+
+	if ( !job->send ) {
+		return;
+	}
+
+	client = job->client;
+
+#ifdef USE_VOIP
+	if ( job->writeSnapshot ) {
+		SV_WriteVoipToClient(client, &job->msg);
+	}
+#endif
+
+	// check for overflow
+	if ( job->msg.overflowed ) {
+		Com_Printf ("WARNING: msg overflowed for %s\n", client->name);
+		MSG_Clear (&job->msg);
+	}
+
+	SV_SendMessageToClient( &job->msg, client );
+}
+
+/*
+=======================
+SV_SendClientSnapshotNoBuild
+
+Same as SV_SendClientSnapshot, without calling SV_PrepareSnapshots
+=======================
+*/
+static void SV_SendClientSnapshotNoBuild( client_t *client ) {
+	snapshotJob_t	*job;
+
+	job = &svSnapshotJobs[client - svs.clients];
+	job->client = client;
+
+	if ( client->gentity && client->state != CS_ZOMBIE ) {
+		SV_MarkEntitiesSent();
+	}
+
+	SV_BuildClientSnapshot( client, &job->entityNumbers );
+	SV_CommitClientSnapshot( job );
+	SV_WriteClientSnapshot( job );
+	SV_TransmitClientSnapshot( job );
+}
+
 /*
 =======================
 SV_SendClientSnapshot
@@ -1214,59 +1779,105 @@ Also called by SV_FinalMessage
 =======================
 */
 void SV_SendClientSnapshot( client_t *client ) {
-	byte		msg_buf[MAX_MSGLEN];
-	msg_t		msg;
+	SV_PrepareSnapshots();
+	SV_SendClientSnapshotNoBuild( client );
+}
 
-	// build the snapshot
-	SV_BuildClientSnapshot( client );
+/*
+=======================
+SV_BuildClientSnapshotJob
+=======================
+*/
+static void SV_BuildClientSnapshotJob( void *data, int index ) {
+	snapshotJob_t *job = ((snapshotJob_t **)data)[index];
 
-	// bots need to have their snapshots build, but
-	// the query them directly without needing to be sent
-	if ( client->gentity && client->gentity->r.svFlags & SVF_MONSTER ) {
+	SV_BuildClientSnapshot( job->client, &job->entityNumbers );
+}
+
+/*
+=======================
+SV_WriteClientSnapshotJob
+=======================
+*/
+static void SV_WriteClientSnapshotJob( void *data, int index ) {
+	SV_WriteClientSnapshot( ((snapshotJob_t **)data)[index] );
+}
+
+/*
+=======================
+SV_SendClientSnapshots
+
+Same as calling SV_SendClientSnapshot for each client, but the snapshots
+are built and written by sv_snapshotThreads threads.
+Only the steps that change the server run on the main thread, in the order of clients,
+so messages are the same as when they are sent one after the other
+=======================
+*/
+static void SV_SendClientSnapshots( client_t **clients, int numClients ) {
+	snapshotJob_t	*jobs[MAX_CLIENTS];
+	int				firstSnapshotEntity;
+	int				numThreads;
+	qboolean		markSent;
+	int				i;
+
+	if ( !numClients ) {
 		return;
 	}
 
-    MSG_Init(&msg, msg_buf, sizeof(msg_buf));
-    msg.allowoverflow = qtrue;
+	SV_PrepareSnapshots();
 
-    // NOTE, MRE: all server->client messages now acknowledge
-    // let the client know which reliable clientCommands we have received
-    MSG_WriteLong(&msg, client->lastClientCommand);
+	numThreads = sv_snapshotThreads->integer;
+	if ( numThreads <= 1 || numClients <= 1 ) {
+		for ( i = 0 ; i < numClients ; i++ ) {
+			SV_SendClientSnapshotNoBuild( clients[i] );
+		}
+		return;
+	}
 
-	if (g_gametype->integer <= GT_SINGLE_PLAYER || client->serverIdAcknowledge == sv.serverId || client->serverIdAcknowledge == sv.restartedServerId) {
-		// (re)send any reliable server commands
-		SV_UpdateServerCommandsToClient( client, &msg );
+	markSent = qfalse;
+	for ( i = 0 ; i < numClients ; i++ ) {
+		jobs[i] = &svSnapshotJobs[clients[i] - svs.clients];
+		jobs[i]->client = clients[i];
 
-		// send over all the relevant entityState_t
-		// and the playerState_t
-		SV_WriteSnapshotToClient( client, &msg );
+		if ( clients[i]->gentity && clients[i]->state != CS_ZOMBIE ) {
+			// all clients mark the same entities
+			markSent = qtrue;
+		}
+	}
 
-		// clear the sounds on the client, preventing them to be sent each at packet
-		SV_ClearSounds( client );
+	if ( markSent ) {
+		SV_MarkEntitiesSent();
+	}
 
-		// clear center print, preventing it to be sent at each packet
-		client->stringToPrint[ 0 ] = 0;
+	Com_RunJobs( SV_BuildClientSnapshotJob, jobs, numClients, numThreads );
 
-		// su44: write any pending MoHAA cg messages
-		SV_WriteCGMToClient( client, &msg );
+	firstSnapshotEntity = svs.nextSnapshotEntities;
+	for ( i = 0 ; i < numClients ; i++ ) {
+		SV_CommitClientSnapshot( jobs[i] );
+	}
 
-#ifdef USE_VOIP
-		SV_WriteVoipToClient(client, &msg);
-#endif
+	//
+	// when sent one after the other, a snapshot is written before the next ones
+	// take their entities from svs.snapshotEntities. If the next ones would
+	// overwrite the entities it's delta'ed from, it must be written in order
+	//
+	if ( svs.nextSnapshotEntities - firstSnapshotEntity > svs.numSnapshotEntities ) {
+		numThreads = 1;
 	} else {
-		// Fixed in 2.0
-		//  Don't send snapshots until the player has acknowledged the server id (which happens when the client enters the world).
-		//  This also prevent sending CG messages while the client connects, as the cgame module is loaded when parsing the gamestate
-		MSG_WriteSVC(&msg, svc_nop);
+		for ( i = 0 ; i < numClients ; i++ ) {
+			if ( jobs[i]->send && jobs[i]->writeSnapshot && jobs[i]->oldframe
+				&& jobs[i]->oldframe->first_entity < svs.nextSnapshotEntities - svs.numSnapshotEntities ) {
+				numThreads = 1;
+				break;
+			}
+		}
 	}
 
-	// check for overflow
-	if ( msg.overflowed ) {
-		Com_Printf ("WARNING: msg overflowed for %s\n", client->name);
-		MSG_Clear (&msg);
-	}
+	Com_RunJobs( SV_WriteClientSnapshotJob, jobs, numClients, numThreads );
 
-	SV_SendMessageToClient( &msg, client );
+	for ( i = 0 ; i < numClients ; i++ ) {
+		SV_TransmitClientSnapshot( jobs[i] );
+	}
 }
 
 /*
@@ -1279,6 +1890,14 @@ void SV_SendClientMessages(void)
 	int				i;
 	int				rate;
 	client_t		*c;
+	client_t		*snapshotClients[MAX_CLIENTS];
+	int				numSnapshotClients;
+
+	numSnapshotClients = 0;
+
+	// Added in OPM
+	//  entity states changed since the last frame
+	MSG_ClearDeltaCache();
 
 	// send a message to each connected client
 	for(i=0; i < sv_maxclients->integer; i++)
@@ -1317,11 +1936,18 @@ void SV_SendClientMessages(void)
 			}
 		}
 
-		// generate and send a new message
-		SV_SendClientSnapshot(c);
+		snapshotClients[numSnapshotClients++] = c;
+    }
+
+	// generate and send a new message
+	SV_SendClientSnapshots(snapshotClients, numSnapshotClients);
+
+	for(i=0; i < numSnapshotClients; i++)
+	{
+		c = snapshotClients[i];
 		c->lastSnapshotTime = svs.time;
 		c->rateDelayed = qfalse;
-    }
+	}
 }
 
 qboolean SV_IsValidSnapshotClient(client_t* client) {
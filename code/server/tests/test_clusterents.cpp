@@ -0,0 +1,280 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../sv_clusterents.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static const int NUM_CLUSTERS = 512;
+static const int NUM_ENTITIES = 1000;
+static const int NUM_CLIENTS  = 64;
+static const int NUM_FRAMES   = 200;
+// entities can be in up to 16 clusters, but most are in a few
+static const int MAX_CLUSTERS_PER_ENTITY = 16;
+
+static const int PVS_BYTES = (NUM_CLUSTERS + 7) / 8;
+
+static clusterEntities_t clusterEntities;
+static byte              pvs[NUM_CLUSTERS][PVS_BYTES];
+static int               entityClusters[NUM_ENTITIES][MAX_CLUSTERS_PER_ENTITY];
+static int               entityNumClusters[NUM_ENTITIES];
+static bool              entityAlways[NUM_ENTITIES];
+static int               clientClusters[NUM_CLIENTS];
+
+extern "C" {
+void *Z_Malloc(int size)
+{
+    return calloc(1, size);
+}
+
+void *Z_MallocDebug(int size, const char *label, const char *file, int line)
+{
+    return calloc(1, size);
+}
+
+void Z_Free(void *ptr)
+{
+    free(ptr);
+}
+}
+
+static void random_pvs()
+{
+    int i, j;
+
+    memset(pvs, 0, sizeof(pvs));
+
+    for (i = 0; i < NUM_CLUSTERS; i++) {
+        // clusters see themselves and the clusters around them
+        for (j = i - 12; j <= i + 12; j++) {
+            if (j >= 0 && j < NUM_CLUSTERS) {
+                pvs[i][j >> 3] |= 1 << (j & 7);
+            }
+        }
+
+        // and a few clusters that are far away
+        for (j = 0; j < 8; j++) {
+            int cluster = rand() % NUM_CLUSTERS;
+            pvs[i][cluster >> 3] |= 1 << (cluster & 7);
+        }
+    }
+}
+
+static void random_entity(int entnum)
+{
+    int first;
+    int i;
+
+    entityAlways[entnum] = (rand() % 40) == 0;
+
+    first = rand() % NUM_CLUSTERS;
+    if (entnum % 100) {
+        entityNumClusters[entnum] = 1 + rand() % 3;
+    } else {
+        // a few big entities
+        entityNumClusters[entnum] = MAX_CLUSTERS_PER_ENTITY;
+    }
+
+    for (i = 0; i < entityNumClusters[entnum]; i++) {
+        // clusters can be repeated
+        entityClusters[entnum][i] = (first + rand() % 4) % NUM_CLUSTERS;
+    }
+}
+
+static void build_entities()
+{
+    int i;
+
+    SV_ClearClusterEntities(&clusterEntities, NUM_CLUSTERS);
+
+    for (i = 0; i < NUM_ENTITIES; i++) {
+        if (entityAlways[i]) {
+            SV_AddAlwaysCheckedEntity(&clusterEntities, i);
+        } else {
+            SV_AddClusterEntity(&clusterEntities, i, entityClusters[i], entityNumClusters[i]);
+        }
+    }
+
+    SV_SortClusterEntities(&clusterEntities);
+}
+
+static bool brute_force_visible(const byte *clientpvs, int entnum)
+{
+    int i;
+    int l;
+
+    if (entityAlways[entnum]) {
+        return true;
+    }
+
+    for (i = 0; i < entityNumClusters[entnum]; i++) {
+        l = entityClusters[entnum][i];
+        if (clientpvs[l >> 3] & (1 << (l & 7))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int brute_force(const byte *clientpvs)
+{
+    int count;
+    int i;
+
+    count = 0;
+    for (i = 0; i < NUM_ENTITIES; i++) {
+        if (brute_force_visible(clientpvs, i)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static int gather(const byte *clientpvs, unsigned int *bits)
+{
+    int count;
+    int e;
+
+    SV_GatherClusterEntities(&clusterEntities, clientpvs, bits);
+
+    count = 0;
+    for (e = SV_NextClusterEntity(bits, -1); e != -1; e = SV_NextClusterEntity(bits, e)) {
+        count++;
+    }
+
+    return count;
+}
+
+bool test_gather()
+{
+    unsigned int bits[CLUSTER_ENTITY_WORDS];
+    int          frame;
+    int          client;
+    int          previous;
+    int          e;
+    int          i;
+
+    srand(1);
+    random_pvs();
+
+    for (i = 0; i < NUM_ENTITIES; i++) {
+        random_entity(i);
+    }
+
+    for (frame = 0; frame < NUM_FRAMES; frame++) {
+        // move some entities
+        for (i = 0; i < NUM_ENTITIES / 10; i++) {
+            random_entity(rand() % NUM_ENTITIES);
+        }
+
+        build_entities();
+
+        for (client = 0; client < NUM_CLIENTS; client++) {
+            const byte *clientpvs = pvs[rand() % NUM_CLUSTERS];
+
+            SV_GatherClusterEntities(&clusterEntities, clientpvs, bits);
+
+            previous = -1;
+            for (e = SV_NextClusterEntity(bits, -1); e != -1; e = SV_NextClusterEntity(bits, e)) {
+                if (e <= previous || e >= NUM_ENTITIES || !brute_force_visible(clientpvs, e)) {
+                    std::cerr << "Frame " << frame << ": entity " << e << " shouldn't be returned" << std::endl;
+                    return false;
+                }
+
+                for (i = previous + 1; i < e; i++) {
+                    if (brute_force_visible(clientpvs, i)) {
+                        std::cerr << "Frame " << frame << ": entity " << i << " is missing" << std::endl;
+                        return false;
+                    }
+                }
+
+                previous = e;
+            }
+
+            for (i = previous + 1; i < NUM_ENTITIES; i++) {
+                if (brute_force_visible(clientpvs, i)) {
+                    std::cerr << "Frame " << frame << ": entity " << i << " is missing" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    std::cout << "Checked " << NUM_FRAMES * NUM_CLIENTS << " client frames" << std::endl;
+    return true;
+}
+
+void benchmark_gather()
+{
+    std::chrono::steady_clock::time_point start;
+    double                                clusterTime, bruteTime;
+    unsigned int                          bits[CLUSTER_ENTITY_WORDS];
+    int                                   total;
+    int                                   frame;
+    int                                   client;
+
+    for (client = 0; client < NUM_CLIENTS; client++) {
+        clientClusters[client] = rand() % NUM_CLUSTERS;
+    }
+
+    total = 0;
+    start = std::chrono::steady_clock::now();
+    for (frame = 0; frame < NUM_FRAMES; frame++) {
+        // the lists are rebuilt every frame
+        build_entities();
+
+        for (client = 0; client < NUM_CLIENTS; client++) {
+            total += gather(pvs[clientClusters[client]], bits);
+        }
+    }
+    clusterTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (frame = 0; frame < NUM_FRAMES; frame++) {
+        for (client = 0; client < NUM_CLIENTS; client++) {
+            total -= brute_force(pvs[clientClusters[client]]);
+        }
+    }
+    bruteTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Cluster lists: " << clusterTime / NUM_FRAMES << " us/frame, linear: " << bruteTime / NUM_FRAMES
+              << " us/frame (" << NUM_CLIENTS << " clients, " << NUM_ENTITIES << " entities, difference " << total
+              << ")" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_gather()) {
+        std::cerr << "Cluster entity lists failed!" << std::endl;
+        return 1;
+    }
+
+    benchmark_gather();
+    SV_FreeClusterEntities(&clusterEntities);
+
+    return 0;
+}